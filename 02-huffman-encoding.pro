@@ -1,32 +1,98 @@
 TEMPLATE = app
-CONFIG += console c++17
+CONFIG += console c++17 thread
 
 SOURCES += main.cpp \
     driver/driver.cpp \
+    driver/batch.cpp \
+    driver/piped.cpp \
+    driver/cat.cpp \
+    driver/archive.cpp \
     src/huffman_tree/hash_map/FrequencyHashMap.cpp \
+    src/huffman_tree/histogram/ByteHistogram.cpp \
+    src/huffman_tree/histogram/ContextHistogram.cpp \
+    src/huffman_tree/package_merge/PackageMerge.cpp \
     src/huffman_tree/priority_queue/PriorityQueue.cpp \
+    src/huffman_tree/tree_builder/TreeBuilder.cpp \
+    src/huffman_tree/tree_builder/TwoQueueBuilder.cpp \
+    src/huffman_tree/adaptive/AdaptiveHuffman.cpp \
+    src/huffman_tree/context_model/ContextModel.cpp \
+    src/huffman_tree/block_splitter/BlockSplitter.cpp \
+    src/huffman_tree/interleaved/InterleavedStreams.cpp \
+    src/huffman_tree/dictionary/Dictionary.cpp \
+    src/huffman_tree/dictionary/DictionaryCache.cpp \
+    src/huffman_tree/bit_stream/BitWriter.cpp \
+    src/huffman_tree/bit_stream/BitReader.cpp \
+    src/huffman_tree/decoding_table/DecodingTable.cpp \
     src/huffman_tree/HuffmanTree.cpp \
     src/utils/file/file_utils.cpp \
     src/utils/generate/generate_utils.cpp \
     src/utils/compression/compression_utils.cpp \
-    src/utils/instantiate/instantiate_utils.cpp
+    src/utils/instantiate/instantiate_utils.cpp \
+    src/utils/parallel/parallel_utils.cpp \
+    src/utils/memory/memory_utils.cpp \
+    src/utils/checksum/checksum_utils.cpp \
+    src/compression_session/CompressionSession.cpp \
+    src/input_source/InputSource.cpp \
+    src/archive/ArchiveWriter.cpp \
+    src/archive/ArchiveReader.cpp \
+    src/thread_pool/ThreadPool.cpp \
+    src/thread_pool/WorkStealingPool.cpp
 
 HEADERS += driver/driver.h \
+    driver/batch.h \
+    driver/piped.h \
+    driver/cat.h \
+    driver/archive.h \
     src/huffman_tree/hash_map/FrequencyHashNode.h \
     src/huffman_tree/hash_map/FrequencyHashMap.h \
+    src/huffman_tree/histogram/ByteHistogram.h \
+    src/huffman_tree/histogram/ContextHistogram.h \
+    src/huffman_tree/node_arena/NodeArena.h \
+    src/huffman_tree/package_merge/PackageMerge.h \
     src/huffman_tree/priority_queue/PriorityQueue.h \
+    src/huffman_tree/tree_builder/TreeBuilder.h \
+    src/huffman_tree/tree_builder/TwoQueueBuilder.h \
+    src/huffman_tree/adaptive/AdaptiveHuffman.h \
+    src/huffman_tree/context_model/ContextModel.h \
+    src/huffman_tree/block_splitter/BlockSplitter.h \
+    src/huffman_tree/interleaved/InterleavedStreams.h \
+    src/huffman_tree/dictionary/Dictionary.h \
+    src/huffman_tree/dictionary/DictionaryCache.h \
+    src/huffman_tree/bit_stream/PackedBits.h \
+    src/huffman_tree/bit_stream/BitWriter.h \
+    src/huffman_tree/bit_stream/BitReader.h \
+    src/huffman_tree/decoding_table/DecodingTable.h \
     src/huffman_tree/HuffmanNode.h \
     src/huffman_tree/HuffmanTree.h \
+    src/huffman_tree/components/BlockIndex.h \
+    src/huffman_tree/components/CompressionOptions.h \
+    src/huffman_tree/components/DecodedRange.h \
     src/huffman_tree/components/FileInformation.h \
+    src/huffman_tree/components/FrequencyChunk.h \
+    src/huffman_tree/components/HuffmanCodeword.h \
     src/huffman_tree/components/HuffmanHeader.h \
     src/utils/file/file_utils.h \
     src/utils/generate/generate_utils.h \
     src/utils/compression/compression_utils.h \
-    src/utils/instantiate/instantiate_utils.h
+    src/utils/instantiate/instantiate_utils.h \
+    src/utils/parallel/parallel_utils.h \
+    src/utils/memory/memory_utils.h \
+    src/utils/checksum/checksum_utils.h \
+    src/compression_session/CompressionSession.h \
+    src/compression_session/CompressionStats.h \
+    src/input_source/InputSource.h \
+    src/archive/ArchiveIndex.h \
+    src/archive/ArchiveWriter.h \
+    src/archive/ArchiveReader.h \
+    src/thread_pool/ThreadPool.h \
+    src/thread_pool/WorkStealingPool.h
 
 INCLUDEPATH += src \
     driver
 
+# peak memory use is read with GetProcessMemoryInfo on Windows
+win32: LIBS += -lpsapi
+
 # Unix/Linux build folders
 unix {
     CONFIG(debug, debug|release) {
@@ -0,0 +1,555 @@
+// Huffman Encoding Benchmark
+
+// The benchmark measures every stage of compressing and decompressing a file on its own, so that the effect of a
+// change to any one stage can be seen (and compared between builds) without the noise of the others:
+
+// [histogram] > [tree] > [table] > [encode] > [write] > [read] > [instantiate] > [decode]
+
+// histogram counts the frequencies with each ByteHistogram engine, tree builds the Huffman Tree with each TreeBuilder
+// engine, table generates the encoding table and reassigns it in canonical order, and encode generates the Huffman
+// Code from memory. write and read write the compressed file to a temporary file and read its sections back (through
+// an InputSource, as decompress does). instantiate rebuilds the encoding table from the code length table and the
+// Huffman Tree from the tree representation, and decode builds the DecodingTable and decodes the Huffman Code into
+// memory, several characters for every refill of the reader, while decode_character decodes the same Huffman Code
+// one checked character at a time, to be compared with decode. encode_interleaved and decode_interleaved do the same
+// with the Huffman Code split between BENCH_INTERLEAVED_STREAMS interleaved streams (see InterleavedStreams), to be
+// compared with encode and decode.
+
+// The two ways of generating the Huffman Code are also compared as a whole: two_pass_encode counts the frequencies,
+// builds the tree and the canonical encoding table, and encodes, while adaptive_encode and adaptive_decode encode and
+// decode in a single pass with an AdaptiveHuffman tree. The encode stages also give the ratio of the Huffman Code in
+// bits per byte of the input (the length of the table included for two_pass_encode). checksum and checksum_software
+// compute the CRC32C of the input which encode and decode add to every block, with the CRC instruction of the
+// processor (where it has one) and with the slicing-by-8 tables.
+
+// Every stage is measured on the files in the test folder and on synthetic inputs generated with a fixed seed (uniform
+// random bytes, a skewed distribution, text made of words, and a single repeated byte), or on the files given as
+// arguments. Each stage is run repeatedly: the number of iterations in a repetition is chosen so that a repetition
+// takes at least MIN_REPETITION_TIME, and the time of every repetition is kept. The results are given per byte of the
+// input, so that inputs of different sizes can be compared, as the mean ns/byte with its variance and standard
+// deviation across repetitions, the fastest repetition, and the MB/s of the mean.
+
+//     hzip_bench [--json] [--repetitions N] [--size MiB] [files...]
+
+// With --json, the results are printed as JSON instead of a table, to be saved and compared between builds. The
+// benchmark runs entirely in memory apart from the write and read stages, and needs nothing but the program's sources.
+
+// Before anything is measured, every input is checked with ByteHistogram::selfTest (from a temporary file), and the
+// benchmark exits with status 1 if any histogram engine disagrees with FrequencyHashMap, as its results would then
+// measure a wrong count.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "huffman_tree/adaptive/AdaptiveHuffman.h"
+#include "huffman_tree/bit_stream/BitReader.h"
+#include "huffman_tree/bit_stream/BitWriter.h"
+#include "huffman_tree/bit_stream/PackedBits.h"
+#include "huffman_tree/components/BlockIndex.h"
+#include "huffman_tree/components/FileInformation.h"
+#include "huffman_tree/components/HuffmanHeader.h"
+#include "huffman_tree/decoding_table/DecodingTable.h"
+#include "huffman_tree/histogram/ByteHistogram.h"
+#include "huffman_tree/interleaved/InterleavedStreams.h"
+#include "huffman_tree/tree_builder/TreeBuilder.h"
+#include "input_source/InputSource.h"
+#include "utils/checksum/checksum_utils.h"
+#include "utils/compression/compression_utils.h"
+#include "utils/generate/generate_utils.h"
+#include "utils/instantiate/instantiate_utils.h"
+
+#ifndef HZIP_TEST_DIRECTORY
+#define HZIP_TEST_DIRECTORY "test"
+#endif
+
+constexpr std::chrono::nanoseconds MIN_REPETITION_TIME{std::chrono::milliseconds{20}};
+constexpr uint64_t SYNTHETIC_SEED{0x48555a4950}; // fixed, so every build measures the same inputs
+constexpr unsigned BENCH_INTERLEAVED_STREAMS{4}; // the same as the program's default
+
+class BenchInput {
+public:
+    // public data members
+    std::string name{};
+    std::vector<uint8_t> bytes{};
+};
+
+class BenchResult {
+public:
+    // public data members
+    std::string input{};
+    std::string stage{};
+    uint64_t bytes{0};
+    unsigned iterations{0}; // per repetition
+    std::vector<double> nanosecondsPerByte{}; // one per repetition
+    uint64_t outputBits{0}; // bits produced by an encode stage, 0 for the other stages
+
+    [[nodiscard]] double mean() const;
+    [[nodiscard]] double variance() const;
+    [[nodiscard]] double fastest() const;
+    [[nodiscard]] double megabytesPerSecond() const { return mean() > 0 ? 1e3 / mean() : 0; }
+    [[nodiscard]] double bitsPerByte() const { return bytes > 0 ? static_cast<double>(outputBits) / bytes : 0; }
+};
+
+double BenchResult::mean() const {
+    double sum{0};
+    for (double value : nanosecondsPerByte) {
+        sum += value;
+    }
+    return sum / static_cast<double>(nanosecondsPerByte.size());
+}
+
+double BenchResult::variance() const {
+    // sample variance, as the repetitions are a sample of every possible run
+    if (nanosecondsPerByte.size() < 2) {
+        return 0;
+    }
+
+    double average{mean()};
+    double sum{0};
+    for (double value : nanosecondsPerByte) {
+        sum += (value - average) * (value - average);
+    }
+    return sum / static_cast<double>(nanosecondsPerByte.size() - 1);
+}
+
+double BenchResult::fastest() const {
+    return *std::min_element(nanosecondsPerByte.begin(), nanosecondsPerByte.end());
+}
+
+// measurement
+
+BenchResult measure(const BenchInput& input, const std::string& stage, unsigned repetitions,
+                    const std::function<void()>& operation) {
+    using Clock = std::chrono::steady_clock;
+
+    BenchResult result{};
+    result.input = input.name;
+    result.stage = stage;
+    result.bytes = input.bytes.size();
+
+    // the first run warms the caches and determines how many iterations fill a repetition
+    auto start{Clock::now()};
+    operation();
+    auto once{std::max(Clock::now() - start, Clock::duration{1})};
+    result.iterations = static_cast<unsigned>(std::clamp<int64_t>(MIN_REPETITION_TIME / once + 1, 1, 1 << 20));
+
+    double bytes{static_cast<double>(std::max<uint64_t>(result.bytes, 1))};
+    for (unsigned repetition{0}; repetition < repetitions; ++repetition) {
+        start = Clock::now();
+        for (unsigned iteration{0}; iteration < result.iterations; ++iteration) {
+            operation();
+        }
+        std::chrono::duration<double, std::nano> elapsed{Clock::now() - start};
+        result.nanosecondsPerByte.push_back(elapsed.count() / result.iterations / bytes);
+    }
+
+    return result;
+}
+
+void benchInput(const BenchInput& input, unsigned repetitions, std::vector<BenchResult>& results) {
+    const uint8_t* data{input.bytes.data()};
+    std::size_t size{input.bytes.size()};
+
+    // histogram
+    ByteHistogram histogram{};
+    for (HistogramEngine engine : {HistogramEngine::SIMPLE, HistogramEngine::INTERLEAVED}) {
+        histogram = ByteHistogram{engine};
+        results.push_back(measure(input, engine == HistogramEngine::SIMPLE ? "histogram_simple"
+                                                                           : "histogram_interleaved",
+                                  repetitions, [&] {
+            histogram.clear();
+            histogram.count(data, size);
+        }));
+    }
+
+    // tree
+    HuffmanNodeArena nodes{};
+    uint16_t root{NO_NODE};
+    for (TreeBuilderEngine engine : {TreeBuilderEngine::HEAP, TreeBuilderEngine::TWO_QUEUE}) {
+        results.push_back(measure(input, engine == TreeBuilderEngine::HEAP ? "tree_heap" : "tree_two_queue",
+                                  repetitions, [&] {
+            nodes.clear();
+            root = TreeBuilder::build(engine, histogram, nodes);
+        }));
+    }
+
+    // table
+    EncodingTable encodingTable{};
+    results.push_back(measure(input, "table", repetitions, [&] {
+        encodingTable.fill(HuffmanCodeword{});
+        generateEncodingTable(encodingTable, nodes, root);
+        generateCanonicalEncodingTable(encodingTable);
+    }));
+
+    // encode
+    PackedBits encoding{};
+    results.push_back(measure(input, "encode", repetitions, [&] {
+        encoding.clear();
+        BitWriter writer{encoding};
+        generateHuffmanCodeBlock(data, size, encodingTable, writer);
+        writer.flush();
+    }));
+    results.back().outputBits = encoding.bitLength;
+
+    // write
+    FileInformation information{"hzip_bench", ".bin"};
+    PackedBits informationCode{};
+    PackedBits lengthTable{};
+    generateFileInfoCode(information, informationCode);
+    generateCodeLengthTable(lengthTable, encodingTable);
+    HuffmanHeader header{0, 0, 0};
+    generateHuffmanHeader(header, HuffmanHeader::CANONICAL, size, informationCode.bitLength, lengthTable.bitLength,
+                          encoding.bitLength);
+    std::string path{(std::filesystem::temp_directory_path() / "hzip_bench.hzip").string()};
+    BlockIndex blockIndex{};
+    results.push_back(measure(input, "write", repetitions, [&] {
+        std::ofstream output{path, std::ios::out | std::ios::binary}; // write in binary mode
+        writeCompressedFile(output, header, informationCode, lengthTable, encoding, 0, blockIndex);
+    }));
+
+    // read
+    PackedBits readInformation{};
+    PackedBits readTable{};
+    PackedBits readEncoding{};
+    uint64_t encodingBitLength{0};
+    results.push_back(measure(input, "read", repetitions, [&] {
+        InputSource source{path};
+        HuffmanHeader readHeader{0, 0, 0};
+        uint64_t encodingPosition{0};
+        readCompressedFile(source, readHeader, readInformation, readTable, encodingPosition);
+        readSection(source, encodingPosition, readEncoding, readHeader.encodingLength);
+        encodingBitLength = readHeader.encodingLength;
+    }));
+    std::filesystem::remove(path);
+
+    // instantiate
+    results.push_back(measure(input, "instantiate_canonical", repetitions, [&] {
+        BitReader reader{lengthTable};
+        instantiateCanonicalEncodingTable(encodingTable, reader);
+    }));
+    PackedBits representation{};
+    generateHuffmanTreeRepresentation(representation, nodes, root);
+    results.push_back(measure(input, "instantiate_tree", repetitions, [&] {
+        BitReader reader{representation};
+        nodes.clear();
+        root = instantiateHuffmanTree(reader, nodes);
+    }));
+
+    // decode
+    std::vector<uint8_t> output(size);
+    bool corrupted{false};
+    results.push_back(measure(input, "decode", repetitions, [&] {
+        DecodingTable decodingTable{encodingTable};
+        BitReader reader{readEncoding};
+        std::size_t count{0};
+        while (count < size && !corrupted) {
+            count += decodingTable.decode(reader, encodingBitLength, output.data() + count, size - count, corrupted);
+        }
+    }));
+    if (corrupted || output != input.bytes) {
+        std::cout << "Error: " << input.name << " did not decode to the original input.\n";
+    }
+
+    corrupted = false;
+    results.push_back(measure(input, "decode_character", repetitions, [&] {
+        DecodingTable decodingTable{encodingTable};
+        BitReader reader{readEncoding};
+        for (std::size_t count{0}; count < size && !corrupted; ++count) {
+            corrupted = !decodingTable.decodeCharacter(reader, output[count]);
+        }
+    }));
+    if (corrupted || output != input.bytes) {
+        std::cout << "Error: " << input.name << " did not decode to the original input one character at a time.\n";
+    }
+
+    // interleaved streams
+    PackedBits interleavedEncoding{};
+    results.push_back(measure(input, "encode_interleaved", repetitions, [&] {
+        interleavedEncoding.clear();
+        BitWriter writer{interleavedEncoding};
+        InterleavedStreams interleavedStreams{encodingTable, BENCH_INTERLEAVED_STREAMS};
+        for (std::size_t position{0}; position < size; position += InterleavedStreams::BLOCK_SIZE) {
+            interleavedStreams.encode(data + position, std::min(InterleavedStreams::BLOCK_SIZE, size - position),
+                                      writer);
+        }
+        writer.flush();
+    }));
+    results.back().outputBits = interleavedEncoding.bitLength;
+
+    corrupted = false;
+    results.push_back(measure(input, "decode_interleaved", repetitions, [&] {
+        DecodingTable decodingTable{encodingTable};
+        InterleavedStreams interleavedStreams{decodingTable};
+        BitReader reader{interleavedEncoding};
+        std::size_t count{0};
+        while (count < size && !corrupted) {
+            count += interleavedStreams.decode(reader, interleavedEncoding.bitLength, output.data() + count,
+                                               size - count, corrupted);
+        }
+    }));
+    if (corrupted || output != input.bytes) {
+        std::cout << "Error: " << input.name << " did not decode to the original input with interleaved streams.\n";
+    }
+
+    // two-pass against adaptive
+    ByteHistogram twoPassHistogram{};
+    HuffmanNodeArena twoPassNodes{};
+    EncodingTable twoPassTable{};
+    PackedBits twoPassEncoding{};
+    PackedBits twoPassLengthTable{};
+    results.push_back(measure(input, "two_pass_encode", repetitions, [&] {
+        twoPassHistogram.clear();
+        twoPassHistogram.count(data, size);
+        twoPassNodes.clear();
+        uint16_t twoPassRoot{TreeBuilder::build(TreeBuilderEngine::TWO_QUEUE, twoPassHistogram, twoPassNodes)};
+        twoPassTable.fill(HuffmanCodeword{});
+        generateEncodingTable(twoPassTable, twoPassNodes, twoPassRoot);
+        generateCanonicalEncodingTable(twoPassTable);
+        generateCodeLengthTable(twoPassLengthTable, twoPassTable);
+        twoPassEncoding.clear();
+        BitWriter writer{twoPassEncoding};
+        generateHuffmanCodeBlock(data, size, twoPassTable, writer);
+        writer.flush();
+    }));
+    results.back().outputBits = twoPassLengthTable.bitLength + twoPassEncoding.bitLength;
+
+    AdaptiveHuffman adaptiveHuffman{};
+    PackedBits adaptiveEncoding{};
+    results.push_back(measure(input, "adaptive_encode", repetitions, [&] {
+        adaptiveHuffman.reset();
+        adaptiveEncoding.clear();
+        BitWriter writer{adaptiveEncoding};
+        adaptiveHuffman.encode(data, size, writer);
+        writer.flush();
+    }));
+    results.back().outputBits = adaptiveEncoding.bitLength;
+
+    corrupted = false;
+    results.push_back(measure(input, "adaptive_decode", repetitions, [&] {
+        adaptiveHuffman.reset();
+        BitReader reader{adaptiveEncoding};
+        std::size_t count{0};
+        while (count < size && !corrupted) {
+            count += adaptiveHuffman.decode(reader, adaptiveEncoding.bitLength, output.data() + count, size - count,
+                                            corrupted);
+        }
+    }));
+    if (corrupted || output != input.bytes) {
+        std::cout << "Error: " << input.name << " did not decode to the original input with adaptive codes.\n";
+    }
+
+    // checksum
+    uint32_t checksum{0};
+    results.push_back(measure(input, "checksum", repetitions, [&] {
+        checksum = updateCrc32c(0, data, size);
+    }));
+    uint32_t softwareChecksum{0};
+    results.push_back(measure(input, "checksum_software", repetitions, [&] {
+        softwareChecksum = updateCrc32cSoftware(0, data, size);
+    }));
+    if (checksum != softwareChecksum) {
+        std::cout << "Error: " << input.name << " has a different checksum without the CRC instruction.\n";
+    }
+}
+
+// inputs
+
+bool loadFile(const std::string& path, BenchInput& input) {
+    InputSource source{path};
+    if (!source.isOpen()) {
+        std::cout << "Error: Failed to read " << path << ".\n";
+        return false;
+    }
+
+    input.name = std::filesystem::path{path}.filename().string();
+    std::vector<uint8_t> buffer{};
+    const uint8_t* data{nullptr};
+    uint64_t position{0};
+    while (std::size_t count{source.view(position, 1 << 20, data, buffer)}) {
+        input.bytes.insert(input.bytes.end(), data, data + count);
+        position += count;
+    }
+    return true;
+}
+
+bool selfTestInput(const BenchInput& input) {
+    // selfTest reads a file, so the input is written to one first
+    std::string path{(std::filesystem::temp_directory_path() / "hzip_bench_self_test.bin").string()};
+    {
+        std::ofstream output{path, std::ios::out | std::ios::binary};
+        output.write(reinterpret_cast<const char*>(input.bytes.data()),
+                     static_cast<std::streamsize>(input.bytes.size()));
+    }
+
+    bool agreed{ByteHistogram::selfTest(path)};
+    std::filesystem::remove(path);
+    if (!agreed) {
+        std::cout << "Error: The histogram engines disagree with FrequencyHashMap on " << input.name << ".\n";
+    }
+    return agreed;
+}
+
+std::vector<BenchInput> generateSyntheticInputs(std::size_t size) {
+    std::mt19937_64 generator{SYNTHETIC_SEED};
+    std::vector<BenchInput> inputs(4);
+
+    // every byte equally likely, which Huffman Coding cannot compress
+    inputs[0].name = "synthetic-uniform";
+    std::uniform_int_distribution<int> uniform{0, 255};
+    for (std::size_t i{0}; i < size; ++i) {
+        inputs[0].bytes.push_back(static_cast<uint8_t>(uniform(generator)));
+    }
+
+    // a few bytes are very common and the rest rare, which produces long codes
+    inputs[1].name = "synthetic-skewed";
+    std::geometric_distribution<int> geometric{0.2};
+    for (std::size_t i{0}; i < size; ++i) {
+        inputs[1].bytes.push_back(static_cast<uint8_t>(std::min(geometric(generator), 255)));
+    }
+
+    // words of lowercase letters separated by spaces and the occasional line break
+    inputs[2].name = "synthetic-text";
+    // (letters repeated roughly in proportion to how often they appear in English)
+    const std::string letters{"eeeeeeeeeeeetttttttttaaaaaaaaooooooooiiiiiiinnnnnnnsssssshhhhhhrrrrrrddddllllcccuum"
+                              "mwwffggyyppbbvkjxqz"};
+    std::uniform_int_distribution<std::size_t> letter{0, letters.size() - 1};
+    std::uniform_int_distribution<int> wordLength{1, 9};
+    while (inputs[2].bytes.size() < size) {
+        for (int i{wordLength(generator)}; i > 0; --i) {
+            inputs[2].bytes.push_back(static_cast<uint8_t>(letters[letter(generator)]));
+        }
+        inputs[2].bytes.push_back(uniform(generator) < 16 ? '\n' : ' ');
+    }
+    inputs[2].bytes.resize(size);
+
+    // a single character, which has a code of 1 bit
+    inputs[3].name = "synthetic-run";
+    inputs[3].bytes.assign(size, 'a');
+
+    return inputs;
+}
+
+// output
+
+std::string escapeJson(const std::string& text) {
+    std::string escaped{};
+    for (char character : text) {
+        if (character == '"' || character == '\\') {
+            escaped += '\\';
+        }
+        escaped += character;
+    }
+    return escaped;
+}
+
+void printTable(const std::vector<BenchResult>& results) {
+    std::cout << std::left << std::setw(24) << "[Input]" << std::setw(24) << "[Stage]" << std::right
+        << std::setw(12) << "[ns/byte]" << std::setw(12) << "[stddev]" << std::setw(12) << "[fastest]"
+        << std::setw(12) << "[MB/s]" << std::setw(12) << "[bits/byte]" << '\n';
+
+    for (const BenchResult& result : results) {
+        std::cout << std::left << std::setw(24) << result.input << std::setw(24) << result.stage << std::right
+            << std::fixed << std::setprecision(4) << std::setw(12) << result.mean()
+            << std::setw(12) << std::sqrt(result.variance()) << std::setw(12) << result.fastest()
+            << std::setprecision(1) << std::setw(12) << result.megabytesPerSecond();
+        if (result.outputBits != 0) {
+            std::cout << std::setprecision(3) << std::setw(12) << result.bitsPerByte();
+        }
+        std::cout << '\n';
+    }
+}
+
+void printJson(const std::vector<BenchResult>& results) {
+#if defined(__OPTIMIZE__) || defined(NDEBUG)
+    bool optimized{true};
+#else
+    bool optimized{false};
+#endif
+
+    std::cout << "{\n  \"optimized\": " << (optimized ? "true" : "false") << ",\n  \"results\": [\n";
+    for (std::size_t i{0}; i < results.size(); ++i) {
+        const BenchResult& result{results[i]};
+        std::cout << std::setprecision(6) << "    {\"input\": \"" << escapeJson(result.input) << "\", \"stage\": \""
+            << result.stage << "\", \"bytes\": " << result.bytes << ", \"repetitions\": "
+            << result.nanosecondsPerByte.size() << ", \"iterations\": " << result.iterations
+            << ", \"ns_per_byte\": " << result.mean() << ", \"variance\": " << result.variance()
+            << ", \"stddev\": " << std::sqrt(result.variance()) << ", \"fastest_ns_per_byte\": " << result.fastest()
+            << ", \"mb_per_s\": " << result.megabytesPerSecond();
+        if (result.outputBits != 0) {
+            std::cout << ", \"bits_per_byte\": " << result.bitsPerByte();
+        }
+        std::cout << "}" << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    std::cout << "  ]\n}\n";
+}
+
+int main(int argc, char* argv[]) {
+    bool json{false};
+    unsigned repetitions{10};
+    std::size_t syntheticSize{4 << 20};
+    std::vector<std::string> paths{};
+    for (int i{1}; i < argc; ++i) {
+        std::string argument{argv[i]};
+        if (argument == "--json") {
+            json = true;
+        } else if (argument == "--repetitions" && i + 1 < argc) {
+            repetitions = std::max(1, std::atoi(argv[++i]));
+        } else if (argument == "--size" && i + 1 < argc) {
+            syntheticSize = static_cast<std::size_t>(std::max(1, std::atoi(argv[++i]))) << 20;
+        } else if (argument.rfind("--", 0) == 0) {
+            std::cout << "Usage: " << argv[0] << " [--json] [--repetitions N] [--size MiB] [files...]\n";
+            return 2;
+        } else {
+            paths.push_back(argument);
+        }
+    }
+
+    // the given files, or otherwise the test files and the synthetic inputs
+    std::vector<BenchInput> inputs{};
+    if (paths.empty()) {
+        std::error_code error{};
+        for (const auto& entry : std::filesystem::recursive_directory_iterator{HZIP_TEST_DIRECTORY, error}) {
+            if (entry.is_regular_file()) {
+                paths.push_back(entry.path().string());
+            }
+        }
+        std::sort(paths.begin(), paths.end());
+        inputs = generateSyntheticInputs(syntheticSize);
+    }
+    for (const std::string& path : paths) {
+        BenchInput input{};
+        if (!loadFile(path, input)) {
+            return 1;
+        }
+        inputs.push_back(std::move(input));
+    }
+
+    for (const BenchInput& input : inputs) {
+        if (!selfTestInput(input)) {
+            return 1;
+        }
+    }
+
+    std::vector<BenchResult> results{};
+    for (const BenchInput& input : inputs) {
+        benchInput(input, repetitions, results);
+    }
+
+    if (json) {
+        printJson(results);
+    } else {
+        printTable(results);
+    }
+    return 0;
+}
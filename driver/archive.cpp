@@ -0,0 +1,187 @@
+// Archive Program Implementation
+
+#include "archive.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <set>
+
+#include "archive/ArchiveReader.h"
+#include "archive/ArchiveWriter.h"
+#include "input_source/InputSource.h"
+#include "thread_pool/WorkStealingPool.h"
+#include "utils/file/file_utils.h"
+
+// main archive functions
+
+int batchArchive(const BatchCommand& command, unsigned jobs, const DictionaryCache* dictionaries) {
+    ArchiveWriter archiveWriter{command.archiveFile};
+    if (!archiveWriter.isOpen()) {
+        return 1;
+    }
+
+    std::size_t fileCount{command.files.size()};
+    std::vector<BatchFileResult> results(fileCount);
+    std::vector<uint64_t> sizes(fileCount);
+    for (std::size_t i{0}; i < fileCount; ++i) {
+        sizes[i] = getFileSize(command.files[i]);
+    }
+    unsigned threadsPerFile{std::max(1u, jobs / static_cast<unsigned>(std::max<std::size_t>(fileCount, 1)))};
+    CompressionOptions options{batchCompressionOptions(threadsPerFile, command.codingEngine, command.streams,
+                                                       dictionaries)};
+
+    auto start{std::chrono::steady_clock::now()};
+    {
+        WorkStealingPool pool{std::min(jobs, static_cast<unsigned>(std::max<std::size_t>(fileCount, 1)))};
+        for (std::size_t index : scheduleLargestFirst(sizes)) {
+            pool.submit([&command, &results, &archiveWriter, &options, index] {
+                const std::string& filePath{command.files[index]};
+                BatchFileResult& result{results[index]};
+                try {
+                    InputSource input{filePath};
+                    if (!input.isOpen()) {
+                        result.error = "Failed to read file";
+                        return;
+                    }
+
+                    ArchiveEntry entry{};
+                    if (!archiveWriter.add(input, getFileName(filePath), getFileExtension(filePath), options, entry)) {
+                        result.error = "Failed to add file to the archive";
+                        return;
+                    }
+                    result.success = true;
+                    result.outputPath = command.archiveFile;
+                    result.originalSize = entry.originalSize;
+                    result.compressedSize = entry.compressedSize;
+                } catch (const std::exception& exception) {
+                    result.error = exception.what();
+                }
+            });
+        }
+        pool.wait();
+    }
+    bool closed{archiveWriter.close()};
+    std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - start};
+
+    printBatchResult(command, results, elapsed.count());
+
+    bool allSucceeded{std::all_of(results.begin(), results.end(),
+                                  [](const BatchFileResult& result) { return result.success; })};
+    return closed && allSucceeded ? 0 : 1;
+}
+
+int batchExtract(const BatchCommand& command, unsigned jobs, const DictionaryCache* dictionaries) {
+    const std::string& archivePath{command.files.front()};
+    ArchiveReader archiveReader{archivePath};
+    if (!archiveReader.load()) {
+        return 1;
+    }
+    const ArchiveIndex& archiveIndex{archiveReader.getIndex()};
+
+    // every member when no names are given, otherwise only the members with those names
+    BatchCommand extractCommand{command};
+    extractCommand.decompress = true;
+    extractCommand.files.clear();
+    std::vector<const ArchiveEntry*> entries{};
+    std::vector<BatchFileResult> results{};
+    if (command.files.size() == 1) {
+        for (const ArchiveEntry& entry : archiveIndex.entries) {
+            extractCommand.files.push_back(entry.name);
+            entries.push_back(&entry);
+        }
+        results.resize(entries.size());
+    } else {
+        // a name given twice is only extracted once, as both would write the same file
+        std::set<std::string> names{};
+        for (std::size_t i{1}; i < command.files.size(); ++i) {
+            const std::string& name{command.files[i]};
+            extractCommand.files.push_back(name);
+            entries.push_back(archiveIndex.find(name));
+            results.emplace_back();
+            if (entries.back() == nullptr) {
+                results.back().error = "No member of the archive has this name";
+            } else if (!names.insert(name).second) {
+                entries.back() = nullptr;
+                results.back().error = "Given more than once";
+            }
+        }
+    }
+
+    std::size_t memberCount{entries.size()};
+    std::vector<uint64_t> sizes(memberCount);
+    for (std::size_t i{0}; i < memberCount; ++i) {
+        sizes[i] = entries[i] != nullptr ? entries[i]->originalSize : 0;
+    }
+    unsigned threadsPerFile{std::max(1u, jobs / static_cast<unsigned>(std::max<std::size_t>(memberCount, 1)))};
+    CompressionOptions options{};
+    options.threadCount = threadsPerFile;
+    options.dictionaries = dictionaries;
+    std::string destination{getDirectory(archivePath)};
+
+    auto start{std::chrono::steady_clock::now()};
+    {
+        WorkStealingPool pool{std::min(jobs, static_cast<unsigned>(std::max<std::size_t>(memberCount, 1)))};
+        for (std::size_t index : scheduleLargestFirst(sizes)) {
+            pool.submit([&archiveReader, &entries, &results, &options, &destination, index] {
+                BatchFileResult& result{results[index]};
+                const ArchiveEntry* entry{entries[index]};
+                if (entry == nullptr) {
+                    return; // already has its error
+                }
+
+                try {
+                    std::string decompressedFilePath{archiveReader.extract(*entry, destination, options)};
+                    if (decompressedFilePath.empty()) {
+                        result.error = "Member is not a valid .hzip file, or is corrupted";
+                        return;
+                    }
+                    result.success = true;
+                    result.outputPath = decompressedFilePath;
+                    result.originalSize = getFileSize(decompressedFilePath);
+                    result.compressedSize = entry->compressedSize;
+                } catch (const std::exception& exception) {
+                    result.error = exception.what();
+                }
+            });
+        }
+        pool.wait();
+    }
+    std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - start};
+
+    printBatchResult(extractCommand, results, elapsed.count());
+
+    bool allSucceeded{std::all_of(results.begin(), results.end(),
+                                  [](const BatchFileResult& result) { return result.success; })};
+    return allSucceeded ? 0 : 1;
+}
+
+int batchList(const BatchCommand& command) {
+    const std::string& archivePath{command.files.front()};
+    ArchiveReader archiveReader{archivePath};
+    if (!archiveReader.load()) {
+        return 1;
+    }
+
+    std::cout << std::endl;
+
+    std::cout << "[Archive] " << archivePath << "\n";
+    std::cout << std::left << std::setw(40) << "[Name]" << std::right << std::setw(16) << "[Original]"
+        << std::setw(16) << "[Compressed]" << "  [Table]\n";
+    uint64_t originalSize{0};
+    for (const ArchiveEntry& entry : archiveReader.getIndex().entries) {
+        std::cout << std::left << std::setw(40) << entry.name << std::right << std::setw(16) << entry.originalSize
+            << std::setw(16) << entry.compressedSize << "  "
+            << (entry.dictionaryId != 0 ? Dictionary::formatId(entry.dictionaryId) : "own") << "\n";
+        originalSize += entry.originalSize;
+    }
+
+    std::cout << std::endl;
+
+    std::cout << std::left << std::setw(20) << "[Members] " << archiveReader.getIndex().entries.size() << "\n";
+    std::cout << std::left << std::setw(20) << "[Original Size] " << originalSize << " bytes\n";
+    std::cout << std::left << std::setw(20) << "[Archive Size] " << getFileSize(archivePath) << " bytes\n";
+    return 0;
+}
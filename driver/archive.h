@@ -0,0 +1,37 @@
+// Archive Program Function Declarations
+
+// The batch program can also pack many files into a single archive (see ArchiveIndex), rather than writing a .hzip
+// file next to every file, which matters when there are so many small files that the file system itself slows down:
+
+//     02_huffman_encoding archive [-j N] [--adaptive] [--streams N] [--dict D]... [-o A] files...   pack into A
+//     02_huffman_encoding extract [-j N] [--dict D]... A [names...]                                 extract from A
+//     02_huffman_encoding list A                                                                    list A
+
+// archive compresses every file into a member of the archive A (archive.hzar by default), with the same options as
+// compressing it on its own, and the files are compressed at the same time by a WorkStealingPool as with c. No two
+// files may have the same name, as a member is found by its name.
+
+// extract decompresses the members with the names given (or every member) into the directory of the archive, at the
+// same time as with d. Only the index of the archive and the members asked for are read, so extracting one member of
+// an archive of millions costs about as much as decompressing that member on its own.
+
+// list prints the name, original size, compressed size and table (its own, or the ID of a dictionary) of every member,
+// which is read from the index alone.
+
+// The results of archive and extract are printed as for c and d, and the exit status is 0 only when every file or
+// member succeeds.
+
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+
+#include "batch.h"
+#include "huffman_tree/dictionary/DictionaryCache.h"
+
+// main archive functions, each returning the exit status of the program
+int batchArchive(const BatchCommand& command, unsigned jobs, const DictionaryCache* dictionaries = nullptr);
+int batchExtract(const BatchCommand& command, unsigned jobs, const DictionaryCache* dictionaries = nullptr);
+int batchList(const BatchCommand& command);
+
+
+#endif // ARCHIVE_H
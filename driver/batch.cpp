@@ -0,0 +1,405 @@
+// Batch Program Implementation
+
+#include "batch.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <numeric>
+
+#include "archive.h"
+#include "driver.h"
+#include "compression_session/CompressionSession.h"
+#include "huffman_tree/HuffmanTree.h"
+#include "huffman_tree/interleaved/InterleavedStreams.h"
+#include "input_source/InputSource.h"
+#include "thread_pool/ThreadPool.h"
+#include "thread_pool/WorkStealingPool.h"
+#include "utils/compression/compression_utils.h"
+#include "utils/file/file_utils.h"
+
+// main batch functions
+
+int batch(int argc, char* argv[]) {
+    BatchCommand command{};
+    if (!parseBatchCommand(argc, argv, command)) {
+        printBatchUsage(argv[0]);
+        return 2;
+    }
+
+    unsigned jobs{command.jobs == 0 ? ThreadPool::defaultThreadCount() : command.jobs};
+    if (command.train) {
+        return batchTrain(command, jobs);
+    }
+    if (command.list) {
+        return batchList(command);
+    }
+
+    // load every dictionary once, to be shared by every file
+    DictionaryCache dictionaries{};
+    for (const std::string& dictionaryFile : command.dictionaryFiles) {
+        if (!dictionaries.load(dictionaryFile)) {
+            return 1;
+        }
+    }
+    const DictionaryCache* sharedDictionaries{dictionaries.empty() ? nullptr : &dictionaries};
+    if (command.archive) {
+        return batchArchive(command, jobs, sharedDictionaries);
+    }
+    if (command.extract) {
+        return batchExtract(command, jobs, sharedDictionaries);
+    }
+
+    std::size_t fileCount{command.files.size()};
+    std::vector<BatchFileResult> results(fileCount);
+
+    // reject files which would be compressed into the same .hzip file, as they would overwrite each other
+    std::vector<bool> rejected(fileCount, false);
+    if (!command.decompress) {
+        std::map<std::string, std::size_t> compressedFilePaths{};
+        for (std::size_t i{0}; i < fileCount; ++i) {
+            try {
+                std::string compressedFilePath{getDirectory(command.files[i]) + "/" + getFileName(command.files[i])};
+                auto [existing, inserted] = compressedFilePaths.emplace(compressedFilePath, i);
+                if (!inserted) {
+                    rejected[i] = true;
+                    results[i].error = "Would overwrite the .hzip file of " + command.files[existing->second];
+                }
+            } catch (const std::exception&) {
+                // a file in a directory which does not exist fails when it is read
+            }
+        }
+    }
+
+    // schedule the largest files first
+    std::vector<uint64_t> sizes(fileCount);
+    for (std::size_t i{0}; i < fileCount; ++i) {
+        sizes[i] = getFileSize(command.files[i]);
+    }
+    std::vector<std::size_t> order{scheduleLargestFirst(sizes)};
+
+    // threads left over when there are fewer files than jobs are shared between the files
+    unsigned threadsPerFile{std::max(1u, jobs / static_cast<unsigned>(std::max<std::size_t>(fileCount, 1)))};
+
+    auto start{std::chrono::steady_clock::now()};
+    {
+        WorkStealingPool pool{std::min(jobs, static_cast<unsigned>(std::max<std::size_t>(fileCount, 1)))};
+        for (std::size_t index : order) {
+            if (rejected[index]) {
+                continue;
+            }
+
+            pool.submit([&command, &results, index, threadsPerFile, sharedDictionaries] {
+                const std::string& filePath{command.files[index]};
+                try {
+                    results[index] = command.decompress
+                        ? batchDecompress(filePath, threadsPerFile, sharedDictionaries)
+                        : batchCompress(filePath, threadsPerFile, command.codingEngine, command.streams,
+                                        sharedDictionaries);
+                } catch (const std::exception& exception) {
+                    results[index].error = exception.what();
+                }
+            });
+        }
+        pool.wait();
+    }
+    std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - start};
+
+    printBatchResult(command, results, elapsed.count());
+
+    bool allSucceeded{std::all_of(results.begin(), results.end(),
+                                  [](const BatchFileResult& result) { return result.success; })};
+    return allSucceeded ? 0 : 1;
+}
+
+BatchFileResult batchCompress(const std::string& filePath, unsigned threadCount, CodingEngine codingEngine,
+                              unsigned interleavedStreams, const DictionaryCache* dictionaries) {
+    BatchFileResult result{};
+
+    InputSource input{filePath};
+    if (!input.isOpen()) {
+        result.error = "Failed to read file";
+        return result;
+    }
+
+    CompressionOptions options{batchCompressionOptions(threadCount, codingEngine, interleavedStreams, dictionaries)};
+    CompressionSession session{input, filePath, options};
+    if (!session.run()) {
+        // only a failed write leaves the session written
+        result.error = session.getStage() == CompressionStage::WRITTEN ? "Failed to write compressed file"
+                                                                        : "Failed to compress file";
+        return result;
+    }
+
+    result.success = true;
+    result.outputPath = session.getWriteResult().compressedFilePath;
+    result.originalSize = session.getScanResult().originalSize;
+    result.compressedSize = session.getWriteResult().compressedSize;
+    result.stats = session.getStats();
+    return result;
+}
+
+BatchFileResult batchDecompress(const std::string& filePath, unsigned threadCount,
+                                const DictionaryCache* dictionaries) {
+    BatchFileResult result{};
+
+    std::string extension{".hzip"};
+    if (!(filePath.size() >= extension.size() &&
+        filePath.compare(filePath.size() - extension.size(), extension.size(), extension) == 0)) {
+        result.error = "File does not have the .hzip extension";
+        return result;
+    }
+
+    InputSource input{filePath};
+    if (!input.isOpen()) {
+        result.error = "Failed to read compressed file";
+        return result;
+    }
+
+    CompressionOptions options{};
+    options.threadCount = threadCount;
+    options.dictionaries = dictionaries;
+    HuffmanTree huffmanTree{};
+    std::string decompressedFilePath{huffmanTree.decompress(input, getDirectory(filePath), options)};
+    if (decompressedFilePath.empty()) {
+        result.error = "File is not a valid .hzip file, or is corrupted";
+        return result;
+    }
+
+    result.success = true;
+    result.outputPath = decompressedFilePath;
+    result.originalSize = getFileSize(decompressedFilePath);
+    result.compressedSize = input.size();
+    return result;
+}
+
+int batchTrain(const BatchCommand& command, unsigned jobs) {
+    // count every sample file on its own thread, then add up their frequencies
+    std::size_t fileCount{command.files.size()};
+    std::vector<ByteHistogram> histograms(fileCount);
+    std::vector<bool> read(fileCount, false);
+    {
+        WorkStealingPool pool{std::min(jobs, static_cast<unsigned>(fileCount))};
+        for (std::size_t i{0}; i < fileCount; ++i) {
+            pool.submit([&command, &histograms, &read, i] {
+                InputSource input{command.files[i]};
+                if (input.isOpen()) {
+                    histograms[i].countSource(input);
+                    read[i] = true;
+                }
+            });
+        }
+        pool.wait();
+    }
+
+    ByteHistogram histogram{};
+    std::size_t failures{0};
+    for (std::size_t i{0}; i < fileCount; ++i) {
+        if (read[i]) {
+            histogram.merge(histograms[i]);
+        } else {
+            std::cout << "Error: " << command.files[i] << ": Failed to read file.\n";
+            ++failures;
+        }
+    }
+    if (histogram.total() == 0) {
+        std::cout << "Error: No sample data to train a dictionary from.\n";
+        return 1;
+    }
+
+    // the same code length limit as compressing a file from the menu
+    Dictionary dictionary{};
+    dictionary.build(histogram, TreeBuilderEngine::TWO_QUEUE, DEFAULT_MAX_CODE_LENGTH);
+    if (!writeDictionaryFile(command.trainedDictionaryFile, dictionary)) {
+        return 1;
+    }
+
+    std::cout << std::endl;
+
+    std::cout << "[Dictionary Training Result]\n";
+    std::cout << std::left << std::setw(20) << "[Files] " << fileCount - failures << " read, " << failures
+        << " failed\n";
+    std::cout << std::left << std::setw(20) << "[Sample Size] " << histogram.total() << " bytes\n";
+    std::cout << std::left << std::setw(20) << "[Dictionary] " << Dictionary::formatId(dictionary.getId()) << "\n";
+    std::cout << std::left << std::setw(20) << "[Dictionary Path] " << command.trainedDictionaryFile << "\n";
+    return failures == 0 ? 0 : 1;
+}
+
+// helper functions for batch
+
+CompressionOptions batchCompressionOptions(unsigned threadCount, CodingEngine codingEngine, unsigned interleavedStreams,
+                                           const DictionaryCache* dictionaries) {
+    // the same options as compressing a file from the menu
+    CompressionOptions options{defaultCompressionOptions(false)};
+    options.threadCount = threadCount;
+    options.codingEngine = codingEngine;
+    if (interleavedStreams != 0) {
+        options.interleavedStreams = interleavedStreams;
+    }
+    options.dictionaries = dictionaries;
+    return options;
+}
+
+std::vector<std::size_t> scheduleLargestFirst(const std::vector<uint64_t>& sizes) {
+    std::vector<std::size_t> order(sizes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&sizes](std::size_t a, std::size_t b) { return sizes[a] > sizes[b]; });
+    return order;
+}
+
+bool parseBatchCommand(int argc, char* argv[], BatchCommand& command) {
+    if (argc < 2) {
+        return false;
+    }
+
+    std::string mode{argv[1]};
+    if (mode != "c" && mode != "d" && mode != "train" && mode != "archive" && mode != "extract" && mode != "list") {
+        return false;
+    }
+    command.decompress = mode == "d";
+    command.train = mode == "train";
+    command.archive = mode == "archive";
+    command.extract = mode == "extract";
+    command.list = mode == "list";
+
+    for (int i{2}; i < argc; ++i) {
+        std::string argument{argv[i]};
+        if (argument == "--stats" || argument == "--stats=text") {
+            command.stats = StatsFormat::TEXT;
+        } else if (argument == "--stats=json") {
+            command.stats = StatsFormat::JSON;
+        } else if (argument == "--adaptive") {
+            command.codingEngine = CodingEngine::ADAPTIVE;
+        } else if (argument == "--dict" && !command.train && !command.list) {
+            if (i + 1 >= argc) {
+                return false;
+            }
+            command.dictionaryFiles.emplace_back(argv[++i]);
+        } else if (argument == "-o" && (command.train || command.archive)) {
+            if (i + 1 >= argc) {
+                return false;
+            }
+            (command.train ? command.trainedDictionaryFile : command.archiveFile) = argv[++i];
+        } else if (argument == "-j" || (argument == "--streams" && (mode == "c" || mode == "archive"))) {
+            // the number of threads or streams must follow, and be a positive number
+            if (i + 1 >= argc) {
+                return false;
+            }
+            std::string value{argv[++i]};
+            bool isNumber{std::all_of(value.begin(), value.end(),
+                                      [](unsigned char character) { return std::isdigit(character) != 0; })};
+            if (value.empty() || value.size() > 4 || !isNumber) {
+                return false;
+            }
+            unsigned count{static_cast<unsigned>(std::stoul(value))};
+            if (count == 0 || (argument == "--streams" && count > InterleavedStreams::MAX_STREAMS)) {
+                return false;
+            }
+            (argument == "-j" ? command.jobs : command.streams) = count;
+        } else {
+            command.files.push_back(argument);
+        }
+    }
+
+    // statistics are only gathered by c and d
+    if (command.stats != StatsFormat::NONE && (command.archive || command.extract || command.list)) {
+        return false;
+    }
+
+    // extract takes the archive followed by any names, and list only the archive
+    return !command.files.empty() && !(command.list && command.files.size() > 1);
+}
+
+void printBatchUsage(const std::string& program) {
+    std::cout << "Usage: " << program
+        << " c [-j N] [--stats[=json]] [--adaptive] [--streams N] [--dict D]... files...\n";
+    std::cout << "       " << program << " d [-j N] [--stats[=json]] [--dict D]... files...\n";
+    std::cout << "       " << program << " train [-j N] [-o D] files...\n";
+    std::cout << "       " << program << " archive [-j N] [--adaptive] [--streams N] [--dict D]... [-o A] files...\n";
+    std::cout << "       " << program << " extract [-j N] [--dict D]... A [names...]\n";
+    std::cout << "       " << program << " list A\n";
+    std::cout << std::left << std::setw(14) << "  c" << "compress every file into a .hzip file in the same directory\n";
+    std::cout << std::left << std::setw(14) << "  d" << "decompress every .hzip file in the same directory\n";
+    std::cout << std::left << std::setw(14) << "  train" << "train a dictionary on every file as a sample\n";
+    std::cout << std::left << std::setw(14) << "  archive" << "compress every file into a member of the archive A\n";
+    std::cout << std::left << std::setw(14) << "  extract"
+        << "decompress the members with the names given (or every member) of the archive A into its directory\n";
+    std::cout << std::left << std::setw(14) << "  list" << "list every member of the archive A\n";
+    std::cout << std::left << std::setw(14) << "  -j N"
+        << "process N files at a time (default: every hardware thread)\n";
+    std::cout << std::left << std::setw(14) << "  --stats" << "print the time of each stage of compressing every file, "
+        << "and other stats (=json for a line of JSON per file)\n";
+    std::cout << std::left << std::setw(14) << "  --adaptive" << "compress with adaptive codes in a single pass\n";
+    std::cout << std::left << std::setw(14) << "  --streams N"
+        << "split the Huffman Code between N interleaved streams (1 to " << InterleavedStreams::MAX_STREAMS
+        << ", default: " << DEFAULT_INTERLEAVED_STREAMS << ")\n";
+    std::cout << std::left << std::setw(14) << "  --dict D"
+        << "compress with, or decompress files compressed with, the dictionary file D (may be repeated)\n";
+    std::cout << std::left << std::setw(14) << "  -o D"
+        << "save the trained dictionary to D (default: dictionary.hzd)\n";
+    std::cout << std::left << std::setw(14) << "  -o A"
+        << "write the archive to A (default: archive.hzar)\n";
+    std::cout << "Run with -c or -dc to compress or decompress stdin to stdout, or without arguments for the "
+        << "interactive menu.\n";
+}
+
+void printBatchResult(const BatchCommand& command, const std::vector<BatchFileResult>& results, double seconds) {
+    // print every failure (and the stats of every compressed file, if requested) in the order the files were given,
+    // then the totals of the successful files
+    bool json{command.stats == StatsFormat::JSON};
+    std::size_t failures{0};
+    uint64_t originalSize{0};
+    uint64_t compressedSize{0};
+    for (std::size_t i{0}; i < results.size(); ++i) {
+        const BatchFileResult& result{results[i]};
+        if (!result.success) {
+            if (json) {
+                std::cout << "{\"file\": \"" << escapeJson(command.files[i]) << "\", \"error\": \""
+                    << escapeJson(result.error) << "\"}\n";
+            } else {
+                std::cout << "Error: " << command.files[i] << ": " << result.error << ".\n";
+            }
+            ++failures;
+            continue;
+        }
+
+        originalSize += result.originalSize;
+        compressedSize += result.compressedSize;
+
+        if (command.decompress || command.stats == StatsFormat::NONE) {
+            continue;
+        }
+        if (json) {
+            printCompressionStatsJson(command.files[i], result.outputPath, result.stats);
+        } else {
+            std::cout << "\n[File] " << command.files[i] << '\n';
+            printCompressionStats(result.stats);
+        }
+    }
+
+    double megabytesPerSecond{seconds > 0 ? static_cast<double>(originalSize) / 1e6 / seconds : 0};
+
+    if (json) {
+        std::cout << std::setprecision(9) << "{\"batch\": \"" << (command.decompress ? "decompress" : "compress")
+            << "\", \"succeeded\": " << results.size() - failures << ", \"failed\": " << failures
+            << ", \"original_bytes\": " << originalSize << ", \"compressed_bytes\": " << compressedSize
+            << ", \"seconds\": " << seconds << ", \"mb_per_s\": " << megabytesPerSecond << "}\n";
+        return;
+    }
+
+    std::cout << std::endl;
+
+    std::cout << (command.decompress ? "[Batch Decompression Result]\n" : "[Batch Compression Result]\n");
+    std::cout << std::left << std::setw(20) << "[Files] " << results.size() - failures << " succeeded, " << failures
+        << " failed\n";
+    std::cout << std::left << std::setw(20) << "[Original Size] " << originalSize << " bytes\n";
+    std::cout << std::left << std::setw(20) << "[Compressed Size] " << compressedSize << " bytes\n";
+    std::cout << std::left << std::setw(20) << "[Time] " << std::fixed << std::setprecision(3) << seconds << " s\n";
+    std::cout << std::left << std::setw(20) << "[Throughput] " << std::fixed << std::setprecision(2)
+        << megabytesPerSecond << " MB/s\n";
+}
@@ -0,0 +1,107 @@
+// Batch Program Function Declarations
+
+// When the executable is run with arguments, the batch program is used instead of the interactive menu, so that files
+// can be compressed and decompressed from scripts:
+
+//     02_huffman_encoding c [-j N] [--stats[=json]] [--adaptive] [--streams N] [--dict D]... files...
+//     02_huffman_encoding d [-j N] [--stats[=json]] [--dict D]... files...
+//     02_huffman_encoding train [-j N] [-o D] files...
+
+// which compress every file, decompress every file, and train a dictionary on the files, as well as archive, extract
+// and list, which pack files into a single archive and read it back (see archive.h).
+
+// The files are processed at the same time by a WorkStealingPool of N threads (every hardware thread by default),
+// submitted from the largest to the smallest so that a large file is never left to finish on its own at the end. When
+// there are fewer files than threads, the threads left over are shared between the files so that each file is itself
+// compressed or decompressed in parallel. Files are compressed with the same options as the menu.
+
+// Compressing two files which would be written to the same .hzip file is rejected before anything is written.
+
+// An error is printed for every file which fails, followed by a summary of the total sizes, the time taken, and the
+// throughput in MB/s of the original data. The exit status is 0 only when every file succeeds.
+
+// With --stats, the CompressionStats of every compressed file (the time of each stage and other counters) are also
+// printed. With --stats=json, every line printed is instead a JSON object, one per file and a last one for the
+// summary, so that monitoring can collect the stats of every job. d has no stages to time, so with d only the
+// failures and the summary are printed, in either format.
+
+// With --adaptive, files are compressed with adaptive codes in a single pass (see CodingEngine) instead.
+
+// With --streams N, the Huffman Code of a file with a single table is split between N interleaved streams (from 1 to
+// InterleavedStreams::MAX_STREAMS) instead of DEFAULT_INTERLEAVED_STREAMS, where 1 writes a single stream as files
+// compressed before interleaved streams were, and more streams trade a few bytes per block for faster decoding (a
+// table with long codes is still written as a single stream, see InterleavedStreams::chooseStreamCount).
+
+// train counts every file as a sample and saves a Dictionary trained on all of them to D (dictionary.hzd by default).
+// With --dict, every dictionary file D given is loaded once into a DictionaryCache before any file is processed, and
+// shared by every file: c encodes each file with whichever dictionary makes it the smallest (when that is smaller
+// than its own table), and d decodes every file compressed with one of them. Many small files of the same kind, which
+// would otherwise each carry their own table, are then much smaller.
+
+#ifndef BATCH_H
+#define BATCH_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "compression_session/CompressionStats.h"
+#include "huffman_tree/adaptive/AdaptiveHuffman.h"
+#include "huffman_tree/components/CompressionOptions.h"
+#include "huffman_tree/dictionary/DictionaryCache.h"
+
+enum class StatsFormat {
+    NONE,
+    TEXT,
+    JSON,
+};
+
+class BatchCommand {
+public:
+    // public data members
+    bool decompress{false};
+    bool train{false};
+    bool archive{false};
+    bool extract{false};
+    bool list{false};
+    unsigned jobs{0}; // 0 for every hardware thread
+    StatsFormat stats{StatsFormat::NONE};
+    CodingEngine codingEngine{CodingEngine::TWO_PASS};
+    unsigned streams{0}; // given with --streams, 0 for the default of the menu
+    std::vector<std::string> dictionaryFiles{}; // given with --dict
+    std::string trainedDictionaryFile{"dictionary.hzd"}; // given with -o
+    std::string archiveFile{"archive.hzar"}; // given with -o
+    std::vector<std::string> files{};
+};
+
+class BatchFileResult {
+public:
+    // public data members
+    bool success{false};
+    std::string error{};
+    std::string outputPath{};
+    uint64_t originalSize{0};
+    uint64_t compressedSize{0};
+    CompressionStats stats{}; // only when compressing
+};
+
+// main batch functions
+int batch(int argc, char* argv[]); // returns the exit status of the program
+BatchFileResult batchCompress(const std::string& filePath, unsigned threadCount, CodingEngine codingEngine,
+                              unsigned interleavedStreams, const DictionaryCache* dictionaries = nullptr);
+BatchFileResult batchDecompress(const std::string& filePath, unsigned threadCount,
+                                const DictionaryCache* dictionaries = nullptr);
+int batchTrain(const BatchCommand& command, unsigned jobs); // returns the exit status of the program
+// helper functions for batch
+// the same options as the menu, with interleavedStreams of 0 for its default
+CompressionOptions batchCompressionOptions(unsigned threadCount, CodingEngine codingEngine, unsigned interleavedStreams,
+                                           const DictionaryCache* dictionaries);
+std::vector<std::size_t> scheduleLargestFirst(const std::vector<uint64_t>& sizes); // indices of the sizes in order
+bool parseBatchCommand(int argc, char* argv[], BatchCommand& command);
+void printBatchUsage(const std::string& program);
+void printBatchResult(const BatchCommand& command, const std::vector<BatchFileResult>& results, double seconds);
+
+
+#endif // BATCH_H
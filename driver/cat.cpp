@@ -0,0 +1,115 @@
+// Cat Program Implementation
+
+#include "cat.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+#include "huffman_tree/HuffmanTree.h"
+#include "huffman_tree/dictionary/DictionaryCache.h"
+#include "input_source/InputSource.h"
+
+namespace {
+    // a number of bytes, which must fit in 64 bits
+    bool parseByteCount(const std::string& value, uint64_t& count) {
+        bool isNumber{std::all_of(value.begin(), value.end(),
+                                  [](unsigned char character) { return std::isdigit(character) != 0; })};
+        if (value.empty() || value.size() > 19 || !isNumber) {
+            return false;
+        }
+        count = std::stoull(value);
+        return true;
+    }
+}
+
+// main cat functions
+
+bool isCatCommand(int argc, char* argv[]) {
+    return argc >= 2 && std::string{argv[1]} == "cat";
+}
+
+int cat(int argc, char* argv[]) {
+    uint64_t offset{0};
+    uint64_t length{0};
+    bool hasLength{false};
+    std::vector<std::string> dictionaryFiles{};
+    std::string filePath{};
+    for (int i{2}; i < argc; ++i) {
+        std::string argument{argv[i]};
+        bool hasValue{i + 1 < argc};
+        if (argument == "--offset" && hasValue && parseByteCount(argv[i + 1], offset)) {
+            ++i;
+        } else if (argument == "--length" && hasValue && parseByteCount(argv[i + 1], length)) {
+            hasLength = true;
+            ++i;
+        } else if (argument == "--dict" && hasValue) {
+            dictionaryFiles.emplace_back(argv[++i]);
+        } else if (filePath.empty() && argument.rfind("--", 0) != 0) {
+            filePath = argument;
+        } else {
+            printCatUsage(argv[0]);
+            return 2;
+        }
+    }
+    if (filePath.empty() || !hasLength) {
+        printCatUsage(argv[0]);
+        return 2;
+    }
+
+    // write raw bytes, without the standard streams keeping in step with C stdio
+    std::ios::sync_with_stdio(false);
+#if defined(_WIN32)
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+    // stdout carries the data, so every message printed to std::cout is sent to stderr instead
+    std::ostream output{std::cout.rdbuf(std::cerr.rdbuf())};
+
+    DictionaryCache dictionaries{};
+    bool success{true};
+    for (const std::string& dictionaryFile : dictionaryFiles) {
+        success = success && dictionaries.load(dictionaryFile);
+    }
+
+    CompressionOptions options{};
+    options.dictionaries = dictionaries.empty() ? nullptr : &dictionaries;
+    std::vector<uint8_t> range{};
+    InputSource input{filePath};
+    if (success && !input.isOpen()) {
+        std::cout << "Error: Failed to read file.\n";
+        success = false;
+    }
+    if (success) {
+        HuffmanTree huffmanTree{};
+        success = huffmanTree.decompressRange(input, offset, length, range, options);
+    }
+    if (success) {
+        output.write(reinterpret_cast<const char*>(range.data()), static_cast<std::streamsize>(range.size()));
+    }
+    output.flush();
+    std::cout.rdbuf(output.rdbuf());
+
+    if (!success || !output) {
+        std::cerr << "Error: Failed to read the range of " << filePath << ".\n";
+        return 1;
+    }
+    return 0;
+}
+
+// helper functions for cat
+
+void printCatUsage(const std::string& program) {
+    std::cerr << "Usage: " << program << " cat [--offset N] --length N [--dict D]... file.hzip > output\n";
+    std::cerr << "  --offset N   start N bytes into the original file (default: 0)\n";
+    std::cerr << "  --length N   write N bytes of the original file, fewer past its end\n";
+    std::cerr << "  --dict D     use the dictionary D, which the file may have been compressed with\n";
+}
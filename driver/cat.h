@@ -0,0 +1,30 @@
+// Cat Program Function Declarations
+
+// When the executable is run with cat as its first argument, a range of the original file of a compressed file is
+// written to stdout, without the rest of the file being decompressed (see HuffmanTree::decompressRange):
+
+//     02_huffman_encoding cat [--offset N] --length N [--dict D]... file.hzip | grep ...
+
+// --offset is where the range starts in the original file (0 by default), and --length is the number of bytes in the
+// range, which ends early at the end of the file. The range is decoded from the last sync point of the block index
+// before it, so reading a slice of a large file takes about as long as decoding DEFAULT_BLOCK_INDEX_SIZE bytes. A file
+// compressed with a dictionary needs the same dictionary, given with --dict as for the batch program.
+
+// The range is held in memory before it is written out, so the length is required rather than running to the end of
+// the file. As stdout carries the data, every message printed by the program is sent to stderr while cat runs. The
+// exit status is 0 on success, 1 if the range could not be decoded, and 2 for a usage error.
+
+#ifndef CAT_H
+#define CAT_H
+
+
+#include <string>
+
+// main cat functions
+bool isCatCommand(int argc, char* argv[]);
+int cat(int argc, char* argv[]); // returns the exit status of the program
+// helper functions for cat
+void printCatUsage(const std::string& program);
+
+
+#endif // CAT_H
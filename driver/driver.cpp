@@ -6,8 +6,13 @@
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <sstream>
+#include <utility>
 
+#include "compression_session/CompressionSession.h"
 #include "huffman_tree/HuffmanTree.h"
+#include "input_source/InputSource.h"
+#include "thread_pool/ThreadPool.h"
 #include "utils/file/file_utils.h"
 
 // main driver functions
@@ -19,53 +24,57 @@ void driver() {
 
         switch (menuResponse) {
         case 1:
-            compress();
+            compress(defaultCompressionOptions(false));
             break;
         case 2:
-            decompress();
+            compress(defaultCompressionOptions(true));
             break;
         case 3:
-            displayAbout();
+            decompress(ThreadPool::defaultThreadCount());
             break;
         case 4:
+            displayAbout();
+            break;
+        case 5:
             return;
         default: ;
         }
     }
 }
 
-void compress() {
-    std::cout << "\n[Compress a File]\n";
+void compress(const CompressionOptions& options) {
+    std::cout << (options.streaming ? "\n[Compress a Large File (Streaming)]\n" : "\n[Compress a File]\n");
 
     // get file path
     std::string filePath{promptFilePath()};
     // open the uncompressed file
-    std::ifstream input{filePath, std::ios::in | std::ios::binary}; // read in binary mode
-    if (!input) {
+    InputSource input{filePath};
+    if (!input.isOpen()) {
         std::cout << "\nError: Failed to read file. Recheck file name and path.\n";
         return;
     }
 
-    // retrieve information about the file
-    std::string fileName{getFileName(filePath)};
-    std::string fileExtension{getFileExtension(filePath)};
-    std::string directory{getDirectory(filePath)};
-
-    // construct Huffman Tree, compress the file, and write .hzip file to the same directory as original file
-    HuffmanTree huffmanTree{input, fileName, fileExtension, directory};
-    std::string compressedFilePath{huffmanTree.compress(input, directory)};
-
-    // retrieve size information about the original file and the compressed file
-    int originalSize{static_cast<int>(getFileSize(filePath))};
-    int compressedSize{static_cast<int>(getFileSize(compressedFilePath))};
-
-    // print compression result
-    printCompressionResult(compressedFilePath, originalSize, compressedSize);
+    // scan the file, build the Huffman Tree, encode the file, and write .hzip file to the same directory as original
+    // file, running each stage once
+    CompressionSession session{input, filePath, options};
+    if (!session.run()) {
+        if (session.getStage() == CompressionStage::WRITTEN) {
+            std::cout << "\nError: Failed to write compressed file. Recheck that its directory can be written.\n";
+        }
+        return;
+    }
 
-    input.close();
+    // print compression result from the size information of each stage
+    uint64_t originalSize{session.getScanResult().originalSize};
+    const WriteResult& writeResult{session.getWriteResult()};
+    printCompressionResult(writeResult.compressedFilePath, originalSize, writeResult.compressedSize);
+    if (options.maxCodeLength != 0) {
+        printLengthLimitCost(options.maxCodeLength, originalSize, session.getBuildResult().lengthLimitCost);
+    }
+    printCompressionStats(session.getStats());
 }
 
-void decompress() {
+void decompress(unsigned threadCount) {
     std::cout << "\n[Decompress a .hzip File]\n";
 
     // get file path
@@ -77,11 +86,12 @@ void decompress() {
     if (!(filePath.size() >= extension.size() &&
         filePath.compare(filePath.size() - extension.size(), extension.size(), extension) == 0)) {
         std::cout << "Error: File provided does not have the .hzip extension.\n";
-        }
+        return;
+    }
 
-    // open the uncompressed file
-    std::ifstream input{filePath, std::ios::in | std::ios::binary}; // read in binary mode
-    if (!input) {
+    // open the compressed file
+    InputSource input{filePath};
+    if (!input.isOpen()) {
         std::cout << "\nError: Failed to read compressed file. Recheck file name and path.\n";
         return;
     }
@@ -90,17 +100,21 @@ void decompress() {
     std::string directory{getDirectory(filePath)};
 
     // read the file, instantiate Huffman Tree, and write original file to the same directory as the .hzip file
+    CompressionOptions options{};
+    options.threadCount = threadCount;
     HuffmanTree decompressHuffmanTree{};
-    std::string decompressedFilePath{decompressHuffmanTree.decompress(input, directory)};
+    std::string decompressedFilePath{decompressHuffmanTree.decompress(input, directory, options)};
+    if (decompressedFilePath.empty()) {
+        std::cout << "\nError: File is not a valid .hzip file, or is corrupted.\n";
+        return;
+    }
 
     // retrieve size information about the compressed file and the decompressed file
-    int compressedSize{static_cast<int>(getFileSize(filePath))};
-    int decompressedSize{static_cast<int>(getFileSize(decompressedFilePath))};
+    uint64_t compressedSize{getFileSize(filePath)};
+    uint64_t decompressedSize{getFileSize(decompressedFilePath)};
 
     // print compression result
     printCompressionResult(decompressedFilePath, decompressedSize, compressedSize);
-
-    input.close();
 }
 
 void displayAbout() {
@@ -119,14 +133,31 @@ void displayAbout() {
 
 // helper functions for driver
 
+CompressionOptions defaultCompressionOptions(bool streaming) {
+    CompressionOptions options{};
+    options.streaming = streaming;
+    options.maxCodeLength = DEFAULT_MAX_CODE_LENGTH;
+    options.contextTables = true;
+    options.splitBlocks = true;
+
+    // streaming mode writes a single stream with a single thread and no block index
+    if (!streaming) {
+        options.threadCount = ThreadPool::defaultThreadCount();
+        options.blockIndexSize = DEFAULT_BLOCK_INDEX_SIZE;
+        options.interleavedStreams = DEFAULT_INTERLEAVED_STREAMS;
+    }
+    return options;
+}
+
 void printMenu() {
     std::cout << std::endl;
 
     std::cout << "[Huffman Encoding Compression Program]\n";
     std::cout << "1) Compress a File\n";
-    std::cout << "2) Decompress an .hzip File\n";
-    std::cout << "3) About Program\n";
-    std::cout << "4) Exit Program\n";
+    std::cout << "2) Compress a Large File (Streaming)\n";
+    std::cout << "3) Decompress an .hzip File\n";
+    std::cout << "4) About Program\n";
+    std::cout << "5) Exit Program\n";
 
     std::cout << std::endl;
 }
@@ -152,7 +183,7 @@ int promptMenuResponse() {
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
 
         // check valid menu option range
-        if (response < 1 || response > 4) {
+        if (response < 1 || response > 5) {
             std::cout << "\nError: Number is not in valid range of options. Try again\n";
             continue;
         }
@@ -169,7 +200,7 @@ std::string promptFilePath() {
     return response;
 }
 
-void printCompressionResult(const std::string& path, int oSize, int cSize) {
+void printCompressionResult(const std::string& path, uint64_t oSize, uint64_t cSize) {
     // determine compression percentage, accounting for negative when compressed file ends up larger
     bool negative{cSize > oSize};
     double max{std::max(static_cast<double>(oSize), static_cast<double>(cSize))};
@@ -189,3 +220,84 @@ void printCompressionResult(const std::string& path, int oSize, int cSize) {
     std::cout << std::left << std::setw(20) << "[Compression %] " << std::fixed << std::setprecision(2)
         << percentToOriginal << "% of original size " << status << '\n';
 }
+
+void printLengthLimitCost(unsigned maxCodeLength, uint64_t oSize, uint64_t costBits) {
+    // the cost in bytes of the original size, shown as a change to the compression percentage
+    uint64_t costBytes{(costBits + 7) / 8};
+    double costPercentage{oSize == 0 ? 0 : static_cast<double>(costBytes) / oSize * 100};
+
+    std::cout << std::left << std::setw(20) << "[Length Limit] " << maxCodeLength << "-bit codes cost " << costBytes
+        << " bytes (+" << std::fixed << std::setprecision(4) << costPercentage << "%)\n";
+}
+
+void printCompressionStats(const CompressionStats& stats) {
+    std::cout << std::endl;
+
+    // the time and throughput of each stage
+    std::cout << "[Compression Stats]\n";
+    std::pair<const char*, const StageStats*> stages[]{
+        {"[Read] ", &stats.read}, {"[Histogram] ", &stats.histogram}, {"[Tree Build] ", &stats.treeBuild},
+        {"[Table Build] ", &stats.tableBuild}, {"[Encode] ", &stats.encode}, {"[Write] ", &stats.write},
+    };
+    for (const auto& [name, stage] : stages) {
+        std::cout << std::left << std::setw(20) << name << std::fixed << std::setprecision(6) << stage->seconds
+            << " s  " << std::setprecision(2) << stage->megabytesPerSecond(stats.originalSize) << " MB/s\n";
+    }
+
+    // counters
+    std::cout << std::left << std::setw(20) << "[Symbols] " << stats.symbolCount << " (" << stats.distinctSymbols
+        << " distinct)\n";
+    std::cout << std::left << std::setw(20) << "[Code Length] " << std::fixed << std::setprecision(3)
+        << stats.averageCodeLength << " bits average, " << stats.maxCodeLength << " bits maximum\n";
+    std::cout << std::left << std::setw(20) << "[Context Tables] " << stats.contextTables << "\n";
+    std::cout << std::left << std::setw(20) << "[Split Blocks] " << stats.splitBlocks << "\n";
+    std::cout << std::left << std::setw(20) << "[Dictionary] "
+        << (stats.dictionaryId == 0 ? "none" : Dictionary::formatId(stats.dictionaryId)) << "\n";
+    std::cout << std::left << std::setw(20) << "[Overhead] " << stats.overheadBytes << " bytes\n";
+    std::cout << std::left << std::setw(20) << "[Peak Memory] " << stats.peakMemory << " bytes\n";
+}
+
+void printCompressionStatsJson(const std::string& path, const std::string& compressedPath,
+                               const CompressionStats& stats) {
+    // a single line, so that every file compressed can be collected line by line
+    std::ostringstream line{};
+    line << std::setprecision(9) << "{\"file\": \"" << escapeJson(path) << "\", \"compressed_file\": \""
+        << escapeJson(compressedPath) << "\", \"original_bytes\": " << stats.originalSize
+        << ", \"compressed_bytes\": " << stats.compressedSize << ", \"symbols\": " << stats.symbolCount
+        << ", \"distinct_symbols\": " << stats.distinctSymbols << ", \"average_code_length\": "
+        << stats.averageCodeLength << ", \"max_code_length\": " << stats.maxCodeLength << ", \"context_tables\": "
+        << stats.contextTables << ", \"split_blocks\": " << stats.splitBlocks << ", \"dictionary\": "
+        << (stats.dictionaryId == 0 ? "null" : "\"" + Dictionary::formatId(stats.dictionaryId) + "\"")
+        << ", \"overhead_bytes\": " << stats.overheadBytes << ", \"peak_memory_bytes\": " << stats.peakMemory
+        << ", \"total_seconds\": " << stats.totalSeconds() << ", \"stages\": {";
+
+    std::pair<const char*, const StageStats*> stages[]{
+        {"read", &stats.read}, {"histogram", &stats.histogram}, {"tree_build", &stats.treeBuild},
+        {"table_build", &stats.tableBuild}, {"encode", &stats.encode}, {"write", &stats.write},
+    };
+    bool first{true};
+    for (const auto& [name, stage] : stages) {
+        line << (first ? "" : ", ") << "\"" << name << "\": {\"seconds\": " << stage->seconds << ", \"mb_per_s\": "
+            << stage->megabytesPerSecond(stats.originalSize) << "}";
+        first = false;
+    }
+    line << "}}\n";
+
+    std::cout << line.str();
+}
+
+std::string escapeJson(const std::string& text) {
+    // quotes, backslashes and control characters must be escaped within a JSON string
+    std::ostringstream escaped{};
+    for (char character : text) {
+        if (character == '"' || character == '\\') {
+            escaped << '\\' << character;
+        } else if (static_cast<unsigned char>(character) < 0x20) {
+            escaped << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                << static_cast<int>(static_cast<unsigned char>(character)) << std::dec << std::setfill(' ');
+        } else {
+            escaped << character;
+        }
+    }
+    return escaped.str();
+}
@@ -9,20 +9,55 @@
 
 // For the file path prompts, both relative and absolute file paths should work.
 
+// Files are compressed with a CompressionSession, which runs each stage once and provides the sizes that are printed,
+// along with the time taken by each stage and other CompressionStats. The stats can also be printed as a single line
+// of JSON (see the batch program), for monitoring to collect.
+
+// Compressing a large file in streaming mode keeps memory use constant by writing the Huffman Code block by block.
+// Otherwise, files are compressed using every hardware thread of the computer, with a block index every
+// DEFAULT_BLOCK_INDEX_SIZE bytes so that they can also be decompressed using every hardware thread, and any range of
+// them read by decoding no more than a block before it (see the batch program's cat).
+
+// Codes are limited to DEFAULT_MAX_CODE_LENGTH bits so that decoding speed does not depend on how skewed the file is,
+// and the compression result also shows how many bytes the limit cost (usually none).
+
+// Outside streaming mode, the Huffman Code of a file with a single table is split between DEFAULT_INTERLEAVED_STREAMS
+// interleaved streams (see InterleavedStreams), which a single thread decodes faster than one stream, for a few bytes
+// every block of the streams, unless the longest code of the table is too long for the streams to pay off.
+
+// Context tables are enabled in both modes, so a file is encoded with the codes of the character before each character
+// whenever that makes it smaller (see ContextModel). So are split blocks, which give every part of a file whose
+// characters differ a table of its own (see BlockSplitter). Both are still encoded and decompressed using every
+// hardware thread outside streaming mode.
+
 #ifndef DRIVER_H
 #define DRIVER_H
 
 
+#include <cstdint>
 #include <string>
 
+#include "compression_session/CompressionStats.h"
+#include "huffman_tree/components/CompressionOptions.h"
+
+constexpr uint64_t DEFAULT_BLOCK_INDEX_SIZE{64 << 10};
+constexpr unsigned DEFAULT_MAX_CODE_LENGTH{15};
+constexpr unsigned DEFAULT_INTERLEAVED_STREAMS{4};
+
 // main driver functions
 void driver();
-void compress();
-void decompress();
+void compress(const CompressionOptions& options = CompressionOptions{});
+void decompress(unsigned threadCount = 1);
 void displayAbout();
 // helper functions for driver
+CompressionOptions defaultCompressionOptions(bool streaming); // the options of the menu, shared by the batch program
 void printMenu();
-void printCompressionResult(const std::string& path, int oSize, int cSize);
+void printCompressionResult(const std::string& path, uint64_t oSize, uint64_t cSize);
+void printLengthLimitCost(unsigned maxCodeLength, uint64_t oSize, uint64_t costBits);
+void printCompressionStats(const CompressionStats& stats);
+void printCompressionStatsJson(const std::string& path, const std::string& compressedPath,
+                               const CompressionStats& stats);
+std::string escapeJson(const std::string& text);
 int promptMenuResponse();
 std::string promptFilePath();
 
@@ -0,0 +1,72 @@
+// Piped Program Implementation
+
+#include "piped.h"
+
+#include <iostream>
+#include <ostream>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+#include "driver.h"
+#include "huffman_tree/HuffmanTree.h"
+#include "input_source/InputSource.h"
+
+// main piped functions
+
+bool isPipedCommand(int argc, char* argv[]) {
+    if (argc < 2) {
+        return false;
+    }
+
+    std::string mode{argv[1]};
+    return mode == "-c" || mode == "-dc" || mode == "-cd";
+}
+
+int piped(int argc, char* argv[]) {
+    std::string mode{argv[1]};
+    bool decompress{mode != "-c"};
+    bool adaptive{argc == 3 && std::string{argv[2]} == "--adaptive"};
+    if (argc > 3 || (argc == 3 && (!adaptive || decompress))) {
+        printPipedUsage(argv[0]);
+        return 2;
+    }
+
+    // read and write raw bytes, without the standard streams keeping in step with C stdio
+    std::ios::sync_with_stdio(false);
+    std::cin.tie(nullptr);
+#if defined(_WIN32)
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+    // stdout carries the data, so every message printed to std::cout is sent to stderr instead
+    std::ostream output{std::cout.rdbuf(std::cerr.rdbuf())};
+
+    CompressionOptions options{};
+    options.maxCodeLength = DEFAULT_MAX_CODE_LENGTH;
+    options.codingEngine = adaptive ? CodingEngine::ADAPTIVE : CodingEngine::TWO_PASS;
+    InputSource input{std::cin};
+    HuffmanTree huffmanTree{};
+    bool success{decompress ? huffmanTree.decompressPiped(input, output, options)
+                            : huffmanTree.compressPiped(input, output, options)};
+    output.flush();
+    std::cout.rdbuf(output.rdbuf());
+
+    if (!success || !output) {
+        std::cerr << "Error: Failed to " << (decompress ? "decompress" : "compress") << " stdin.\n";
+        return 1;
+    }
+    return 0;
+}
+
+// helper functions for piped
+
+void printPipedUsage(const std::string& program) {
+    std::cerr << "Usage: " << program << " -c [--adaptive] | -dc < input > output\n";
+    std::cerr << "  -c           compress stdin to stdout\n";
+    std::cerr << "  --adaptive   compress with adaptive codes, which need no table for each block\n";
+    std::cerr << "  -dc          decompress stdin to stdout\n";
+}
@@ -0,0 +1,28 @@
+// Piped Program Function Declarations
+
+// When the executable is run with -c or -dc as its first argument, the piped program is used instead of the batch
+// program, so that data can be compressed and decompressed in a shell pipeline without any file touching the disk:
+
+//     tar -c directory | 02_huffman_encoding -c | ssh host "02_huffman_encoding -dc | tar -x"
+
+// -c compresses stdin to stdout, and -dc (or -cd) decompresses stdin to stdout. Neither needs stdin to be seekable,
+// as the data is compressed in blocks (see HuffmanTree::compressPiped), with the same code length limit as the menu.
+// -c --adaptive compresses with adaptive codes instead, which carry on from block to block (see CodingEngine).
+
+// As stdout carries the data, every message printed by the program is sent to stderr while the piped program runs.
+// The exit status is 0 on success, 1 if the stream could not be compressed or decompressed, and 2 for a usage error.
+
+#ifndef PIPED_H
+#define PIPED_H
+
+
+#include <string>
+
+// main piped functions
+bool isPipedCommand(int argc, char* argv[]);
+int piped(int argc, char* argv[]); // returns the exit status of the program
+// helper functions for piped
+void printPipedUsage(const std::string& program);
+
+
+#endif // PIPED_H
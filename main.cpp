@@ -9,9 +9,24 @@
 
 // For information about the project structure, basic usage/testing, and other notes, consult the README.md.
 
+#include "batch.h"
+#include "cat.h"
 #include "driver.h"
+#include "piped.h"
+
+int main(int argc, char* argv[]) {
+    // arguments run the piped program for pipelines, the cat program to read part of a compressed file, or the batch
+    // program for scripts, otherwise the interactive menu is shown
+    if (isPipedCommand(argc, argv)) {
+        return piped(argc, argv);
+    }
+    if (isCatCommand(argc, argv)) {
+        return cat(argc, argv);
+    }
+    if (argc > 1) {
+        return batch(argc, argv);
+    }
 
-int main() {
     driver();
     return 0;
 }
@@ -0,0 +1,63 @@
+// Archive Index Header and Implementation
+
+// An archive packs many compressed files into a single file, so that millions of small files do not each need an
+// entry of their own in the file system. Every member of the archive is a whole compressed file, exactly as it would
+// be written on its own (with its header, sections, checksum and block index), one after the other behind the archive
+// header:
+
+// [Magic "HZAR"] > [Version] > [Member] > [Member] > ... > [Central Index] > [Index Offset] > [Entry Count] > "HZAI"
+
+// The central index at the end of the archive has an ArchiveEntry for every member: its name (the file name and
+// extension of the original file), where the member starts in the archive and how many bytes it takes, the size of
+// the original file, and which table the member was encoded with, which is the ID of its Dictionary (or 0 when it
+// holds its own table). Every entry is written as follows, where the lengths and sizes are varints (see HuffmanHeader):
+
+// [Name Length] > [Name] > [Offset] > [Compressed Size] > [Original Size] > [Dictionary ID (32 bits)]
+
+// The entries are sorted by name, so that a member is found with a binary search. The index is followed by a fixed
+// trailer: the offset of the index as a 64-bit unsigned integer, the number of entries as a 32-bit unsigned integer,
+// and the magic value "HZAI", every value stored least significant byte first. Reading the trailer from the end of the
+// archive is thus enough to find the index, and reading the index enough to find any member, which is decoded
+// without reading any other member.
+
+#ifndef ARCHIVE_INDEX_H
+#define ARCHIVE_INDEX_H
+
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class ArchiveEntry {
+public:
+    // public data members
+    std::string name{}; // file name and extension of the original file
+    uint64_t offset{0}; // where the member starts in the archive
+    uint64_t compressedSize{0}; // bytes the member takes in the archive
+    uint64_t originalSize{0};
+    uint32_t dictionaryId{0}; // 0 when the member holds its own table
+};
+
+class ArchiveIndex {
+public:
+    static constexpr uint8_t MAGIC[4]{'H', 'Z', 'A', 'R'};
+    static constexpr uint8_t CURRENT_VERSION{1};
+    static constexpr uint64_t HEADER_SIZE{sizeof(MAGIC) + 1};
+    static constexpr uint32_t INDEX_MAGIC{0x49415A48}; // "HZAI" when stored least significant byte first
+    static constexpr uint64_t TRAILER_SIZE{8 + 4 + 4}; // bytes after the entries
+    static constexpr uint64_t MAX_NAME_LENGTH{4096};
+
+    // public data members
+    std::vector<ArchiveEntry> entries{}; // sorted by name
+
+    // returns nullptr if no member has the name
+    [[nodiscard]] const ArchiveEntry* find(const std::string& name) const {
+        auto entry{std::lower_bound(entries.begin(), entries.end(), name,
+                                    [](const ArchiveEntry& a, const std::string& b) { return a.name < b; })};
+        return entry != entries.end() && entry->name == name ? &*entry : nullptr;
+    }
+};
+
+
+#endif // ARCHIVE_INDEX_H
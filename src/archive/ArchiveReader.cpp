@@ -0,0 +1,26 @@
+// Archive Reader Implementation
+
+#include "ArchiveReader.h"
+
+#include <iostream>
+
+#include "huffman_tree/HuffmanTree.h"
+#include "utils/compression/compression_utils.h"
+
+ArchiveReader::ArchiveReader(const std::string& path) : input(path) {}
+
+bool ArchiveReader::load() {
+    if (!input.isOpen()) {
+        std::cout << "Error: Failed to read archive.\n";
+        return false;
+    }
+    return readArchiveIndex(input, archiveIndex);
+}
+
+std::string ArchiveReader::extract(const ArchiveEntry& entry, const std::string& destination,
+                                   const CompressionOptions& options) {
+    // only the range of the member is read
+    InputSource member{input, entry.offset, entry.compressedSize};
+    HuffmanTree huffmanTree{};
+    return huffmanTree.decompress(member, destination, options);
+}
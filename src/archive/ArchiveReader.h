@@ -0,0 +1,42 @@
+// Archive Reader Header
+
+// An ArchiveReader opens an archive (see ArchiveIndex for its layout) and reads its central index, which is all that is
+// read until a member is extracted. load reads the trailer from the end of the archive and then the index, rejecting
+// (after printing an error) a file which is not an archive or whose index is corrupted.
+
+// extract decompresses a single member, found by name with ArchiveIndex::find or taken from the list of entries. The
+// member is viewed as an InputSource of its own over its range of the archive, so it is decompressed with
+// HuffmanTree::decompress exactly as the compressed file would be on its own (in place when the archive is mapped),
+// and no other member is read at all. Like decompress, extract writes the original file to the destination directory
+// and returns its path, or an empty path if the member could not be decompressed. Several threads can extract members
+// at once, each with its own HuffmanTree.
+
+#ifndef ARCHIVE_READER_H
+#define ARCHIVE_READER_H
+
+
+#include <string>
+
+#include "ArchiveIndex.h"
+#include "huffman_tree/components/CompressionOptions.h"
+#include "input_source/InputSource.h"
+
+class ArchiveReader {
+public:
+    // constructor
+    explicit ArchiveReader(const std::string& path);
+
+    bool load(); // returns false if the archive could not be read
+    std::string extract(const ArchiveEntry& entry, const std::string& destination,
+                        const CompressionOptions& options = CompressionOptions{});
+
+    [[nodiscard]] bool isOpen() const { return input.isOpen(); }
+    [[nodiscard]] const ArchiveIndex& getIndex() const { return archiveIndex; }
+
+private:
+    InputSource input;
+    ArchiveIndex archiveIndex{};
+};
+
+
+#endif // ARCHIVE_READER_H
@@ -0,0 +1,99 @@
+// Archive Writer Implementation
+
+#include "ArchiveWriter.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "huffman_tree/HuffmanTree.h"
+#include "utils/compression/compression_utils.h"
+#include "utils/file/file_utils.h"
+
+ArchiveWriter::ArchiveWriter(const std::string& path)
+    : path(path), output(path, std::ios::out | std::ios::binary) { // write in binary mode
+    if (!output) {
+        std::cout << "Error: Failed to create archive " << path << ".\n";
+        return;
+    }
+
+    writeArchiveHeader(output);
+    position = ArchiveIndex::HEADER_SIZE;
+    open = static_cast<bool>(output);
+}
+
+bool ArchiveWriter::add(InputSource& input, const std::string& name, const std::string& extension,
+                        const CompressionOptions& options, ArchiveEntry& entry) {
+    entry = ArchiveEntry{};
+    entry.name = name + extension;
+    if (entry.name.size() > ArchiveIndex::MAX_NAME_LENGTH) {
+        std::cout << "Error: The name of " << entry.name << " is too long.\n";
+        return false;
+    }
+    std::string memberPath{};
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        if (!names.insert(entry.name).second) {
+            std::cout << "Error: More than one file is named " << entry.name << ".\n";
+            return false;
+        }
+        memberPath = path + "." + std::to_string(memberCount++) + ".part";
+    }
+
+    // compress the file into a temporary file, exactly as it would be written on its own
+    HuffmanTree huffmanTree{input, name, extension, options};
+    huffmanTree.encode(input);
+    {
+        std::ofstream member{memberPath, std::ios::out | std::ios::binary}; // write in binary mode
+        bool written{huffmanTree.write(input, member)};
+        member.close();
+        if (!written || !member) {
+            std::cout << "Error: Failed to compress " << entry.name << " for the archive.\n";
+            removeFile(memberPath);
+            return false;
+        }
+    }
+
+    entry.compressedSize = getFileSize(memberPath);
+    entry.originalSize = huffmanTree.getHuffmanHeader().originalSize;
+    entry.dictionaryId = huffmanTree.getDictionary() != nullptr ? huffmanTree.getDictionary()->getId() : 0;
+
+    // then copy it to the end of the archive one buffer at a time
+    std::ifstream member{memberPath, std::ios::in | std::ios::binary}; // read in binary mode
+    std::vector<char> buffer(COPY_BUFFER_SIZE);
+    uint64_t copied{0};
+    std::lock_guard<std::mutex> lock{mutex};
+    entry.offset = position;
+    while (member && output) {
+        member.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        output.write(buffer.data(), member.gcount());
+        copied += static_cast<uint64_t>(member.gcount());
+    }
+    member.close();
+    removeFile(memberPath);
+    if (!output || copied != entry.compressedSize) {
+        std::cout << "Error: Failed to write " << entry.name << " to the archive.\n";
+        return false;
+    }
+    position += copied;
+    archiveIndex.entries.push_back(entry);
+    return true;
+}
+
+bool ArchiveWriter::close() {
+    std::lock_guard<std::mutex> lock{mutex};
+    if (!open) {
+        return false;
+    }
+
+    std::sort(archiveIndex.entries.begin(), archiveIndex.entries.end(),
+              [](const ArchiveEntry& a, const ArchiveEntry& b) { return a.name < b.name; });
+    writeArchiveIndex(output, archiveIndex, position);
+    output.close();
+    open = false;
+    if (!output) {
+        std::cout << "Error: Failed to write the archive index.\n";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,58 @@
+// Archive Writer Header
+
+// An ArchiveWriter creates an archive (see ArchiveIndex for its layout) from any number of files. The constructor
+// creates the archive and writes its header, add compresses one file into a new member of the archive, and close
+// writes the central index once every member has been added.
+
+// Each file is compressed by a HuffmanTree of its own, with the options given (such as the dictionaries to choose
+// from), into a temporary file next to the archive, which is then copied to the end of the archive behind a mutex, one
+// buffer at a time, and removed. Several threads can therefore add files at once, with only the appending done one
+// member at a time, and no member is ever held in memory a second time as a whole. Members are appended in whichever
+// order they finish, which does not matter as the index records where each one starts, and the index is sorted by
+// name when it is written.
+
+// Every member must have a different name, as a member is found by its name. add rejects a file (after printing an
+// error) whose name is already in the archive (or is longer than any name an index can hold), before compressing it.
+
+#ifndef ARCHIVE_WRITER_H
+#define ARCHIVE_WRITER_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <string>
+
+#include "ArchiveIndex.h"
+#include "huffman_tree/components/CompressionOptions.h"
+#include "input_source/InputSource.h"
+
+class ArchiveWriter {
+public:
+    // constructor
+    explicit ArchiveWriter(const std::string& path);
+
+    // each returns false (after printing an error) if it failed, and add can be called by several threads at once
+    bool add(InputSource& input, const std::string& name, const std::string& extension,
+             const CompressionOptions& options, ArchiveEntry& entry);
+    bool close();
+
+    [[nodiscard]] bool isOpen() const { return open; }
+
+private:
+    static constexpr std::size_t COPY_BUFFER_SIZE{1 << 20};
+
+    std::string path{};
+    std::ofstream output{};
+    bool open{false};
+    uint64_t position{0};
+    ArchiveIndex archiveIndex{};
+    std::set<std::string> names{}; // of every member added or being added
+    uint64_t memberCount{0}; // of every member added or being added, which numbers their temporary files
+    std::mutex mutex{};
+};
+
+
+#endif // ARCHIVE_WRITER_H
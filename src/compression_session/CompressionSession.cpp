@@ -0,0 +1,159 @@
+// Compression Session Implementation
+
+#include "CompressionSession.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#include "utils/file/file_utils.h"
+#include "utils/memory/memory_utils.h"
+
+CompressionSession::CompressionSession(InputSource& input, const std::string& filePath,
+                                       const CompressionOptions& options)
+    : input(input), directory(getDirectory(filePath)), adaptive(options.codingEngine == CodingEngine::ADAPTIVE) {
+    huffmanTree.reset(getFileName(filePath), getFileExtension(filePath), options);
+    stats.read.seconds = input.getReadSeconds(); // the file was already opened (and mapped)
+}
+
+// stages
+
+bool CompressionSession::scan() {
+    if (!isNext(CompressionStage::SCANNED, "Scan")) {
+        return false;
+    }
+
+    timeStage(stats.histogram, [this] { huffmanTree.scan(input); });
+    stage = CompressionStage::SCANNED;
+
+    // nothing is counted for adaptive codes, so only the size of the file is known
+    const ByteHistogram& histogram{huffmanTree.getHistogram()};
+    scanResult.originalSize = adaptive ? input.size() : histogram.total();
+    scanResult.distinctCharacters = static_cast<unsigned>(
+        std::count_if(histogram.frequencies.begin(), histogram.frequencies.end(),
+                      [](uint64_t frequency) { return frequency != 0; }));
+    stats.originalSize = scanResult.originalSize;
+    stats.symbolCount = scanResult.originalSize;
+    stats.distinctSymbols = scanResult.distinctCharacters;
+    return true;
+}
+
+bool CompressionSession::build() {
+    if (!isNext(CompressionStage::BUILT, "Build")) {
+        return false;
+    }
+
+    timeStage(stats.treeBuild, [this] { huffmanTree.buildTree(); });
+    timeStage(stats.tableBuild, [this] { huffmanTree.buildTable(); });
+    stage = CompressionStage::BUILT;
+
+    // the length of the Huffman Code follows from the frequencies and the code lengths
+    const EncodingTable& encodingTable{huffmanTree.getEncodingTable()};
+    const ByteHistogram& histogram{huffmanTree.getHistogram()};
+    for (std::size_t character{0}; character < encodingTable.size(); ++character) {
+        buildResult.longestCodeLength = std::max(buildResult.longestCodeLength, encodingTable[character].length);
+        encodedBits += histogram.frequencies[character] * encodingTable[character].length;
+    }
+    buildResult.lengthLimitCost = huffmanTree.getLengthLimitCost();
+
+    // or from the tables of every cluster of contexts or every block when they are used instead
+    const ContextModel& contextModel{huffmanTree.getContextModel()};
+    const BlockSplitter& blockSplitter{huffmanTree.getBlockSplitter()};
+    const std::vector<EncodingTable>* tables{nullptr};
+    if (contextModel.getTableCount() != 0) {
+        tables = &contextModel.getEncodingTables();
+        buildResult.contextTables = contextModel.getTableCount();
+        encodedBits = contextModel.getEncodedBits();
+    } else if (blockSplitter.getTableCount() != 0) {
+        tables = &blockSplitter.getEncodingTables();
+        buildResult.splitBlocks = blockSplitter.getBlocks().size();
+        encodedBits = blockSplitter.getEncodedBits();
+    }
+    if (tables != nullptr) {
+        buildResult.longestCodeLength = 0;
+        for (const EncodingTable& table : *tables) {
+            for (const HuffmanCodeword& codeword : table) {
+                buildResult.longestCodeLength = std::max(buildResult.longestCodeLength, codeword.length);
+            }
+        }
+    }
+    stats.contextTables = buildResult.contextTables;
+    stats.splitBlocks = buildResult.splitBlocks;
+    if (huffmanTree.getDictionary() != nullptr) {
+        buildResult.dictionaryId = huffmanTree.getDictionary()->getId();
+    }
+    stats.dictionaryId = buildResult.dictionaryId;
+    stats.maxCodeLength = buildResult.longestCodeLength;
+    stats.averageCodeLength = stats.symbolCount == 0 ? 0
+        : static_cast<double>(encodedBits) / static_cast<double>(stats.symbolCount);
+    return true;
+}
+
+bool CompressionSession::encode() {
+    if (!isNext(CompressionStage::ENCODED, "Encode")) {
+        return false;
+    }
+
+    timeStage(stats.encode, [this] { huffmanTree.encode(input); });
+    stage = CompressionStage::ENCODED;
+
+    encodeResult.tableBits = huffmanTree.getHuffmanHeader().treeLength;
+    encodeResult.encodingBits = huffmanTree.getHuffmanHeader().encodingLength;
+    encodeResult.blockIndexEntries = huffmanTree.getBlockIndex().entries.size();
+
+    // adaptive codes are only known once encoded (and not until written in streaming mode)
+    if (adaptive) {
+        encodedBits = encodeResult.encodingBits;
+        stats.averageCodeLength = stats.symbolCount == 0 ? 0
+            : static_cast<double>(encodedBits) / static_cast<double>(stats.symbolCount);
+    }
+    return true;
+}
+
+bool CompressionSession::write() {
+    if (!isNext(CompressionStage::WRITTEN, "Write")) {
+        return false;
+    }
+
+    timeStage(stats.write, [this] { writeResult.compressedFilePath = huffmanTree.write(input, directory); });
+    stage = CompressionStage::WRITTEN;
+    if (writeResult.compressedFilePath.empty()) {
+        return false;
+    }
+
+    writeResult.compressedSize = getFileSize(writeResult.compressedFilePath);
+    uint64_t encodedBytes{(encodedBits + 7) / 8};
+    stats.compressedSize = writeResult.compressedSize;
+    stats.overheadBytes = writeResult.compressedSize > encodedBytes ? writeResult.compressedSize - encodedBytes : 0;
+    stats.peakMemory = getPeakMemoryUsage();
+    return true;
+}
+
+bool CompressionSession::run() {
+    // stages which have already run are skipped
+    return (stage >= CompressionStage::SCANNED || scan()) && (stage >= CompressionStage::BUILT || build()) &&
+        (stage >= CompressionStage::ENCODED || encode()) && (stage >= CompressionStage::WRITTEN || write());
+}
+
+bool CompressionSession::isNext(CompressionStage next, const std::string& name) const {
+    // every stage follows the one before it in the enumeration
+    if (static_cast<int>(stage) + 1 != static_cast<int>(next)) {
+        std::cout << "Error: Compression stage " << name << " cannot run "
+            << (stage >= next ? "again" : "before the previous stage") << ".\n";
+        return false;
+    }
+
+    return true;
+}
+
+void CompressionSession::timeStage(StageStats& stageStats, const std::function<void()>& runStage) {
+    // the time spent reading the file during the stage is counted as Read instead
+    double readSeconds{input.getReadSeconds()};
+    auto start{std::chrono::steady_clock::now()};
+    runStage();
+    std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - start};
+
+    readSeconds = input.getReadSeconds() - readSeconds;
+    stats.read.seconds += readSeconds;
+    stageStats.seconds += std::max(0.0, elapsed.count() - readSeconds);
+}
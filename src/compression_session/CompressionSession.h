@@ -0,0 +1,122 @@
+// Compression Session Header
+
+// A CompressionSession compresses a single file by running the four stages of the HuffmanTree one after another, each
+// exactly once:
+
+// [Scan] > [Build] > [Encode] > [Write]
+
+// Scan counts the histogram of the file, Build creates the Huffman Tree and its encoding table from that histogram,
+// Encode generates every section of the compressed file (in streaming mode only the first sections, as the Huffman Code
+// is encoded as it is written), and Write writes the .hzip file to the same directory as the original file. The
+// histogram counted by Scan is kept by the HuffmanTree and reused by Build, and by Encode when several threads are used
+// (to find where every chunk begins in the Huffman Code). The InputSource is opened by the caller and read in place by
+// every stage, so the file is never read into a buffer of its own.
+
+// With the ADAPTIVE coding engine, Scan and Build do nothing and the whole file is read once by Encode, so the number
+// of distinct characters and the longest code are not known.
+
+// When Build keeps context tables (see ContextModel), the length of the Huffman Code and the longest code are those of
+// the tables of every cluster instead, and contextTables is their number (0 when a single table is used). Likewise when
+// it keeps split blocks (see BlockSplitter), splitBlocks is the number of blocks (0 when the file is not split), and
+// when it uses the codes of a Dictionary, dictionaryId is its ID (0 when no dictionary is used).
+
+// While the stages run, the session also collects CompressionStats: the time taken by each stage, and counters about
+// the Huffman Code, the overhead of the compressed file, and memory use.
+
+// Each stage function returns false (after printing an error) when it is run out of order or a second time, and run
+// runs whichever stages have not run yet. After a stage has run, its results can be read with the matching getter.
+// Write also returns false, without printing anything, when the .hzip file could not be written, leaving the path of
+// its WriteResult empty, so that the caller reports the failure in its own format (such as a JSON error record).
+
+#ifndef COMPRESSION_SESSION_H
+#define COMPRESSION_SESSION_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "CompressionStats.h"
+#include "huffman_tree/HuffmanTree.h"
+#include "huffman_tree/components/CompressionOptions.h"
+#include "input_source/InputSource.h"
+
+enum class CompressionStage {
+    NONE,
+    SCANNED,
+    BUILT,
+    ENCODED,
+    WRITTEN,
+};
+
+// results of each stage (public data members are fine)
+class ScanResult {
+public:
+    uint64_t originalSize{0};
+    unsigned distinctCharacters{0};
+};
+
+class BuildResult {
+public:
+    uint8_t longestCodeLength{0};
+    uint64_t lengthLimitCost{0}; // bits added to the Huffman Code by limiting the length of the codes
+    unsigned contextTables{0};
+    std::size_t splitBlocks{0};
+    uint32_t dictionaryId{0};
+};
+
+class EncodeResult {
+public:
+    uint64_t tableBits{0}; // bits of the Tree Representation (or code length table)
+    uint64_t encodingBits{0}; // bits of the Huffman Code, 0 in streaming mode as it is encoded by Write
+    std::size_t blockIndexEntries{0};
+};
+
+class WriteResult {
+public:
+    std::string compressedFilePath{};
+    uint64_t compressedSize{0};
+};
+
+class CompressionSession {
+public:
+    CompressionSession(InputSource& input, const std::string& filePath,
+                       const CompressionOptions& options = CompressionOptions{}); // constructor
+
+    // stages
+    bool scan();
+    bool build();
+    bool encode();
+    bool write();
+    bool run(); // runs every stage which has not run yet
+
+    // getters
+    [[nodiscard]] CompressionStage getStage() const { return stage; }
+    [[nodiscard]] const HuffmanTree& getHuffmanTree() const { return huffmanTree; }
+    [[nodiscard]] const ScanResult& getScanResult() const { return scanResult; }
+    [[nodiscard]] const BuildResult& getBuildResult() const { return buildResult; }
+    [[nodiscard]] const EncodeResult& getEncodeResult() const { return encodeResult; }
+    [[nodiscard]] const WriteResult& getWriteResult() const { return writeResult; }
+    [[nodiscard]] const CompressionStats& getStats() const { return stats; }
+
+private:
+    InputSource& input;
+    std::string directory{};
+    HuffmanTree huffmanTree{};
+    CompressionStage stage{CompressionStage::NONE};
+    bool adaptive{false};
+
+    ScanResult scanResult{};
+    BuildResult buildResult{};
+    EncodeResult encodeResult{};
+    WriteResult writeResult{};
+    CompressionStats stats{};
+    uint64_t encodedBits{0};
+
+    bool isNext(CompressionStage next, const std::string& name) const; // checks that the stage is run in order
+    void timeStage(StageStats& stageStats, const std::function<void()>& runStage);
+};
+
+
+#endif // COMPRESSION_SESSION_H
@@ -0,0 +1,68 @@
+// Compression Stats Header and Implementation
+
+// The CompressionStats are collected by a CompressionSession while it compresses a file, so that a slow compression
+// can be traced to the stage responsible without a profiler. Every stage has its wall time, from which its throughput
+// in MB/s of the original file is found:
+
+// [Read] > [Histogram] > [Tree Build] > [Table Build] > [Encode] > [Write]
+
+// Read is the time spent reading the file (see InputSource::getReadSeconds), which is taken out of the time of the
+// stage doing the reading. For a mapped file this is only the time taken to map it, as the pages of the file are then
+// read by the operating system while the histogram is counted. When several threads read the fallback stream, Read is
+// the sum of the time of every thread. In streaming mode the Huffman Code is encoded as it is written, so Encode only
+// covers the first sections and the encoding time is part of Write.
+
+// The counters describe the Huffman Code: the number of symbols (characters) encoded, the number of distinct symbols,
+// the average and maximum length of their codes, the number of context tables (see ContextModel), the number of split
+// blocks (see BlockSplitter) and the ID of the Dictionary whose codes were used, if any. The overhead is every byte of
+// the compressed file which is not Huffman Code (the header, file information, code length table or tree
+// representation, block lengths and index), and the peak memory is that of the whole program (see
+// getPeakMemoryUsage).
+
+#ifndef COMPRESSION_STATS_H
+#define COMPRESSION_STATS_H
+
+
+#include <cstddef>
+#include <cstdint>
+
+class StageStats {
+public:
+    // public data member
+    double seconds{0};
+
+    [[nodiscard]] double megabytesPerSecond(uint64_t bytes) const {
+        return seconds > 0 ? static_cast<double>(bytes) / 1e6 / seconds : 0;
+    }
+};
+
+class CompressionStats {
+public:
+    // public data members
+    StageStats read{};
+    StageStats histogram{};
+    StageStats treeBuild{};
+    StageStats tableBuild{};
+    StageStats encode{};
+    StageStats write{};
+
+    uint64_t originalSize{0};
+    uint64_t compressedSize{0};
+    uint64_t symbolCount{0};
+    unsigned distinctSymbols{0};
+    double averageCodeLength{0}; // bits per symbol
+    unsigned maxCodeLength{0};
+    unsigned contextTables{0}; // 0 when a single table is used
+    std::size_t splitBlocks{0}; // 0 when the file is not split
+    uint32_t dictionaryId{0}; // 0 when no dictionary is used
+    uint64_t overheadBytes{0};
+    uint64_t peakMemory{0}; // bytes, 0 if unknown
+
+    [[nodiscard]] double totalSeconds() const {
+        return read.seconds + histogram.seconds + treeBuild.seconds + tableBuild.seconds + encode.seconds +
+            write.seconds;
+    }
+};
+
+
+#endif // COMPRESSION_STATS_H
@@ -7,23 +7,36 @@
 
 // https://en.cppreference.com/w/cpp/utility/optional
 
+// The nodes of a Huffman Tree are stored in a HuffmanNodeArena, so left and right are the indices of the children in
+// the arena (NO_NODE for a leaf node). Together with the weight this keeps a node within 16 bytes, so four nodes share
+// a single cache line.
+
 #ifndef HUFFMAN_NODE_H
 #define HUFFMAN_NODE_H
 
 
+#include <cstdint>
 #include <optional>
 
+#include "huffman_tree/node_arena/NodeArena.h"
+
 class HuffmanNode {
 public:
     // constructors
-    HuffmanNode(char keyValue, int weightValue) : key(keyValue), weight(weightValue) {} // for priority queue
-    explicit HuffmanNode(int weightValue) : weight(weightValue) {} // for building Huffman Tree
+    HuffmanNode() = default; // for the arena
+    HuffmanNode(char keyValue, uint64_t weightValue) : key(keyValue), weight(weightValue) {} // for priority queue
+    HuffmanNode(uint64_t weightValue, uint16_t leftIndex, uint16_t rightIndex) // for building Huffman Tree
+        : weight(weightValue), left(leftIndex), right(rightIndex) {}
+
     // public data members
     std::optional<char> key{std::nullopt};
-    int weight{};
-    HuffmanNode* left{nullptr};
-    HuffmanNode* right{nullptr};
+    uint64_t weight{};
+    uint16_t left{NO_NODE};
+    uint16_t right{NO_NODE};
 };
 
+// 256 leaf nodes and 255 non-leaf nodes
+typedef NodeArena<HuffmanNode, 511> HuffmanNodeArena;
+
 
 #endif // HUFFMAN_NODE_H
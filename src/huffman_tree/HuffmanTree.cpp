@@ -2,67 +2,440 @@
 
 #include "huffman_tree/HuffmanTree.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <fstream>
-#include <unordered_map>
+#include <iostream>
+#include <optional>
 
-#include "priority_queue/PriorityQueue.h"
+#include "interleaved/InterleavedStreams.h"
+#include "package_merge/PackageMerge.h"
+#include "tree_builder/TreeBuilder.h"
 
+#include "utils/checksum/checksum_utils.h"
 #include "utils/generate/generate_utils.h"
 #include "utils/compression/compression_utils.h"
+#include "utils/file/file_utils.h"
 #include "utils/instantiate/instantiate_utils.h"
+#include "utils/parallel/parallel_utils.h"
+
+HuffmanTree::HuffmanTree(InputSource& input, const std::string& name, const std::string& extension,
+                         const CompressionOptions& options) {
+    reset(name, extension, options);
+    scan(input);
+    build();
+}
+
+void HuffmanTree::reset() {
+    // clear every data member, keeping the memory already held by the sections for the next file
+    huffmanTreeNodes.clear();
+    huffmanTreeRoot = NO_NODE;
+    fileInformation.fileName.clear();
+    fileInformation.fileExtension.clear();
+    compressionOptions = CompressionOptions{};
+    histogram = ByteHistogram{};
+    encodingTable.fill(HuffmanCodeword{});
+    adaptiveHuffman.reset();
+    contextHistogram.clear();
+    contextModel.reset();
+    blockSplitter.reset();
+    dictionary = nullptr;
+    frequencyChunks.clear();
+    lengthLimitCost = 0;
+    checksum = 0;
+    huffmanHeader = HuffmanHeader{0, 0, 0};
+    huffmanFileInfoCode.clear();
+    huffmanTreeRepresentation.clear();
+    huffmanCode.clear();
+    blockIndex.entries.clear();
+    blockIndex.originalSize = 0;
+    blockIndex.previousCharacters = false;
+}
+
+void HuffmanTree::reset(const std::string& name, const std::string& extension, const CompressionOptions& options) {
+    reset();
+    compressionOptions = options;
+    histogram = ByteHistogram{compressionOptions.histogramEngine};
+    blockSplitter = BlockSplitter{compressionOptions.histogramEngine};
 
-HuffmanTree::HuffmanTree(std::ifstream& input, const std::string& name, const std::string& extension,
-                         const std::string& destination) {
     // create fileInformation
-    fileInformation = FileInformation{name, extension};
+    fileInformation.fileName = name;
+    fileInformation.fileExtension = extension;
+}
 
-    // build Huffman Tree
-    FrequencyHashMap hashMap{input, 10}; // hash map of frequencies of each character
-    PriorityQueue priorityQueue{hashMap}; // min-heap priority queue where the lowest weight is accessed first
-    huffmanTreeRoot = priorityQueue.getHuffmanTree(); // pass the constructed Huffman Tree in the priority queue
+std::string HuffmanTree::compress(InputSource& input, const std::string& destination) {
+    // generate data members, then write them to file
+    encode(input);
+    return write(input, destination);
+}
+
+// compression stages
+
+void HuffmanTree::scan(InputSource& input) {
+    // histogram of frequencies of each character, counted per chunk and merged when using several threads
+    if (isAdaptive()) {
+        return;
+    }
+    // (the BlockSplitter counts the histogram of each of its blocks instead, which are then added up), along with the
+    // frequencies of every pair of characters when context tables may be used, in the same pass over the file
+    bool splitBlocks{compressionOptions.splitBlocks};
+    bool countContexts{compressionOptions.contextTables};
+    if (isParallel()) {
+        countFrequenciesParallel(input, compressionOptions.threadCount, compressionOptions.histogramEngine,
+                                 frequencyChunks, histogram, splitBlocks, countContexts ? &contextHistogram : nullptr);
+        for (const FrequencyChunk& chunk : frequencyChunks) {
+            blockSplitter.append(chunk.splitter);
+        }
+        blockSplitter.mergeBlocks();
+        return;
+    }
 
-    // construct all data members
-    compress(input, destination);
+    // count each block where it is (the block buffer is only used when the file is not mapped)
+    std::vector<uint8_t> block{};
+    const uint8_t* data{nullptr};
+    uint64_t position{0};
+    uint8_t previous{0};
+    while (std::size_t size{input.view(position, ByteHistogram::READ_BLOCK_SIZE, data, block)}) {
+        if (splitBlocks) {
+            blockSplitter.count(data, size);
+        } else {
+            histogram.count(data, size);
+        }
+        if (countContexts) {
+            previous = contextHistogram.count(data, size, previous);
+        }
+        input.release(position, size);
+        position += size;
+    }
+    if (splitBlocks) {
+        blockSplitter.finish();
+        blockSplitter.total(histogram);
+    }
 }
 
-std::string HuffmanTree::compress(std::ifstream& input, const std::string& destination) {
-    // generate data members
-    generate(input);
+void HuffmanTree::build() {
+    buildTree();
+    buildTable();
+}
+
+void HuffmanTree::buildTree() {
+    if (isAdaptive()) {
+        return;
+    }
+
+    // build Huffman Tree with the selected engine
+    huffmanTreeRoot = TreeBuilder::build(compressionOptions.treeBuilderEngine, histogram, huffmanTreeNodes);
+}
+
+void HuffmanTree::buildTable() {
+    if (isAdaptive()) {
+        return;
+    }
+
+    // generate encoding table, limiting the length of the codes if any is longer than the maximum
+    generateEncodingTable(encodingTable, huffmanTreeNodes, huffmanTreeRoot);
+    if (compressionOptions.maxCodeLength != 0) {
+        limitCodeLengths();
+    }
+
+    // reassign the codes in canonical order when only their lengths are written
+    if (compressionOptions.canonicalCodes) {
+        generateCanonicalEncodingTable(encodingTable);
+    }
+
+    // find the smallest dictionary, and build the tables of every block and then context tables, each of which is only
+    // kept when the file is smaller with it than with the single table (and whatever was kept before it)
+    const DictionaryCache* dictionaries{compressionOptions.dictionaries};
+    if (dictionaries != nullptr || compressionOptions.splitBlocks || compressionOptions.contextTables) {
+        PackedBits lengthTable{};
+        generateCodeLengthTable(lengthTable, encodingTable);
+        uint64_t smallestBits{lengthTable.bitLength};
+        for (std::size_t character{0}; character < encodingTable.size(); ++character) {
+            smallestBits += histogram.frequencies[character] * encodingTable[character].length;
+        }
+
+        uint64_t dictionaryBits{0};
+        const Dictionary* smallest{dictionaries == nullptr ? nullptr : dictionaries->findSmallest(histogram,
+                                                                                                  dictionaryBits)};
+        if (smallest != nullptr && dictionaryBits + Dictionary::ID_BITS < smallestBits) {
+            dictionary = smallest;
+            encodingTable = dictionary->getEncodingTable();
+            lengthLimitCost = 0;
+            smallestBits = dictionaryBits + Dictionary::ID_BITS;
+        }
+
+        TreeBuilderEngine engine{compressionOptions.treeBuilderEngine};
+        if (compressionOptions.splitBlocks &&
+            blockSplitter.build(engine, compressionOptions.maxCodeLength, smallestBits)) {
+            smallestBits = blockSplitter.getTotalBits();
+            dictionary = nullptr;
+        }
+        if (compressionOptions.contextTables &&
+            contextModel.build(contextHistogram, engine, compressionOptions.maxCodeLength, smallestBits)) {
+            blockSplitter.clearTables();
+            dictionary = nullptr;
+        }
+    }
+}
+
+void HuffmanTree::encode(InputSource& input) {
+    // generate each section
+    generateFileInfoCode(fileInformation, huffmanFileInfoCode);
+    if (isAdaptive()) {
+        huffmanTreeRepresentation.clear();
+        encodeInOrder(input, HuffmanHeader::ADAPTIVE);
+        return;
+    }
+    if (isContextual()) {
+        generateContextTables(huffmanTreeRepresentation, contextModel);
+        encodeInOrder(input, HuffmanHeader::CANONICAL | HuffmanHeader::CONTEXT);
+        return;
+    }
+    if (isSplit()) {
+        generateBlockTables(huffmanTreeRepresentation, blockSplitter);
+        encodeInOrder(input, HuffmanHeader::CANONICAL | HuffmanHeader::SPLIT);
+        return;
+    }
+    uint64_t flags{HuffmanHeader::CHECKSUM | (compressionOptions.canonicalCodes ? HuffmanHeader::CANONICAL : 0)};
+    if (dictionary != nullptr) {
+        generateDictionaryId(huffmanTreeRepresentation, *dictionary);
+        flags = HuffmanHeader::CHECKSUM | HuffmanHeader::CANONICAL | HuffmanHeader::DICTIONARY;
+    } else if (compressionOptions.canonicalCodes) {
+        generateCodeLengthTable(huffmanTreeRepresentation, encodingTable);
+    } else {
+        generateHuffmanTreeRepresentation(huffmanTreeRepresentation, huffmanTreeNodes, huffmanTreeRoot);
+    }
 
+    // in streaming mode the Huffman Code is generated block by block as the file is written
+    if (compressionOptions.streaming) {
+        huffmanCode.clear();
+        generateHuffmanHeader(huffmanHeader, flags | HuffmanHeader::STREAMED, input.size(),
+                              huffmanFileInfoCode.bitLength, huffmanTreeRepresentation.bitLength, 0);
+        return;
+    }
+
+    // the single table may also be split between interleaved streams, if its longest code leaves enough characters for
+    // every refill of the streams
+    unsigned streamCount{InterleavedStreams::chooseStreamCount(encodingTable, compressionOptions.interleavedStreams)};
+    if (streamCount > 1) {
+        flags |= HuffmanHeader::INTERLEAVED;
+        if (isParallel()) {
+            generateInterleavedHuffmanCodeParallel(input, compressionOptions.threadCount, encodingTable, streamCount,
+                                                   huffmanCode, compressionOptions.blockIndexSize, blockIndex,
+                                                   checksum);
+        } else {
+            generateInterleavedHuffmanCode(input, encodingTable, streamCount, huffmanCode,
+                                           compressionOptions.blockIndexSize, blockIndex, checksum);
+        }
+    } else if (isParallel()) {
+        generateHuffmanCodeParallel(input, compressionOptions.threadCount, frequencyChunks, encodingTable, huffmanCode,
+                                    compressionOptions.blockIndexSize, blockIndex, checksum);
+    } else {
+        generateHuffmanCode(input, encodingTable, huffmanCode, compressionOptions.blockIndexSize, blockIndex,
+                            checksum);
+    }
+
+    // generate the header from each section
+    if (!blockIndex.empty()) {
+        flags |= HuffmanHeader::BLOCK_INDEX;
+    }
+    generateHuffmanHeader(huffmanHeader, flags, blockIndex.originalSize,
+                          huffmanFileInfoCode.bitLength, huffmanTreeRepresentation.bitLength, huffmanCode.bitLength);
+}
+
+std::string HuffmanTree::write(InputSource& input, const std::string& destination) {
 #if defined(_WIN32)
     char slash = '\\';
 #else
     char slash = '/';
 #endif
 
-    // write the compressed file
+    // write the compressed file, removing whatever was written of it if writing failed
     std::string compressedFilePath{destination + slash + fileInformation.fileName + ".hzip"};
-    writeCompressedFile(compressedFilePath, huffmanHeader, huffmanFileInfoCode, huffmanTreeRepresentation, huffmanCode);
+    std::ofstream output{compressedFilePath, std::ios::out | std::ios::binary}; // write in binary mode
+    if (!output) {
+        return "";
+    }
+    bool written{write(input, output)};
+    output.close();
+    if (!written || output.fail()) {
+        removeFile(compressedFilePath);
+        return "";
+    }
 
     return compressedFilePath;
 }
 
-void HuffmanTree::generate(std::ifstream& input) {
-    // generate encoding table
-    std::unordered_map<std::optional<char>, std::string> encodingTable{};
-    generateEncodingTable(encodingTable, huffmanTreeRoot);
+bool HuffmanTree::write(InputSource& input, std::ostream& output) {
+    if (compressionOptions.streaming) {
+        BlockEncoder blockEncoder{[this](const uint8_t* data, std::size_t size, BitWriter& writer) {
+            encodeBlock(data, size, writer);
+        }};
+        writeStreamedCompressedFile(output, huffmanHeader, huffmanFileInfoCode, huffmanTreeRepresentation, input,
+                                    blockEncoder, compressionOptions.streamBlockSize);
+    } else {
+        writeCompressedFile(output, huffmanHeader, huffmanFileInfoCode, huffmanTreeRepresentation, huffmanCode,
+                            checksum, blockIndex);
+    }
 
-    // generate each section
-    generateFileInfoCode(fileInformation, huffmanFileInfoCode);
-    generateHuffmanTreeRepresentation(huffmanTreeRepresentation, huffmanTreeRoot);
-    generateHuffmanCode(input, encodingTable, huffmanCode);
+    return !output.fail();
+}
 
-    // generate the header from each section
-    generateHuffmanHeader(huffmanHeader, huffmanFileInfoCode.length(), huffmanTreeRepresentation.length(),
-                          huffmanCode.length());
+void HuffmanTree::limitCodeLengths() {
+    // the Huffman Tree is kept when none of its codes is too long, as it is already the shortest Huffman Code
+    uint8_t longestLength{0};
+    for (const HuffmanCodeword& codeword : encodingTable) {
+        longestLength = std::max(longestLength, codeword.length);
+    }
+    if (longestLength <= compressionOptions.maxCodeLength) {
+        return;
+    }
+
+    // replace every code length, noting how many more bits the Huffman Code takes with the limited lengths
+    PackageMerge packageMerge{histogram, compressionOptions.maxCodeLength};
+    uint64_t unlimitedBits{0};
+    uint64_t limitedBits{0};
+    for (std::size_t character{0}; character < encodingTable.size(); ++character) {
+        uint64_t frequency{histogram.frequencies[character]};
+        unlimitedBits += frequency * encodingTable[character].length;
+        limitedBits += frequency * packageMerge.getCodeLengths()[character];
+        encodingTable[character].length = packageMerge.getCodeLengths()[character];
+    }
+    lengthLimitCost = limitedBits - unlimitedBits;
+
+    // the codes no longer match the Huffman Tree, so they can only be written as canonical codes
+    compressionOptions.canonicalCodes = true;
 }
 
-std::string HuffmanTree::decompress(std::ifstream& input, const std::string& destination) {
-    // read and instantiate huffmanHeader, huffmanFileInfoCode, huffmanTreeRepresentation, and huffmanCode.
-    readCompressedFile(input, huffmanHeader, huffmanFileInfoCode, huffmanTreeRepresentation, huffmanCode);
+bool HuffmanTree::isParallel() const {
+    return compressionOptions.threadCount > 1 && !compressionOptions.streaming && !isAdaptive();
+}
+
+bool HuffmanTree::isAdaptive() const {
+    return compressionOptions.codingEngine == CodingEngine::ADAPTIVE;
+}
+
+bool HuffmanTree::isContextual() const {
+    return contextModel.getTableCount() != 0;
+}
+
+bool HuffmanTree::isSplit() const {
+    return blockSplitter.getTableCount() != 0;
+}
+
+void HuffmanTree::encodeInOrder(InputSource& input, uint64_t flags) {
+    flags |= HuffmanHeader::CHECKSUM;
+
+    // in streaming mode the Huffman Code is generated block by block as the file is written
+    if (compressionOptions.streaming) {
+        huffmanCode.clear();
+        generateHuffmanHeader(huffmanHeader, flags | HuffmanHeader::STREAMED, input.size(),
+                              huffmanFileInfoCode.bitLength, huffmanTreeRepresentation.bitLength, 0);
+        return;
+    }
+
+    // with several threads, every chunk of the file is encoded from the character before it (or the block holding
+    // its first character)
+    blockIndex.previousCharacters = isContextual();
+    if (isParallel()) {
+        if (isContextual()) {
+            generateHuffmanCodeParallel(input, compressionOptions.threadCount, contextModel, huffmanCode,
+                                        compressionOptions.blockIndexSize, blockIndex, checksum);
+        } else {
+            generateHuffmanCodeParallel(input, compressionOptions.threadCount, blockSplitter, huffmanCode,
+                                        compressionOptions.blockIndexSize, blockIndex, checksum);
+        }
+        if (!blockIndex.empty()) {
+            flags |= HuffmanHeader::BLOCK_INDEX;
+        }
+        generateHuffmanHeader(huffmanHeader, flags, blockIndex.originalSize, huffmanFileInfoCode.bitLength,
+                              huffmanTreeRepresentation.bitLength, huffmanCode.bitLength);
+        return;
+    }
+
+    // otherwise encode the whole file in a single pass, releasing each block once encoded
+    huffmanCode.clear();
+    BitWriter writer{huffmanCode};
+    std::vector<uint8_t> block{};
+    const uint8_t* data{nullptr};
+    uint64_t position{0};
+    checksum = 0;
 
-    // reconstruct fileInformation and huffmanTreeRoot
-    instantiate();
+    // a sync point is recorded every blockIndexSize bytes, along with the character before it for context tables
+    // (the adaptive tree cannot be recreated at a sync point, so an adaptive file has no block index)
+    uint64_t blockIndexSize{isAdaptive() ? 0 : compressionOptions.blockIndexSize};
+    uint64_t nextSyncPoint{0};
+    uint8_t previous{0};
+    blockIndex.entries.clear();
+    while (std::size_t count{input.view(position, compressionOptions.streamBlockSize, data, block)}) {
+        checksum = updateCrc32c(checksum, data, count);
+        for (std::size_t done{0}; done < count;) {
+            std::size_t part{count - done};
+            if (blockIndexSize != 0) {
+                if (position + done == nextSyncPoint) {
+                    BlockIndexEntry entry{};
+                    entry.bitOffset = writer.bitCount();
+                    entry.outputOffset = nextSyncPoint;
+                    entry.previous = previous;
+                    blockIndex.entries.push_back(entry);
+                    nextSyncPoint += blockIndexSize;
+                }
+                part = static_cast<std::size_t>(std::min<uint64_t>(part, nextSyncPoint - (position + done)));
+            }
+            encodeBlock(data + done, part, writer);
+            done += part;
+            previous = data[done - 1];
+        }
+        input.release(position, count);
+        position += count;
+    }
+    writer.flush();
+    blockIndex.originalSize = position;
+
+    if (!blockIndex.empty()) {
+        flags |= HuffmanHeader::BLOCK_INDEX;
+    }
+    generateHuffmanHeader(huffmanHeader, flags, position, huffmanFileInfoCode.bitLength,
+                          huffmanTreeRepresentation.bitLength, huffmanCode.bitLength);
+}
+
+void HuffmanTree::encodeBlock(const uint8_t* data, std::size_t size, BitWriter& writer) {
+    if (isAdaptive()) {
+        adaptiveHuffman.encode(data, size, writer);
+    } else if (isContextual()) {
+        contextModel.encode(data, size, writer);
+    } else if (isSplit()) {
+        blockSplitter.encode(data, size, writer);
+    } else {
+        generateHuffmanCodeBlock(data, size, encodingTable, writer);
+    }
+}
+
+std::string HuffmanTree::decompress(InputSource& input, const std::string& destination,
+                                    const CompressionOptions& options) {
+    reset();
+
+    // read and instantiate huffmanHeader, huffmanFileInfoCode, and huffmanTreeRepresentation, noting where the
+    // Huffman Code begins. an empty path is returned when the file is not a valid compressed file
+    uint64_t encodingPosition{0};
+    if (!readCompressedFile(input, huffmanHeader, huffmanFileInfoCode, huffmanTreeRepresentation, encodingPosition)) {
+        return "";
+    }
+    if (huffmanHeader.hasFlag(HuffmanHeader::PIPED)) {
+        std::cout << "Error: File is a piped stream, which can only be decompressed with -dc.\n";
+        return "";
+    }
+
+    // find the dictionary the file was encoded with, whose codes are not part of the file
+    if (huffmanHeader.hasFlag(HuffmanHeader::DICTIONARY) && !findDictionary(options.dictionaries)) {
+        return "";
+    }
+
+    // reconstruct fileInformation and the encoding table (or the context tables)
+    if (!instantiate(options.decodingTableBits)) {
+        std::cout << "Corrupted Code Length Table Error\n";
+        return "";
+    }
 
 #if defined(_WIN32)
     char slash = '\\';
@@ -70,19 +443,381 @@ std::string HuffmanTree::decompress(std::ifstream& input, const std::string& des
     char slash = '/';
 #endif
 
-    // write the original file
+    // write the original file under a temporary name, which only takes the place of the decompressed file once the
+    // checksum matches, so that a corrupted file leaves nothing behind
     std::string decompressedFilePath = destination + slash + fileInformation.fileName + "-decompressed" +
         fileInformation.fileExtension;
-    // write decompressed file
-    writeDecompressedFile(decompressedFilePath, huffmanTreeRoot, huffmanCode);
+    std::string partialFilePath{decompressedFilePath + ".part"};
+    auto finish{[&](bool decompressed) -> std::string {
+        if (decompressed && renameFile(partialFilePath, decompressedFilePath)) {
+            return decompressedFilePath;
+        }
+        if (decompressed) {
+            std::cout << "Write Decompressed File Error\n";
+        }
+        removeFile(partialFilePath);
+        return "";
+    }};
+
+    // build the decoding table from the encoding table, unless the codes are adaptive, depend on the context, or
+    // change from block to block (a dictionary already holds its own decoding table)
+    bool adaptive{huffmanHeader.hasFlag(HuffmanHeader::ADAPTIVE)};
+    bool contextual{huffmanHeader.hasFlag(HuffmanHeader::CONTEXT)};
+    bool split{huffmanHeader.hasFlag(HuffmanHeader::SPLIT)};
+    bool interleaved{huffmanHeader.hasFlag(HuffmanHeader::INTERLEAVED)};
+    std::optional<DecodingTable> fileDecodingTable{};
+    if (dictionary == nullptr) {
+        fileDecodingTable.emplace(encodingTable, options.decodingTableBits);
+    }
+    const DecodingTable& decodingTable{dictionary != nullptr ? dictionary->getDecodingTable() : *fileDecodingTable};
+    InterleavedStreams interleavedStreams{decodingTable};
+    SectionDecoder decoder{[&](std::ostream& output, const BitSpan& encoding, std::vector<uint8_t>& buffer,
+                               uint32_t& sectionChecksum) {
+        if (adaptive) {
+            return decodeSection(output, adaptiveHuffman, encoding, buffer, sectionChecksum);
+        }
+        if (contextual) {
+            return decodeSection(output, contextModel, encoding, buffer, sectionChecksum);
+        }
+        if (split) {
+            return decodeSection(output, blockSplitter, encoding, buffer, sectionChecksum);
+        }
+        return interleaved ? decodeSection(output, interleavedStreams, encoding, buffer, sectionChecksum)
+                           : decodeSection(output, decodingTable, encoding, buffer, sectionChecksum);
+    }};
+
+    // write decompressed file, reading the rest of the Huffman Code block by block if it was streamed,
+    // or decoding the indexed blocks in parallel if the file has a block index
+    if (huffmanHeader.hasFlag(HuffmanHeader::STREAMED)) {
+        bool decoded{writeStreamedDecompressedFile(partialFilePath, decoder, input, encodingPosition, checksum)};
+        return finish(decoded && verifyChecksum(input, encodingPosition));
+    }
+
+    // view the Huffman Code in place, which only copies it into huffmanCode when the file is not mapped
+    const uint8_t* data{nullptr};
+    auto byteLength{static_cast<std::size_t>((huffmanHeader.encodingLength + 7) / 8)};
+    byteLength = input.view(encodingPosition, byteLength, data, huffmanCode.bytes);
+    BitSpan encoding{data, byteLength, huffmanHeader.encodingLength};
+    bool decoded{false};
+    if (!adaptive && options.threadCount > 1 && huffmanHeader.hasFlag(HuffmanHeader::BLOCK_INDEX) &&
+        readBlockIndex(input, blockIndex, contextual) && !blockIndex.empty()) {
+        if (contextual) {
+            decoded = decodeParallel(partialFilePath, options.threadCount, contextModel, encoding, blockIndex,
+                                     checksum);
+        } else if (split) {
+            decoded = decodeParallel(partialFilePath, options.threadCount, blockSplitter, encoding, blockIndex,
+                                     checksum);
+        } else if (interleaved) {
+            decoded = decodeParallel(partialFilePath, options.threadCount, interleavedStreams, encoding, blockIndex,
+                                     checksum);
+        } else {
+            decoded = decodeParallel(partialFilePath, options.threadCount, decodingTable, encoding, blockIndex,
+                                     checksum);
+        }
+        if (!decoded) {
+            std::cout << "Corrupted Huffman Code Error\n";
+        }
+    } else {
+        decoded = writeDecompressedFile(partialFilePath, decoder, encoding, checksum);
+    }
+
+    // the checksum follows the Huffman Code
+    uint64_t checksumPosition{encodingPosition + byteLength};
+    return finish(decoded && verifyChecksum(input, checksumPosition));
+}
+
+bool HuffmanTree::decompressRange(InputSource& input, uint64_t offset, uint64_t length, std::vector<uint8_t>& output,
+                                  const CompressionOptions& options) {
+    reset();
+    output.clear();
+
+    // read and instantiate the first sections exactly as decompress does
+    uint64_t encodingPosition{0};
+    if (!readCompressedFile(input, huffmanHeader, huffmanFileInfoCode, huffmanTreeRepresentation, encodingPosition)) {
+        return false;
+    }
+    if (huffmanHeader.hasFlag(HuffmanHeader::PIPED)) {
+        std::cout << "Error: File is a piped stream, which can only be decompressed with -dc.\n";
+        return false;
+    }
+    if (huffmanHeader.version == 1) {
+        std::cout << "Error: File is a version 1 file, which does not record its original size and can only be "
+                     "decompressed as a whole.\n";
+        return false;
+    }
+    if (huffmanHeader.hasFlag(HuffmanHeader::DICTIONARY) && !findDictionary(options.dictionaries)) {
+        return false;
+    }
+    if (!instantiate(options.decodingTableBits)) {
+        std::cout << "Corrupted Code Length Table Error\n";
+        return false;
+    }
+
+    // the range ends at the end of the original file. every character takes at least a bit, so a range is never
+    // longer than the Huffman Code either
+    bool streamed{huffmanHeader.hasFlag(HuffmanHeader::STREAMED)};
+    offset = std::min(offset, huffmanHeader.originalSize);
+    length = std::min(length, huffmanHeader.originalSize - offset);
+    uint64_t encodingBits{streamed ? (input.size() > encodingPosition ? input.size() - encodingPosition : 0) * 8
+                                   : huffmanHeader.encodingLength};
+    length = std::min(length, encodingBits);
+    output.resize(static_cast<std::size_t>(length));
+    DecodedRange range{offset, output.data(), length};
+
+    bool adaptive{huffmanHeader.hasFlag(HuffmanHeader::ADAPTIVE)};
+    bool contextual{huffmanHeader.hasFlag(HuffmanHeader::CONTEXT)};
+    bool split{huffmanHeader.hasFlag(HuffmanHeader::SPLIT)};
+    bool interleaved{huffmanHeader.hasFlag(HuffmanHeader::INTERLEAVED)};
+    std::optional<DecodingTable> fileDecodingTable{};
+    if (dictionary == nullptr) {
+        fileDecodingTable.emplace(encodingTable, options.decodingTableBits);
+    }
+    const DecodingTable& decodingTable{dictionary != nullptr ? dictionary->getDecodingTable() : *fileDecodingTable};
+    InterleavedStreams interleavedStreams{decodingTable};
+    RangeDecoder decoder{[&](const BitSpan& encoding, uint64_t bitOffset, DecodedRange& decodedRange,
+                             std::vector<uint8_t>& buffer) {
+        if (adaptive) {
+            return decodeRange(adaptiveHuffman, encoding, bitOffset, decodedRange, buffer);
+        }
+        if (contextual) {
+            return decodeRange(contextModel, encoding, bitOffset, decodedRange, buffer);
+        }
+        if (split) {
+            return decodeRange(blockSplitter, encoding, bitOffset, decodedRange, buffer);
+        }
+        return interleaved ? decodeRange(interleavedStreams, encoding, bitOffset, decodedRange, buffer)
+                           : decodeRange(decodingTable, encoding, bitOffset, decodedRange, buffer);
+    }};
+
+    // a streamed file has no sync points, so its blocks are decoded from the first until the range is filled
+    bool decoded{false};
+    if (streamed) {
+        decoded = range.done() || decodeStreamedRange(decoder, input, encodingPosition, range);
+    } else {
+        const uint8_t* data{nullptr};
+        auto byteLength{static_cast<std::size_t>((huffmanHeader.encodingLength + 7) / 8)};
+        byteLength = input.view(encodingPosition, byteLength, data, huffmanCode.bytes);
+        BitSpan encoding{data, byteLength, huffmanHeader.encodingLength};
+
+        // otherwise decoding starts at the last sync point at or before the range, if the file has a block index
+        uint64_t bitOffset{0};
+        bool indexed{huffmanHeader.hasFlag(HuffmanHeader::BLOCK_INDEX)};
+        if (!range.done() && !adaptive && indexed && readBlockIndex(input, blockIndex, contextual)) {
+            auto syncPoint{std::upper_bound(blockIndex.entries.begin(), blockIndex.entries.end(), offset,
+                                            [](uint64_t value, const BlockIndexEntry& entry) {
+                                                return value < entry.outputOffset;
+                                            })};
+            if (syncPoint != blockIndex.entries.begin()) {
+                const BlockIndexEntry& entry{*(syncPoint - 1)};
+                bitOffset = entry.bitOffset;
+                range.skip = offset - entry.outputOffset;
+                if (contextual) {
+                    contextModel.seek(entry.previous);
+                }
+                if (split && !blockSplitter.seek(entry.outputOffset)) {
+                    bitOffset = encoding.bitLength + 1; // past the end, which is rejected as corrupted
+                }
+            }
+        }
+        std::vector<uint8_t> buffer(DECODE_BUFFER_SIZE);
+        decoded = range.done() || decoder(encoding, bitOffset, range, buffer);
+    }
+
+    // the range lies within the original file, so the file is corrupted when it ends before the range does
+    if (!decoded || !range.done()) {
+        std::cout << "Corrupted Huffman Code Error\n";
+        output.clear();
+        return false;
+    }
+    output.resize(static_cast<std::size_t>(length - range.remaining));
+    return true;
+}
+
+bool HuffmanTree::compressPiped(InputSource& input, std::ostream& output, const CompressionOptions& options) {
+    // every block is compressed as a whole file would be, always with canonical codes in a single stream and without a
+    // block index, except that the adaptive tree carries on from one block to the next
+    CompressionOptions blockOptions{options};
+    blockOptions.streaming = false;
+    blockOptions.canonicalCodes = true;
+    blockOptions.blockIndexSize = 0;
+    blockOptions.contextTables = false;
+    blockOptions.splitBlocks = false;
+    blockOptions.dictionaries = nullptr;
+    blockOptions.interleavedStreams = 1;
+    std::size_t blockSize{std::clamp<std::size_t>(options.streamBlockSize, 1, MAX_PIPED_BLOCK_SIZE)};
+    reset("", "", blockOptions);
 
-    return decompressedFilePath;
+    HuffmanHeader streamHeader{0, 0, 0};
+    streamHeader.flags = HuffmanHeader::PIPED | HuffmanHeader::CHECKSUM |
+        (isAdaptive() ? HuffmanHeader::ADAPTIVE : HuffmanHeader::CANONICAL);
+    writeHeader(output, streamHeader);
+
+    // each block is read into the same buffer, which the block's own InputSource views in place, and the checksum of
+    // each block encoded on its own is added to that of the stream
+    std::vector<uint8_t> block{};
+    const uint8_t* data{nullptr};
+    uint64_t position{0};
+    uint32_t streamChecksum{0};
+    while (std::size_t count{input.view(position, blockSize, data, block)}) {
+        if (isAdaptive()) {
+            streamChecksum = updateCrc32c(streamChecksum, data, count);
+            huffmanCode.clear();
+            BitWriter writer{huffmanCode};
+            adaptiveHuffman.encode(data, count, writer);
+            writer.flush();
+        } else {
+            InputSource blockInput{data, count};
+            reset("", "", blockOptions);
+            scan(blockInput);
+            build();
+            encode(blockInput);
+            streamChecksum = combineCrc32c(streamChecksum, checksum, count);
+        }
+        writePipedBlock(output, count, huffmanTreeRepresentation, huffmanCode);
+        if (!output) {
+            return false;
+        }
+
+        position += count;
+    }
+
+    // a block with an original size of 0 terminates the stream, followed by the checksum of the whole stream
+    writeBlockLength(output, 0);
+    writeChecksum(output, streamChecksum);
+    return static_cast<bool>(output);
 }
 
-void HuffmanTree::instantiate() {
+bool HuffmanTree::decompressPiped(InputSource& input, std::ostream& output, const CompressionOptions& options) {
+    reset();
+
+    uint64_t position{0};
+    if (!readHeader(input, position, huffmanHeader)) {
+        return false;
+    }
+    if (!huffmanHeader.hasFlag(HuffmanHeader::PIPED)) {
+        std::cout << "Error: Stream is a compressed file rather than a piped stream.\n";
+        return false;
+    }
+
+    // read, instantiate and decode one block at a time until the terminating block (the adaptive tree is instantiated
+    // only once, as it carries on from one block to the next)
+    bool adaptive{huffmanHeader.hasFlag(HuffmanHeader::ADAPTIVE)};
+    if (adaptive) {
+        instantiate(options.decodingTableBits);
+    }
+    std::vector<uint8_t> buffer(DECODE_BUFFER_SIZE);
+    checksum = 0;
+    while (true) {
+        uint64_t originalSize{0};
+        uint64_t encodingLength{0};
+        if (!readPipedBlock(input, position, originalSize, huffmanTreeRepresentation, encodingLength)) {
+            std::cout << "Truncated or Corrupted Stream Error\n";
+            return false;
+        }
+        if (originalSize == 0) {
+            return verifyChecksum(input, position) && static_cast<bool>(output);
+        }
+
+        if (!adaptive && !instantiate(options.decodingTableBits)) {
+            std::cout << "Corrupted Code Length Table Error\n";
+            return false;
+        }
+        DecodingTable decodingTable{encodingTable, options.decodingTableBits};
+
+        const uint8_t* data{nullptr};
+        auto byteLength{static_cast<std::size_t>((encodingLength + 7) / 8)};
+        if (input.view(position, byteLength, data, huffmanCode.bytes) < byteLength) {
+            std::cout << "Truncated or Corrupted Stream Error\n";
+            return false;
+        }
+        BitSpan encoding{data, byteLength, encodingLength};
+        bool decoded{adaptive ? decodeSection(output, adaptiveHuffman, encoding, buffer, checksum)
+                              : decodeSection(output, decodingTable, encoding, buffer, checksum)};
+        if (!decoded) {
+            std::cout << "Corrupted Huffman Code Error\n";
+            return false;
+        }
+        if (!output) {
+            return false;
+        }
+
+        position += byteLength;
+    }
+}
+
+bool HuffmanTree::instantiate(unsigned decodingTableBits) {
     // post-condition: fileInformation has fileName and fileExtension
     instantiateFileInformation(fileInformation, huffmanFileInfoCode);
-    // post-condition: huffmanTreeRoot has the original Huffman Tree
-    int position{0};
-    huffmanTreeRoot = instantiateHuffmanTree(huffmanTreeRepresentation, position);
+    BitReader representationReader{huffmanTreeRepresentation};
+
+    // post-condition: adaptiveHuffman is the empty tree the encoder started from
+    if (huffmanHeader.hasFlag(HuffmanHeader::ADAPTIVE)) {
+        adaptiveHuffman.reset();
+        return true;
+    }
+
+    // post-condition: contextModel has the canonical codes and decoding table of every cluster of contexts
+    if (huffmanHeader.hasFlag(HuffmanHeader::CONTEXT)) {
+        return instantiateContextModel(contextModel, representationReader, decodingTableBits);
+    }
+
+    // post-condition: blockSplitter has the size, canonical codes and decoding table of every block
+    if (huffmanHeader.hasFlag(HuffmanHeader::SPLIT)) {
+        return instantiateBlockSplitter(blockSplitter, representationReader, decodingTableBits);
+    }
+
+    // post-condition: encodingTable has the canonical codes of the dictionary found by findDictionary
+    if (huffmanHeader.hasFlag(HuffmanHeader::DICTIONARY)) {
+        if (dictionary == nullptr) {
+            return false;
+        }
+        encodingTable = dictionary->getEncodingTable();
+        return true;
+    }
+
+    // post-condition: encodingTable has the canonical codes, without a Huffman Tree being created
+    if (huffmanHeader.hasFlag(HuffmanHeader::CANONICAL)) {
+        return instantiateCanonicalEncodingTable(encodingTable, representationReader);
+    }
+
+    // post-condition: huffmanTreeRoot has the original Huffman Tree, and encodingTable its codes
+    huffmanTreeRoot = instantiateHuffmanTree(representationReader, huffmanTreeNodes);
+    generateEncodingTable(encodingTable, huffmanTreeNodes, huffmanTreeRoot);
+    return true;
+}
+
+bool HuffmanTree::verifyChecksum(InputSource& input, uint64_t position) {
+    // files written before checksums were added have nothing to compare with
+    if (!huffmanHeader.hasFlag(HuffmanHeader::CHECKSUM)) {
+        return true;
+    }
+
+    uint32_t storedChecksum{0};
+    if (!readChecksum(input, position, storedChecksum)) {
+        std::cout << "Error: Compressed data is truncated, as its checksum is missing.\n";
+        return false;
+    }
+    if (storedChecksum != checksum) {
+        std::cout << "Checksum Mismatch Error: The decompressed file differs from the original file.\n";
+        return false;
+    }
+    return true;
+}
+
+bool HuffmanTree::findDictionary(const DictionaryCache* dictionaries) {
+    // the Tree Representation section holds only the ID of the dictionary
+    BitReader representationReader{huffmanTreeRepresentation};
+    if (representationReader.remaining() < Dictionary::ID_BITS) {
+        std::cout << "Corrupted Code Length Table Error\n";
+        return false;
+    }
+
+    uint32_t id{readUInt32(representationReader)};
+    dictionary = dictionaries == nullptr ? nullptr : dictionaries->find(id);
+    if (dictionary == nullptr) {
+        std::cout << "Error: File was compressed with dictionary " << Dictionary::formatId(id)
+            << ", which was not given.\n";
+        return false;
+    }
+    return true;
 }
@@ -20,9 +20,11 @@
 
 // [Header] > [File Information Code] > [Tree Representation] > [Huffman Code]
 
-// First is a Header section containing three 32-bit unsigned integer values
-// corresponding to the true byte lengths of the other three sections. Other strategies for section delimiting
-// include tagging and using special character sequences, but a header section is more convenient.
+// First is a Header section containing the magic bytes "HZIP", a version number and feature flags, the size of the
+// original file, and the true bit lengths of the other three sections as variable-length integers (see HuffmanHeader,
+// which also describes what each flag adds, such as the checksum and BlockIndex after the Huffman Code). Other
+// strategies for section delimiting include tagging and using special character sequences, but a header section is
+// more convenient.
 
 // Second is the File Information Code section which is simply the ASCII byte sequence for the file name and extension
 // inclusive of the period. This can be seen using a hex dump tool such as xxd on Linux/macOS. This section will
@@ -32,7 +34,8 @@
 // tree in a preorder manner and for every non-leaf node (with no value), record a 1; for every leaf node (which has
 // a value), record a 0 then the 8-bit representation of node's value. Weight is not needed in the reconstruction of
 // the Huffman Tree, therefore it is not stored. Because this section can result in a count of bits not divisible by 8
-// (as computers typically read), padding of 0s may be added at the end.
+// (as computers typically read), padding of 0s may be added at the end. With canonical codes (the default), this
+// section holds only the code length of every character instead (see generateCanonicalEncodingTable).
 
 // Last is the Huffman Code section. This section may also have a padding of 0s at the end due to possible count of
 // bits not divisible by 8.
@@ -40,17 +43,29 @@
 /* Main Program Loop */
 
 // When compressing a file, the constructor with parameters is called. details in fileInformation and the Huffman Tree
-// is created. Afterward, compress is called, which generates the rest of data members (using generate) and writes
-// those data members to file.
+// is created. Afterward, compress is called, which generates the rest of data members and writes those data members
+// to file. The four stages of compression are public so that a CompressionSession can run and time each of them:
+// scan counts the histogram, build creates the Huffman Tree and its encoding table, encode generates the sections,
+// and write writes them to file (returning an empty path if it could not).
 
 // When decompressing a file, the default constructor is called to instantiate an initial object. The decompress
 // function is then manually called, which first reads from the compressed file to populate data members, and then
-// instantiates fileInformation and the Huffman Tree. Lastly, written to file is the original file.
+// instantiates fileInformation and the encoding table. Lastly, written to file is the original file, and an empty
+// path is returned instead if the file is rejected, corrupted, or does not match its checksum. decompressRange
+// decodes only a range of the original file into a buffer, from the sync point of the BlockIndex before the range.
 
 /* Other Implementation Notes */
 
+// The options (see CompressionOptions) decide how the file is encoded: with a single table, an AdaptiveHuffman tree,
+// a ContextModel, a BlockSplitter or a Dictionary (each kept by buildTable only when it makes the file smaller), with
+// a single table split between InterleavedStreams, in streaming mode one block at a time, and with several threads
+// (see parallel_utils). compressPiped and decompressPiped do the same between streams such as stdin and stdout.
+
+// The nodes of the Huffman Tree are kept in a HuffmanNodeArena, and reset clears the object for another file while
+// keeping the memory it already holds, so a single HuffmanTree can compress or decompress any number of files.
+
 // The unused .hzip extension is used for the compressed file, and when decompressed, the original file name is appended
-// with "-decompressed".
+// with "-decompressed". The file is first written with ".part" appended and only renamed once its checksum matches.
 
 // The Header and File Information Code sections are sectioned into auxiliary classes, HuffmanHeader and FileInformation
 // respectively.
@@ -59,36 +74,113 @@
 #define HUFFMAN_TREE_H
 
 
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
 #include <string>
+#include <vector>
 
 #include "HuffmanNode.h"
+#include "huffman_tree/adaptive/AdaptiveHuffman.h"
+#include "huffman_tree/bit_stream/BitWriter.h"
+#include "huffman_tree/bit_stream/PackedBits.h"
+#include "huffman_tree/block_splitter/BlockSplitter.h"
+#include "huffman_tree/components/BlockIndex.h"
+#include "huffman_tree/components/CompressionOptions.h"
 #include "huffman_tree/components/FileInformation.h"
+#include "huffman_tree/components/FrequencyChunk.h"
+#include "huffman_tree/components/HuffmanCodeword.h"
 #include "huffman_tree/components/HuffmanHeader.h"
+#include "huffman_tree/context_model/ContextModel.h"
+#include "huffman_tree/decoding_table/DecodingTable.h"
+#include "huffman_tree/dictionary/Dictionary.h"
+#include "huffman_tree/dictionary/DictionaryCache.h"
+#include "huffman_tree/histogram/ByteHistogram.h"
+#include "huffman_tree/histogram/ContextHistogram.h"
+#include "input_source/InputSource.h"
 
 class HuffmanTree {
 public:
     // constructors
-    HuffmanTree(std::ifstream& input, const std::string& name, const std::string& extension, const std::string& destination);
+    HuffmanTree(InputSource& input, const std::string& name, const std::string& extension,
+                const CompressionOptions& options = CompressionOptions{});
     HuffmanTree() = default;
 
+    // clear the object so that it can be reused, optionally for compressing another file
+    void reset();
+    void reset(const std::string& name, const std::string& extension,
+               const CompressionOptions& options = CompressionOptions{});
+
     // main program loop public functions
-    std::string compress(std::ifstream& input, const std::string& destination);
-    std::string decompress(std::ifstream& input, const std::string& destination);
+    std::string compress(InputSource& input, const std::string& destination);
+    std::string decompress(InputSource& input, const std::string& destination,
+                           const CompressionOptions& options = CompressionOptions{});
+    // decodes length bytes of the original file from offset into output (fewer past its end), returning false if the
+    // file could not be decoded
+    bool decompressRange(InputSource& input, uint64_t offset, uint64_t length, std::vector<uint8_t>& output,
+                         const CompressionOptions& options = CompressionOptions{});
+
+    // piped program loop public functions, which return false if the stream could not be compressed or decompressed
+    bool compressPiped(InputSource& input, std::ostream& output,
+                       const CompressionOptions& options = CompressionOptions{});
+    bool decompressPiped(InputSource& input, std::ostream& output,
+                         const CompressionOptions& options = CompressionOptions{});
+
+    // compression stages, run in this order once per file
+    void scan(InputSource& input);
+    void build(); // same as buildTree followed by buildTable
+    void buildTree();
+    void buildTable();
+    void encode(InputSource& input);
+    // returns the path of the compressed file, or an empty path (printing nothing) if it could not be written
+    std::string write(InputSource& input, const std::string& destination);
+    bool write(InputSource& input, std::ostream& output); // writes to output instead, returning false if it failed
+
+    // getters for the results of each stage
+    [[nodiscard]] const ByteHistogram& getHistogram() const { return histogram; }
+    [[nodiscard]] const EncodingTable& getEncodingTable() const { return encodingTable; }
+    [[nodiscard]] const ContextModel& getContextModel() const { return contextModel; } // no tables if not used
+    [[nodiscard]] const BlockSplitter& getBlockSplitter() const { return blockSplitter; } // no tables if not used
+    [[nodiscard]] const Dictionary* getDictionary() const { return dictionary; } // nullptr if not used
+    [[nodiscard]] const HuffmanHeader& getHuffmanHeader() const { return huffmanHeader; }
+    [[nodiscard]] const BlockIndex& getBlockIndex() const { return blockIndex; }
+    [[nodiscard]] uint64_t getLengthLimitCost() const { return lengthLimitCost; } // bits added by limiting the codes
 
 private:
     // instantiated data members
-    HuffmanNode* huffmanTreeRoot{nullptr};
+    HuffmanNodeArena huffmanTreeNodes{};
+    uint16_t huffmanTreeRoot{NO_NODE};
     FileInformation fileInformation{"", ""};
+    CompressionOptions compressionOptions{};
+    ByteHistogram histogram{};
+    EncodingTable encodingTable{};
+    AdaptiveHuffman adaptiveHuffman{}; // only used by the ADAPTIVE coding engine
+    ContextHistogram contextHistogram{}; // only counted when context tables are enabled
+    ContextModel contextModel{};
+    BlockSplitter blockSplitter{}; // only counted when split blocks are enabled
+    const Dictionary* dictionary{nullptr}; // one of the dictionaries of the options, whose codes are used
+    std::vector<FrequencyChunk> frequencyChunks{}; // only used when compressing with more than one thread
+    uint64_t lengthLimitCost{0};
+    uint32_t checksum{0}; // CRC32C of the original file, computed as it is encoded
 
     // data members which are written and read to file
     HuffmanHeader huffmanHeader{0, 0, 0};
-    std::string huffmanFileInfoCode{};
-    std::string huffmanTreeRepresentation{};
-    std::string huffmanCode{};
+    PackedBits huffmanFileInfoCode{};
+    PackedBits huffmanTreeRepresentation{};
+    PackedBits huffmanCode{};
+    BlockIndex blockIndex{};
 
     // main program loop private functions
-    void generate(std::ifstream& input);
-    void instantiate();
+    void limitCodeLengths();
+    [[nodiscard]] bool isParallel() const;
+    [[nodiscard]] bool isAdaptive() const;
+    [[nodiscard]] bool isContextual() const;
+    [[nodiscard]] bool isSplit() const;
+    void encodeInOrder(InputSource& input, uint64_t flags); // encodes the file with the state carried between blocks
+    void encodeBlock(const uint8_t* data, std::size_t size, BitWriter& writer); // with the codes in use
+    bool instantiate(unsigned decodingTableBits); // returns false if the code length table is invalid
+    bool verifyChecksum(InputSource& input, uint64_t position); // returns false if the checksum at position differs
+    bool findDictionary(const DictionaryCache* dictionaries); // returns false if the file's dictionary was not given
 };
 
 
@@ -0,0 +1,155 @@
+// Adaptive Huffman Implementation
+
+#include "AdaptiveHuffman.h"
+
+#include <algorithm>
+
+void AdaptiveHuffman::reset() {
+    weights.fill(0);
+    parents.fill(NO_CHILD);
+    children.fill(NO_CHILD);
+    symbols.fill(NYT_SYMBOL);
+    leaves.fill(NO_CHILD);
+    leaves[NYT_SYMBOL] = ROOT;
+}
+
+void AdaptiveHuffman::encode(const uint8_t* data, std::size_t size, BitWriter& writer) {
+    for (std::size_t i{0}; i < size; ++i) {
+        uint8_t character{data[i]};
+
+        // a new character is sent as the code of the NYT leaf followed by the character itself
+        if (leaves[character] != NO_CHILD) {
+            writePath(leaves[character], writer);
+        } else {
+            writePath(leaves[NYT_SYMBOL], writer);
+            writer.writeByte(character);
+        }
+
+        update(character);
+    }
+}
+
+std::size_t AdaptiveHuffman::decode(BitReader& reader, uint64_t bitLength, uint8_t* output, std::size_t capacity,
+                                    bool& corrupted) {
+    std::size_t count{0};
+
+    while (count < capacity && reader.position() < bitLength) {
+        // walk down from the root one bit at a time, as the tree changes after every character
+        uint16_t node{ROOT};
+        while (children[node] != NO_CHILD) {
+            if (reader.position() >= bitLength) {
+                corrupted = true;
+                return count;
+            }
+            node = static_cast<uint16_t>(children[node] + (reader.readBit() ? 1 : 0));
+        }
+
+        // the character following the NYT leaf must be one not seen before
+        uint16_t symbol{symbols[node]};
+        if (symbol == NYT_SYMBOL) {
+            if (bitLength - reader.position() < 8) {
+                corrupted = true;
+                return count;
+            }
+            symbol = reader.readByte();
+            if (leaves[symbol] != NO_CHILD) {
+                corrupted = true;
+                return count;
+            }
+        }
+
+        output[count++] = static_cast<uint8_t>(symbol);
+        update(static_cast<uint8_t>(symbol));
+    }
+
+    return count;
+}
+
+void AdaptiveHuffman::writePath(uint16_t node, BitWriter& writer) const {
+    // the path is found from the leaf up, so its bits are collected (the root's bit the most significant) and then
+    // written from the root down. a path is at most 256 bits, 4 words
+    std::array<uint64_t, 4> words{};
+    std::size_t wordCount{0};
+    uint64_t code{0};
+    unsigned length{0};
+    while (node != ROOT) {
+        uint16_t parent{parents[node]};
+        code |= static_cast<uint64_t>(node - children[parent]) << length;
+        if (++length == 64) {
+            words[wordCount++] = code;
+            code = 0;
+            length = 0;
+        }
+        node = parent;
+    }
+
+    writer.writeBits(code, length);
+    while (wordCount > 0) {
+        writer.writeBits(words[--wordCount], 64);
+    }
+}
+
+void AdaptiveHuffman::update(uint8_t character) {
+    uint16_t node{leaves[character]};
+
+    // split the NYT leaf into a new NYT leaf (the 0 child) and a leaf for the character (the 1 child), both with a
+    // weight of 0 and the lowest numbers
+    if (node == NO_CHILD) {
+        uint16_t parent{leaves[NYT_SYMBOL]};
+        uint16_t nyt{static_cast<uint16_t>(parent - 2)};
+        node = static_cast<uint16_t>(parent - 1);
+
+        children[parent] = nyt;
+        parents[nyt] = parent;
+        parents[node] = parent;
+        symbols[node] = character;
+        leaves[character] = node;
+        leaves[NYT_SYMBOL] = nyt;
+    }
+
+    // increment every node from the leaf to the root, first swapping each with the leader of its block (unless the
+    // leader is its own parent, which has the same weight only when the node's sibling is the NYT leaf)
+    while (true) {
+        uint16_t leader{findLeader(node)};
+        if (leader != node && leader != parents[node]) {
+            swapNodes(node, leader);
+            node = leader;
+        }
+
+        ++weights[node];
+        if (node == ROOT) {
+            return;
+        }
+        node = parents[node];
+    }
+}
+
+uint16_t AdaptiveHuffman::findLeader(uint16_t node) const {
+    // most blocks are short, so the end of the block is first bracketed by steps which double in size from the node,
+    // and only then found by a binary search
+    uint64_t weight{weights[node]};
+    std::size_t low{node};
+    std::size_t step{1};
+    while (low + step <= ROOT && weights[low + step] == weight) {
+        low += step;
+        step *= 2;
+    }
+    std::size_t high{std::min<std::size_t>(low + step, NODE_COUNT)};
+    return static_cast<uint16_t>(std::upper_bound(weights.begin() + low, weights.begin() + high, weight) -
+                                 weights.begin() - 1);
+}
+
+void AdaptiveHuffman::swapNodes(uint16_t first, uint16_t second) {
+    // the nodes have the same weight, and each number keeps its parent, so only what hangs from them is exchanged
+    std::swap(children[first], children[second]);
+    std::swap(symbols[first], symbols[second]);
+
+    for (uint16_t node : {first, second}) {
+        if (children[node] != NO_CHILD) {
+            parents[children[node]] = node;
+            parents[children[node] + 1] = node;
+        } else {
+            leaves[symbols[node]] = node;
+        }
+    }
+}
@@ -0,0 +1,74 @@
+// Adaptive Huffman Header
+
+// Building the Huffman Tree from the frequencies of the characters means reading the whole file twice: once to count
+// the frequencies and once to encode it, which cannot be done with a stream that is still arriving. Adaptive Huffman
+// coding (the FGK algorithm, after Faller, Gallager and Knuth) instead starts from an empty tree and updates it after
+// every character, so each character is encoded as soon as it is read, and the decoder, making the same updates after
+// every character it decodes, always holds the same tree as the encoder did. Nothing about the tree is written to file.
+
+// https://en.wikipedia.org/wiki/Adaptive_Huffman_coding
+// https://www.ics.uci.edu/~dan/pubs/DC-Sec4.html
+
+// The tree starts as a single NYT ("not yet transmitted") leaf. A character seen before is encoded by its code in the
+// tree, and a new character by the code of the NYT leaf followed by its 8 bits, after which the NYT leaf is split
+// into a new NYT leaf and a leaf for the character. The tree is kept a Huffman Tree of the frequencies so far by the
+// sibling property: numbering the nodes from the bottom of the tree up, the weights never decrease with the number,
+// and siblings have adjacent numbers. When the weight of a node is incremented, the node is first swapped with the
+// node of the highest number of the same weight (the leader of its block), which keeps the property.
+
+// Every node is stored at the index of its number, in arrays of NODE_COUNT (a tree of 256 characters and the NYT leaf
+// has 257 leaf nodes and 256 non-leaf nodes), with the root at ROOT. Swapping two nodes then means exchanging what is
+// stored at their indices, and since the weights are in order of index, the leader of a block is found by a search
+// which gallops up from the node and then bisects, rather than a scan. The children of a non-leaf node always have
+// adjacent numbers, so only the number of the 0 child is kept (the 1 child is the next number).
+
+// Adaptive codes are a little longer than those of the Huffman Tree of the whole file, as each character is encoded
+// with the frequencies before it, and updating the tree costs more than a table lookup, so this is only the faster
+// choice when reading the file twice is the problem (see CodingEngine in CompressionOptions).
+
+#ifndef ADAPTIVE_HUFFMAN_H
+#define ADAPTIVE_HUFFMAN_H
+
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "huffman_tree/bit_stream/BitReader.h"
+#include "huffman_tree/bit_stream/BitWriter.h"
+
+enum class CodingEngine {
+    TWO_PASS, // a Huffman Tree built from the frequencies of the whole file
+    ADAPTIVE,
+};
+
+class AdaptiveHuffman {
+public:
+    static constexpr uint16_t NODE_COUNT{513};
+    static constexpr uint16_t ROOT{NODE_COUNT - 1};
+    static constexpr uint16_t NYT_SYMBOL{256};
+
+    AdaptiveHuffman() { reset(); } // constructor
+    void reset(); // post-condition: the tree is only the NYT leaf
+
+    void encode(const uint8_t* data, std::size_t size, BitWriter& writer);
+    // decodes up to capacity characters, stopping at bitLength
+    std::size_t decode(BitReader& reader, uint64_t bitLength, uint8_t* output, std::size_t capacity, bool& corrupted);
+
+private:
+    std::array<uint64_t, NODE_COUNT> weights{};
+    std::array<uint16_t, NODE_COUNT> parents{};
+    std::array<uint16_t, NODE_COUNT> children{}; // number of the 0 child, NO_CHILD for a leaf
+    std::array<uint16_t, NODE_COUNT> symbols{}; // character of a leaf, or NYT_SYMBOL
+    std::array<uint16_t, NYT_SYMBOL + 1> leaves{}; // number of the leaf of each character, NO_CHILD if not yet seen
+
+    static constexpr uint16_t NO_CHILD{UINT16_MAX};
+
+    void writePath(uint16_t node, BitWriter& writer) const;
+    void update(uint8_t character);
+    [[nodiscard]] uint16_t findLeader(uint16_t node) const; // the highest number with the same weight as the node
+    void swapNodes(uint16_t first, uint16_t second);
+};
+
+
+#endif // ADAPTIVE_HUFFMAN_H
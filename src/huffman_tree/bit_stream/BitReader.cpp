@@ -0,0 +1,54 @@
+// Bit Reader Implementation
+
+#include "BitReader.h"
+
+BitReader::BitReader(const uint8_t* data, std::size_t byteCount, uint64_t bitCount)
+    : data(data), byteLength(byteCount), bitLength(bitCount) {}
+
+BitReader::BitReader(const BitSpan& span) : BitReader(span.bytes, span.byteLength, span.bitLength) {}
+
+uint64_t BitReader::readBits(unsigned count) {
+    uint64_t value{peekBits(count)};
+    skipBits(count);
+    return value;
+}
+
+void BitReader::seek(uint64_t bitPosition) {
+    // start again from the byte holding the bit, then skip the bits of that byte before it
+    uint64_t bytePosition{bitPosition / 8};
+    nextByte = bytePosition < byteLength ? static_cast<std::size_t>(bytePosition) : byteLength;
+    accumulator = 0;
+    accumulatorBits = 0;
+    consumedBits = bytePosition * 8;
+    skipBits(static_cast<unsigned>(bitPosition % 8));
+}
+
+void BitReader::refill() {
+    // fast path: load 8 bytes at once and keep as many whole bytes as fit in the accumulator
+    if (nextByte + 8 <= byteLength) {
+        uint64_t word{0};
+        for (int i{0}; i < 8; ++i) {
+            word = (word << 8) | data[nextByte + i];
+        }
+
+        // the bits below the kept bytes are also true bits of the stream, so OR-ing them again on the next refill
+        // leaves the accumulator unchanged
+        accumulator |= word >> accumulatorBits;
+        unsigned byteCount{(63 - accumulatorBits) / 8};
+        nextByte += byteCount;
+        accumulatorBits += byteCount * 8;
+        return;
+    }
+
+    // slow path near the end of the data: one byte at a time
+    while (accumulatorBits <= 56 && nextByte < byteLength) {
+        accumulator |= static_cast<uint64_t>(data[nextByte]) << (56 - accumulatorBits);
+        ++nextByte;
+        accumulatorBits += 8;
+    }
+
+    // past the end, pretend the stream continues with 0s
+    if (nextByte >= byteLength) {
+        accumulatorBits = 64;
+    }
+}
@@ -0,0 +1,99 @@
+// Bit Reader Header
+
+// The BitReader is the counterpart of the BitWriter. It reads bits most significant bit first from a packed byte
+// buffer, keeping up to 64 upcoming bits in an accumulator aligned to its most significant end. When the accumulator
+// runs low, it is refilled with a single 8-byte load rather than one byte at a time.
+
+// peekBits allows a caller to look at upcoming bits without consuming them, which is what a table-driven decoder needs.
+// Reads past the end of the buffer yield 0s, the same as the padding in the last byte of a section. A single call
+// may read or peek at most 56 bits.
+
+// seek moves to any bit of the buffer by dropping the accumulator and refilling it from the byte holding that bit, and
+// span gives the buffer itself, so that a section made of several streams (see InterleavedStreams) can hand each
+// stream to a BitReader of its own and then move past them. fill, peekFilled and skipFilled let a decoder which knows
+// how many bits it can use at most (see DecodingTable::decodeInterleaved) refill once for several characters.
+
+#ifndef BIT_READER_H
+#define BIT_READER_H
+
+
+#include <cstddef>
+#include <cstdint>
+
+#include "PackedBits.h"
+
+class BitReader {
+public:
+    static constexpr unsigned FILL_BITS{56};
+
+    // constructors
+    BitReader(const uint8_t* data, std::size_t byteCount, uint64_t bitCount);
+    explicit BitReader(const BitSpan& span);
+
+    uint64_t readBits(unsigned count);
+    bool readBit() { return readBits(1) != 0; }
+    uint8_t readByte() { return static_cast<uint8_t>(readBits(8)); }
+    uint64_t peekBits(unsigned count);
+    void skipBits(unsigned count);
+    void seek(uint64_t bitPosition); // continues reading at bitPosition, before or after the current position
+
+    // for decoders which count the bits they use themselves: fill buffers at least FILL_BITS bits, after which up to
+    // that many bits in all can be peeked at and skipped with peekFilled and skipFilled, which check nothing
+    void fill() {
+        if (accumulatorBits < FILL_BITS) {
+            refill();
+        }
+    }
+    [[nodiscard]] unsigned filledBits() const { return accumulatorBits; }
+    [[nodiscard]] uint64_t peekFilled(unsigned count) const { return accumulator >> (64 - count); } // 0 < count
+    void skipFilled(unsigned count) {
+        accumulator <<= count;
+        accumulatorBits -= count;
+        consumedBits += count;
+    }
+
+    [[nodiscard]] uint64_t position() const { return consumedBits; }
+    [[nodiscard]] BitSpan span() const { return BitSpan{data, byteLength, bitLength}; }
+    [[nodiscard]] uint64_t remaining() const { return consumedBits >= bitLength ? 0 : bitLength - consumedBits; }
+
+private:
+    const uint8_t* data{nullptr};
+    std::size_t byteLength{0};
+    std::size_t nextByte{0};
+    uint64_t bitLength{0};
+    uint64_t consumedBits{0};
+    uint64_t accumulator{0};
+    unsigned accumulatorBits{0};
+
+    void refill(); // post-condition: at least FILL_BITS bits are buffered, which are 0s past the end of the data
+};
+
+// peekBits and skipBits are called for every character decoded, so they are inline, leaving only refill out of line
+
+inline uint64_t BitReader::peekBits(unsigned count) {
+    if (count == 0) {
+        return 0;
+    }
+    if (accumulatorBits < count) {
+        refill();
+    }
+
+    return accumulator >> (64 - count);
+}
+
+inline void BitReader::skipBits(unsigned count) {
+    if (count == 0) {
+        return;
+    }
+    if (accumulatorBits < count) {
+        refill();
+    }
+
+    // bits beyond the end of the data are treated as 0s
+    accumulator = count >= 64 ? 0 : accumulator << count;
+    accumulatorBits = count > accumulatorBits ? 0 : accumulatorBits - count;
+    consumedBits += count;
+}
+
+
+#endif // BIT_READER_H
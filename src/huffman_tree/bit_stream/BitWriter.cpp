@@ -0,0 +1,89 @@
+// Bit Writer Implementation
+
+#include "BitWriter.h"
+
+BitWriter::BitWriter(PackedBits& packedBits) : target(&packedBits) {}
+
+BitWriter::BitWriter(uint8_t* memory, uint64_t bitOffset)
+    : slice(memory), slicePosition(static_cast<std::size_t>(bitOffset / 8)), headPending(bitOffset % 8 != 0),
+      accumulatorBits(static_cast<unsigned>(bitOffset % 8)) {
+    // the accumulator starts with 0s standing in for the bits of the previous slice in the first byte
+}
+
+void BitWriter::writeBits(uint64_t value, unsigned count) {
+    if (count == 0) {
+        return;
+    }
+
+    // discard any bits above count
+    if (count < 64) {
+        value &= (uint64_t{1} << count) - 1;
+    }
+
+    writtenBits += count;
+    if (target != nullptr) {
+        target->bitLength += count;
+    }
+    unsigned freeBits{64 - accumulatorBits};
+
+    // the bits fit in the accumulator without filling it
+    if (count < freeBits) {
+        accumulator = (accumulator << count) | value;
+        accumulatorBits += count;
+        return;
+    }
+
+    // otherwise complete the accumulator with the high bits of value, flush it, and keep the spilled low bits
+    unsigned spillBits{count - freeBits};
+    uint64_t word{freeBits == 64 ? 0 : accumulator << freeBits};
+    word |= value >> spillBits;
+    flushWord(word);
+
+    accumulator = spillBits == 0 ? 0 : value & ((uint64_t{1} << spillBits) - 1);
+    accumulatorBits = spillBits;
+}
+
+void BitWriter::flush() {
+    if (accumulatorBits == 0) {
+        return;
+    }
+
+    // align remaining bits to the most significant end, which leaves a padding of 0s at the end
+    uint64_t word{accumulator << (64 - accumulatorBits)};
+    flushBytes(word, (accumulatorBits + 7) / 8);
+
+    accumulator = 0;
+    accumulatorBits = 0;
+}
+
+void BitWriter::flushWord(uint64_t word) {
+    if (target == nullptr) {
+        flushBytes(word, 8);
+        return;
+    }
+
+    // append all 8 bytes at once, most significant byte first
+    std::size_t size{target->bytes.size()};
+    target->bytes.resize(size + 8);
+    uint8_t* destination{target->bytes.data() + size};
+    for (int i{0}; i < 8; ++i) {
+        destination[i] = static_cast<uint8_t>(word >> (56 - i * 8));
+    }
+}
+
+void BitWriter::flushBytes(uint64_t word, unsigned byteCount) {
+    for (unsigned i{0}; i < byteCount; ++i) {
+        auto byte{static_cast<uint8_t>(word >> (56 - i * 8))};
+
+        if (target != nullptr) {
+            target->bytes.push_back(byte);
+        } else if (headPending) {
+            // the first byte of the slice is shared with the previous slice
+            headByte = byte;
+            headPending = false;
+            ++slicePosition;
+        } else {
+            slice[slicePosition++] = byte;
+        }
+    }
+}
@@ -0,0 +1,60 @@
+// Bit Writer Header
+
+// The BitWriter appends variable-length bit sequences (such as a Huffman Code for a single character) to a PackedBits
+// object. Rather than touching memory for every bit, bits are collected in a 64-bit accumulator and only when the
+// accumulator is full are all 8 bytes flushed to the packed buffer at once. The accumulator is filled from its least
+// significant end and flushed most significant byte first, which preserves the most significant bit first order used
+// by the compressed file.
+
+// A single writeBits call can append up to 64 bits, which covers any Huffman Code the program can generate (a code of
+// more than 64 bits would require an input in the range of tens of terabytes).
+
+// flush must be called once after the last write so that the remaining bits in the accumulator are written with a
+// padding of 0s to complete the final byte.
+
+// A BitWriter can also write into a slice of preallocated, zero-initialized memory starting at any bit offset. This is
+// used when several threads encode neighbouring parts of the same Huffman Code at once. As the first byte of a slice
+// that does not start on a byte boundary is shared with the previous slice, that byte is not written to memory but
+// kept in headByte, to be combined with the bitwise OR operator (|) by the caller once every thread has finished. The
+// last byte of a slice is written with a padding of 0s, which leaves the shared bits for the next slice's headByte.
+
+#ifndef BIT_WRITER_H
+#define BIT_WRITER_H
+
+
+#include <cstddef>
+#include <cstdint>
+
+#include "PackedBits.h"
+
+class BitWriter {
+public:
+    // constructors
+    explicit BitWriter(PackedBits& packedBits);
+    BitWriter(uint8_t* memory, uint64_t bitOffset); // writes into memory starting at bitOffset
+
+    void writeBits(uint64_t value, unsigned count); // writes the lowest count bits of value
+    void writeBit(bool bit) { writeBits(bit ? 1 : 0, 1); }
+    void writeByte(uint8_t byte) { writeBits(byte, 8); }
+    void flush(); // post-condition: every written bit is in memory, padded to a whole byte
+
+    [[nodiscard]] uint64_t bitCount() const { return writtenBits; }
+    [[nodiscard]] uint8_t getHeadByte() const { return headByte; }
+
+private:
+    PackedBits* target{nullptr}; // nullptr when writing into a slice
+    uint8_t* slice{nullptr};
+    std::size_t slicePosition{0};
+    bool headPending{false};
+    uint8_t headByte{0};
+
+    uint64_t writtenBits{0};
+    uint64_t accumulator{0};
+    unsigned accumulatorBits{0};
+
+    void flushWord(uint64_t word);
+    void flushBytes(uint64_t word, unsigned byteCount); // writes the byteCount most significant bytes of word
+};
+
+
+#endif // BIT_WRITER_H
@@ -0,0 +1,50 @@
+// Packed Bits Header and Implementation
+
+// PackedBits is the in-memory form of every bit section handled by the program (File Information Code, Tree
+// Representation and Huffman Code). Bits are stored 8 per byte, most significant bit first, which is exactly the
+// layout written to file, so a section can be written or read with a single bulk call instead of bit by bit.
+
+// bitLength records the true count of bits, as the last byte may contain padding of 0s.
+
+// A BitSpan refers to packed bits held elsewhere, either in a PackedBits or directly in a memory-mapped file (see
+// InputSource), so that a section can be read without first being copied.
+
+#ifndef PACKED_BITS_H
+#define PACKED_BITS_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class PackedBits {
+public:
+    // public data members
+    std::vector<uint8_t> bytes{};
+    uint64_t bitLength{0};
+
+    void clear() {
+        bytes.clear();
+        bitLength = 0;
+    }
+
+    [[nodiscard]] std::size_t byteLength() const { return static_cast<std::size_t>((bitLength + 7) / 8); }
+};
+
+class BitSpan {
+public:
+    // constructors
+    BitSpan() = default;
+    BitSpan(const uint8_t* data, std::size_t byteCount, uint64_t bitCount)
+        : bytes(data), byteLength(byteCount), bitLength(bitCount) {}
+    BitSpan(const PackedBits& packedBits) // implicit, so that a PackedBits can be passed wherever a span is read
+        : bytes(packedBits.bytes.data()), byteLength(packedBits.bytes.size()), bitLength(packedBits.bitLength) {}
+
+    // public data members
+    const uint8_t* bytes{nullptr};
+    std::size_t byteLength{0};
+    uint64_t bitLength{0};
+};
+
+
+#endif // PACKED_BITS_H
@@ -0,0 +1,286 @@
+// Block Splitter Implementation
+
+#include "BlockSplitter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "huffman_tree/bit_stream/PackedBits.h"
+#include "utils/generate/generate_utils.h"
+
+BlockSplitter::BlockSplitter(HistogramEngine engine) : engine(engine), segment(engine) {}
+
+void BlockSplitter::reset() {
+    countedBlocks.clear();
+    segment.clear();
+    segmentSize = 0;
+    clearTables();
+}
+
+// counting
+
+void BlockSplitter::count(const uint8_t* data, std::size_t size) {
+    while (size > 0) {
+        std::size_t segmentPart{std::min(size, SEGMENT_SIZE - segmentSize)};
+        segment.count(data, segmentPart);
+        segmentSize += segmentPart;
+        data += segmentPart;
+        size -= segmentPart;
+
+        if (segmentSize == SEGMENT_SIZE) {
+            finishSegment();
+        }
+    }
+}
+
+void BlockSplitter::finish() {
+    if (segmentSize != 0) {
+        finishSegment();
+    }
+}
+
+void BlockSplitter::append(const BlockSplitter& other) {
+    countedBlocks.insert(countedBlocks.end(), other.countedBlocks.begin(), other.countedBlocks.end());
+}
+
+void BlockSplitter::mergeBlocks() {
+    // merge each block into the one before it whenever they are cheaper as one
+    std::vector<CountedBlock> unmerged{};
+    unmerged.swap(countedBlocks);
+    for (const CountedBlock& block : unmerged) {
+        if (!mergeBlock(block)) {
+            countedBlocks.push_back(block);
+        }
+    }
+}
+
+void BlockSplitter::total(ByteHistogram& histogram) const {
+    histogram.clear();
+    for (const CountedBlock& block : countedBlocks) {
+        histogram.merge(block.histogram);
+    }
+}
+
+void BlockSplitter::finishSegment() {
+    CountedBlock block{};
+    block.size = segmentSize;
+    block.histogram = segment;
+    block.cost = estimateCost(segment);
+    segment.clear();
+    segmentSize = 0;
+
+    // the segment joins the current block, unless it is cheaper to start a new block with a table of its own
+    if (!mergeBlock(block)) {
+        countedBlocks.push_back(block);
+    }
+}
+
+bool BlockSplitter::mergeBlock(const CountedBlock& block) {
+    if (countedBlocks.empty()) {
+        return false;
+    }
+
+    CountedBlock& last{countedBlocks.back()};
+    ByteHistogram combined{last.histogram};
+    combined.merge(block.histogram);
+    double combinedCost{estimateCost(combined)};
+    if (combinedCost > last.cost + block.cost) {
+        return false;
+    }
+
+    last.size += block.size;
+    last.histogram = combined;
+    last.cost = combinedCost;
+    return true;
+}
+
+// building
+
+bool BlockSplitter::build(TreeBuilderEngine treeBuilderEngine, unsigned maxCodeLength, uint64_t singleTableBits) {
+    clearTables();
+    if (countedBlocks.size() < 2) {
+        return false;
+    }
+
+    blocks.assign(countedBlocks.size(), SplitBlock{});
+    for (std::size_t i{0}; i < blocks.size(); ++i) {
+        SplitBlock& block{blocks[i]};
+        const ByteHistogram& histogram{countedBlocks[i].histogram};
+        block.size = countedBlocks[i].size;
+        EncodingTable table{};
+        uint64_t ownBits{generateLimitedEncodingTable(table, histogram, treeBuilderEngine, maxCodeLength)};
+
+        // reuse the table of the block before when every character of the block has a code in it and it takes no
+        // more bits than the block's own codes and their table
+        if (i != 0) {
+            const EncodingTable& previousTable{encodingTables[blocks[i - 1].table]};
+            uint64_t reusedBits{0};
+            bool reusable{true};
+            for (std::size_t character{0}; character < previousTable.size(); ++character) {
+                uint64_t frequency{histogram.frequencies[character]};
+                reusable = reusable && (frequency == 0 || previousTable[character].length != 0);
+                reusedBits += frequency * previousTable[character].length;
+            }
+
+            PackedBits lengthTable{};
+            generateCodeLengthTable(lengthTable, table);
+            if (reusable && reusedBits <= ownBits + lengthTable.bitLength) {
+                block.table = blocks[i - 1].table;
+                encodedBits += reusedBits;
+                continue;
+            }
+        }
+
+        block.table = encodingTables.size();
+        encodingTables.push_back(table);
+        encodedBits += ownBits;
+    }
+
+    // keep the blocks only if they are smaller than the single table, counting every block header and table
+    PackedBits representation{};
+    generateBlockTables(representation, *this);
+    totalBits = encodedBits + representation.bitLength;
+    if (totalBits >= singleTableBits) {
+        clearTables();
+        return false;
+    }
+
+    position = SplitPosition{0, blocks[0].size};
+    return true;
+}
+
+void BlockSplitter::clearTables() {
+    blocks.clear();
+    encodingTables.clear();
+    decodingTables.clear();
+    encodedBits = 0;
+    totalBits = 0;
+    position = SplitPosition{};
+}
+
+bool BlockSplitter::setTables(const std::vector<SplitBlock>& splitBlocks, const std::vector<EncodingTable>& tables,
+                              unsigned decodingTableBits) {
+    reset();
+
+    // every block must refer to one of the tables
+    if (splitBlocks.empty()) {
+        return false;
+    }
+    for (const SplitBlock& block : splitBlocks) {
+        if (block.table >= tables.size()) {
+            return false;
+        }
+    }
+
+    blocks = splitBlocks;
+    encodingTables = tables;
+    for (const EncodingTable& table : encodingTables) {
+        decodingTables.emplace_back(table, decodingTableBits);
+    }
+    position = SplitPosition{0, blocks[0].size};
+    return true;
+}
+
+// encoding and decoding
+
+void BlockSplitter::encode(const uint8_t* data, std::size_t size, BitWriter& writer) {
+    encode(data, size, writer, position);
+}
+
+void BlockSplitter::encode(const uint8_t* data, std::size_t size, BitWriter& writer,
+                           SplitPosition& splitPosition) const {
+    while (size > 0 && (splitPosition.remaining != 0 || nextBlock(splitPosition))) {
+        auto blockPart{static_cast<std::size_t>(std::min<uint64_t>(size, splitPosition.remaining))};
+        generateHuffmanCodeBlock(data, blockPart, encodingTables[blocks[splitPosition.block].table], writer);
+        data += blockPart;
+        size -= blockPart;
+        splitPosition.remaining -= blockPart;
+    }
+}
+
+std::size_t BlockSplitter::decode(BitReader& reader, uint64_t bitLength, uint8_t* output, std::size_t capacity,
+                                  bool& corrupted) {
+    return decode(reader, bitLength, output, capacity, corrupted, position);
+}
+
+std::size_t BlockSplitter::decode(BitReader& reader, uint64_t bitLength, uint8_t* output, std::size_t capacity,
+                                  bool& corrupted, SplitPosition& splitPosition) const {
+    std::size_t count{0};
+
+    // decode each block with its own table, where any code left after the last block is corrupted
+    while (count < capacity && reader.position() < bitLength && !corrupted) {
+        if (splitPosition.remaining == 0 && !nextBlock(splitPosition)) {
+            corrupted = true;
+            break;
+        }
+
+        auto blockCapacity{static_cast<std::size_t>(std::min<uint64_t>(capacity - count, splitPosition.remaining))};
+        const DecodingTable& decodingTable{decodingTables[blocks[splitPosition.block].table]};
+        std::size_t decoded{decodingTable.decode(reader, bitLength, output + count, blockCapacity, corrupted)};
+        count += decoded;
+        splitPosition.remaining -= decoded;
+    }
+
+    return count;
+}
+
+bool BlockSplitter::seek(uint64_t offset) {
+    return seek(offset, position);
+}
+
+bool BlockSplitter::seek(uint64_t offset, SplitPosition& splitPosition) const {
+    // find the block holding the byte at offset, or the end of the last block
+    for (std::size_t i{0}; i < blocks.size(); ++i) {
+        if (offset < blocks[i].size || i + 1 == blocks.size()) {
+            splitPosition.block = i;
+            splitPosition.remaining = offset <= blocks[i].size ? blocks[i].size - offset : 0;
+            return offset <= blocks[i].size;
+        }
+        offset -= blocks[i].size;
+    }
+    return false;
+}
+
+bool BlockSplitter::nextBlock(SplitPosition& splitPosition) const {
+    while (splitPosition.remaining == 0) {
+        if (splitPosition.block + 1 >= blocks.size()) {
+            return false;
+        }
+        splitPosition.remaining = blocks[++splitPosition.block].size;
+    }
+    return true;
+}
+
+// cost model
+
+double BlockSplitter::estimateCost(const ByteHistogram& histogram) {
+    auto total{static_cast<double>(histogram.total())};
+    double bits{0};
+    for (uint64_t frequency : histogram.frequencies) {
+        if (frequency != 0) {
+            bits += static_cast<double>(frequency) * std::log2(total / static_cast<double>(frequency));
+        }
+    }
+
+    return bits + static_cast<double>(estimateTableBits(histogram));
+}
+
+uint64_t BlockSplitter::estimateTableBits(const ByteHistogram& histogram) {
+    // the smaller of the two layouts of generateCodeLengthTable, with lengths of up to 15 bits
+    uint64_t characterCount{0};
+    uint64_t groupCount{0};
+    for (std::size_t group{0}; group < 32; ++group) {
+        bool groupOccurs{false};
+        for (std::size_t i{0}; i < 8; ++i) {
+            if (histogram.frequencies[group * 8 + i] != 0) {
+                groupOccurs = true;
+                ++characterCount;
+            }
+        }
+        groupCount += groupOccurs ? 1 : 0;
+    }
+
+    uint64_t treeLayoutBits{characterCount == 0 ? 0 : characterCount * 10 - 1};
+    uint64_t listLayoutBits{35 + groupCount * 8 + characterCount * 4};
+    return 1 + std::min(treeLayoutBits, listLayoutBits);
+}
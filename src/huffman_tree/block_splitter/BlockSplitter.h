@@ -0,0 +1,136 @@
+// Block Splitter Header
+
+// A single Huffman Tree is built from the frequencies of the whole file, so a file made of parts with different
+// characters, such as a log with binary data in the middle, is encoded with codes which suit none of its parts. The
+// BlockSplitter instead cuts the file into blocks wherever its characters change, and gives every block a table of
+// its own, or the table of the block before it when that is cheaper.
+
+// While the file is counted (in place of the ByteHistogram, so the file is still only read twice), every SEGMENT_SIZE
+// bytes are counted on their own and then either added to the current block or made the start of a new block,
+// whichever the cost model finds cheaper. The cost of a block is estimated as the information content of its
+// characters, the sum of frequency * log2(total / frequency), plus the size of its code length table (see
+// estimateTableBits). Since cutting a block in two never makes this sum larger, a new block is only started when the
+// characters change by enough to pay for another table. When several threads count the file, each counts its own
+// chunk, and the blocks are joined with append. mergeBlocks then merges every two neighbouring blocks which are
+// cheaper as one, which also joins the blocks on either side of the chunk boundaries.
+
+// https://en.wikipedia.org/wiki/Entropy_(information_theory)
+
+// build then builds the canonical codes of every block, and gives a block the table of the block before it instead
+// when that encodes it in fewer bits than its own codes and their table. The blocks are only kept when they make the
+// Huffman Code and its tables smaller than the single Huffman Tree.
+
+// The Tree Representation section of a file with blocks (marked by the SPLIT flag of the header) holds the number of
+// blocks and then a header for every block: its size in the original file, a bit set when it reuses the table of the
+// block before it (absent for the first block), and otherwise its code length table:
+
+// [Block Count] > [Size] > [Code Length Table] > [Size] > [Reuse] > [Code Length Table] > ...
+
+// where the count and sizes are varints (see generateBlockTables and instantiateBlockSplitter). The Huffman Code of
+// every block follows that of the block before it, so encode and decode carry the current block from one call to the
+// next, and the blocks of a file must be encoded and decoded in order, unless seek first moves to the block holding
+// the byte at a sync point of the BlockIndex. The overloads taking a SplitPosition carry the current block in the
+// caller's SplitPosition instead and leave the splitter unchanged, so that several threads can encode or decode
+// different parts of a file with the same tables at once (see parallel_utils).
+
+#ifndef BLOCK_SPLITTER_H
+#define BLOCK_SPLITTER_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "huffman_tree/bit_stream/BitReader.h"
+#include "huffman_tree/bit_stream/BitWriter.h"
+#include "huffman_tree/components/HuffmanCodeword.h"
+#include "huffman_tree/decoding_table/DecodingTable.h"
+#include "huffman_tree/histogram/ByteHistogram.h"
+#include "huffman_tree/tree_builder/TreeBuilder.h"
+
+class SplitBlock {
+public:
+    // public data members
+    uint64_t size{0}; // bytes of the original file
+    std::size_t table{0}; // index of the table which encodes the block
+};
+
+// the block being encoded or decoded, and the characters left in it
+class SplitPosition {
+public:
+    // public data members
+    std::size_t block{0};
+    uint64_t remaining{0};
+};
+
+class BlockSplitter {
+public:
+    static constexpr std::size_t SEGMENT_SIZE{1 << 16};
+
+    explicit BlockSplitter(HistogramEngine engine = HistogramEngine::INTERLEAVED); // constructor
+    void reset(); // post-condition: there are no blocks and no tables
+
+    // counting, followed by finish once the whole file (or chunk) is counted
+    void count(const uint8_t* data, std::size_t size);
+    void finish();
+    void append(const BlockSplitter& other); // adds the blocks of the part of the file after this one
+    void mergeBlocks();
+    void total(ByteHistogram& histogram) const; // post-condition: histogram has the frequencies of every block
+
+    // builds the table of every block, returning false (with no tables) if they do not make the Huffman Code and its
+    // tables smaller than singleTableBits
+    bool build(TreeBuilderEngine engine, unsigned maxCodeLength, uint64_t singleTableBits);
+    void clearTables();
+    // replaces the blocks and tables with those read from file, returning false if they are invalid
+    bool setTables(const std::vector<SplitBlock>& splitBlocks, const std::vector<EncodingTable>& tables,
+                   unsigned decodingTableBits);
+
+    void encode(const uint8_t* data, std::size_t size, BitWriter& writer);
+    void encode(const uint8_t* data, std::size_t size, BitWriter& writer, SplitPosition& splitPosition) const;
+    // decodes up to capacity characters, stopping at bitLength
+    std::size_t decode(BitReader& reader, uint64_t bitLength, uint8_t* output, std::size_t capacity, bool& corrupted);
+    std::size_t decode(BitReader& reader, uint64_t bitLength, uint8_t* output, std::size_t capacity, bool& corrupted,
+                       SplitPosition& splitPosition) const;
+    bool seek(uint64_t offset); // continues at offset of the original file, returning false past its end
+    bool seek(uint64_t offset, SplitPosition& splitPosition) const;
+
+    // getters
+    [[nodiscard]] const std::vector<SplitBlock>& getBlocks() const { return blocks; } // once built
+    [[nodiscard]] const std::vector<EncodingTable>& getEncodingTables() const { return encodingTables; }
+    [[nodiscard]] unsigned getTableCount() const { return static_cast<unsigned>(encodingTables.size()); }
+    [[nodiscard]] uint64_t getEncodedBits() const { return encodedBits; } // bits of the Huffman Code, once built
+    [[nodiscard]] uint64_t getTotalBits() const { return totalBits; } // the same with the tables, once built
+
+    [[nodiscard]] static double estimateCost(const ByteHistogram& histogram);
+    [[nodiscard]] static uint64_t estimateTableBits(const ByteHistogram& histogram);
+
+private:
+    // a block found while counting
+    class CountedBlock {
+    public:
+        uint64_t size{0};
+        ByteHistogram histogram{};
+        double cost{0}; // estimated bits of the block and its own table
+    };
+
+    HistogramEngine engine{HistogramEngine::INTERLEAVED};
+    std::vector<CountedBlock> countedBlocks{};
+    ByteHistogram segment{};
+    std::size_t segmentSize{0};
+
+    std::vector<SplitBlock> blocks{};
+    std::vector<EncodingTable> encodingTables{};
+    std::vector<DecodingTable> decodingTables{}; // only when decompressing
+    uint64_t encodedBits{0};
+    uint64_t totalBits{0};
+
+    SplitPosition position{};
+
+    void finishSegment();
+    // adds the block to the last counted block when they are cheaper as one, returning false if it was not added
+    bool mergeBlock(const CountedBlock& block);
+    bool nextBlock(SplitPosition& splitPosition) const; // returns false past the last block
+};
+
+
+#endif // BLOCK_SPLITTER_H
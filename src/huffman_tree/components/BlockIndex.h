@@ -0,0 +1,55 @@
+// Block Index Header and Implementation
+
+// A Huffman Code can only be decoded from its first bit, since the codes have no boundaries of their own. The block
+// index removes this limitation by recording sync points: for every block of blockSize bytes of the original file,
+// the bit offset in the Huffman Code where the block starts, and the byte offset in the original file where its
+// characters belong. Each block can then be decoded by a different thread straight into its own region of the
+// decompressed file, and any range of the original file can be decoded starting from the block which holds its first
+// byte rather than from the start of the Huffman Code (see HuffmanTree::decompressRange).
+
+// A file with context tables encodes every character with the codes of the character before it, so each entry of its
+// index also records the character before its block, which the decoder starts from. The blocks of a file with split
+// blocks need nothing more, as the table of any byte follows from the sizes of the split blocks.
+
+// The block index is optional. When present, it is written after the Huffman Code in the following layout, where
+// every value is stored least significant byte first:
+
+// [Entries (bitOffset and outputOffset, 64 bits each)] > [Original Size (64 bits)] > [Entry Count (32 bits)] > "HZIX"
+
+// where every entry of a file with context tables is followed by its previous character (8 bits).
+
+// Keeping the index at the end of the file means that the sections before it are unchanged, and the magic "HZIX"
+// allows the decompressor to check for its presence by reading only the last bytes of the file.
+
+#ifndef BLOCK_INDEX_H
+#define BLOCK_INDEX_H
+
+
+#include <cstdint>
+#include <vector>
+
+class BlockIndexEntry {
+public:
+    // public data members
+    uint64_t bitOffset{0}; // where the block starts in the Huffman Code
+    uint64_t outputOffset{0}; // where the block starts in the original file
+    uint8_t previous{0}; // the character before the block, only stored with context tables
+};
+
+class BlockIndex {
+public:
+    static constexpr uint32_t MAGIC{0x58495A48}; // "HZIX" when stored least significant byte first
+    static constexpr uint64_t TRAILER_SIZE{8 + 4 + 4}; // bytes after the entries
+
+    // public data members
+    uint64_t originalSize{0};
+    std::vector<BlockIndexEntry> entries{};
+    bool previousCharacters{false}; // whether the entries hold their previous character
+
+    [[nodiscard]] uint64_t entrySize() const { return previousCharacters ? 8 + 8 + 1 : 8 + 8; } // bytes in the file
+
+    [[nodiscard]] bool empty() const { return entries.size() < 2; } // a single block cannot be decoded in parallel
+};
+
+
+#endif // BLOCK_INDEX_H
@@ -0,0 +1,89 @@
+// Compression Options Header and Implementation
+
+// This class consolidates the settings which change how a file is compressed, so that new settings can be added
+// without changing the signature of every function that passes them along. A default constructed object gives the
+// original behaviour of the program.
+
+// When streaming is enabled, the Huffman Code is not held in memory as a whole. Instead the original file is encoded
+// streamBlockSize bytes at a time and each encoded block is written to file as soon as it is produced, so memory use
+// stays the same no matter how large the file is.
+
+// When canonicalCodes is enabled, the codes of the Huffman Tree are reassigned in canonical order so that only their
+// lengths need to be written to file, which takes less space than the tree representation and lets the decompressor
+// build its DecodingTable directly from the lengths.
+
+// When maxCodeLength is not 0, no code may be longer than maxCodeLength bits. If the Huffman Tree has a longer code,
+// the code lengths are instead found with PackageMerge, which always uses canonical codes.
+
+// codingEngine selects how the Huffman Code is generated: TWO_PASS counts the frequencies of the whole file and then
+// encodes it with the Huffman Tree built from them, while ADAPTIVE encodes the file in a single pass with an
+// AdaptiveHuffman tree, for input which cannot be read twice or should not wait for its end. The options for building
+// the Huffman Tree and the threads do not apply to the ADAPTIVE engine.
+
+// When contextTables is enabled, the frequencies of every pair of characters are also counted, and every character is
+// encoded with the codes of the character before it when that makes the file smaller (see ContextModel). Such a file
+// is encoded and decoded by a single thread, and its BlockIndex is only used to decode part of the file (see
+// HuffmanTree::decompressRange). This does not apply to the ADAPTIVE engine.
+
+// When splitBlocks is enabled, the file is cut into blocks wherever its characters change as it is counted, and every
+// block is encoded with a table of its own (or that of the block before it) when that makes the file smaller (see
+// BlockSplitter), with the same limits as context tables. Context tables are only used over blocks when smaller still.
+
+// When dictionaries is not null, the file is encoded with the codes of whichever of its dictionaries makes the file
+// the smallest, when that is smaller than the file's own table (and than split blocks or context tables), so that the
+// table is not written to the compressed file (see Dictionary). When decompressing, the dictionary a file refers to is
+// found among the same dictionaries. This does not apply to the ADAPTIVE engine or to piped streams.
+
+// When interleavedStreams is greater than 1, the characters of every block of the Huffman Code are split between that
+// many bit streams (at most InterleavedStreams::MAX_STREAMS), which a single thread decodes several characters at a
+// time (see InterleavedStreams), at the cost of a few bytes for every block. This only applies to a file with a single
+// table, and not to streaming mode, the ADAPTIVE engine, or a file with split blocks or context tables. A table whose
+// longest code is too long for the streams to pay off is still written as a single stream (see
+// InterleavedStreams::chooseStreamCount).
+
+// histogramEngine selects how the frequencies of the characters are counted (see ByteHistogram), and
+// treeBuilderEngine how the Huffman Tree is built from them (see TreeBuilder).
+
+// When threadCount is greater than 1, counting the frequencies and generating the Huffman Code are split across that
+// many threads. The compressed file is exactly the same as the one produced by a single thread. Streaming mode always
+// uses a single thread.
+
+// When blockIndexSize is not 0, a BlockIndex with a sync point every blockIndexSize bytes of the original file is
+// written after the Huffman Code (except in streaming mode or with the ADAPTIVE engine), which allows the file to be
+// decompressed by several threads, and any range of it to be decoded without decoding everything before the range.
+// The same threadCount is used when decompressing, along with the width of the primary DecodingTable.
+
+#ifndef COMPRESSION_OPTIONS_H
+#define COMPRESSION_OPTIONS_H
+
+
+#include <cstddef>
+#include <cstdint>
+
+#include "huffman_tree/adaptive/AdaptiveHuffman.h"
+#include "huffman_tree/decoding_table/DecodingTable.h"
+#include "huffman_tree/dictionary/DictionaryCache.h"
+#include "huffman_tree/histogram/ByteHistogram.h"
+#include "huffman_tree/tree_builder/TreeBuilder.h"
+
+class CompressionOptions {
+public:
+    // public data members
+    bool streaming{false};
+    bool canonicalCodes{true};
+    unsigned maxCodeLength{0}; // 0 for no limit
+    bool contextTables{false};
+    bool splitBlocks{false};
+    const DictionaryCache* dictionaries{nullptr}; // not owned, and must outlive the compression
+    unsigned interleavedStreams{1}; // bit streams of the Huffman Code, 1 for a single stream
+    std::size_t streamBlockSize{1 << 20}; // bytes of the original file per streamed block
+    unsigned threadCount{1};
+    CodingEngine codingEngine{CodingEngine::TWO_PASS};
+    HistogramEngine histogramEngine{HistogramEngine::INTERLEAVED};
+    TreeBuilderEngine treeBuilderEngine{TreeBuilderEngine::TWO_QUEUE};
+    uint64_t blockIndexSize{0}; // bytes of the original file per indexed block, 0 for no block index
+    unsigned decodingTableBits{DecodingTable::DEFAULT_TABLE_BITS};
+};
+
+
+#endif // COMPRESSION_OPTIONS_H
@@ -0,0 +1,26 @@
+// Decoded Range Header and Implementation
+
+// When only a range of the original file is wanted (see HuffmanTree::decompressRange), decoding starts at the sync
+// point of the BlockIndex before the range, or at the start of the Huffman Code, so the characters between there and
+// the range are decoded only to be dropped. A DecodedRange records how many of those are left to drop, where the next
+// character of the range goes in the caller's buffer, and how many characters of the range are still to be decoded.
+// It carries on from one section to the next, so that the blocks of a streamed file can be decoded in turn.
+
+#ifndef DECODED_RANGE_H
+#define DECODED_RANGE_H
+
+
+#include <cstdint>
+
+class DecodedRange {
+public:
+    // public data members
+    uint64_t skip{0}; // characters to decode and drop before the range
+    uint8_t* output{nullptr}; // where the next character of the range is written
+    uint64_t remaining{0}; // characters of the range not yet decoded
+
+    [[nodiscard]] bool done() const { return remaining == 0; }
+};
+
+
+#endif // DECODED_RANGE_H
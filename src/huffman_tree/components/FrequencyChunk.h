@@ -0,0 +1,33 @@
+// Frequency Chunk Header and Implementation
+
+// When a file is compressed with more than one thread, it is split into contiguous chunks, one for each thread. A
+// FrequencyChunk records the byte range of its chunk and the histogram of the characters within that range, which is
+// all that is needed to merge the frequencies of the whole file and to later know exactly how many bits the chunk
+// occupies in the Huffman Code.
+
+#ifndef FREQUENCY_CHUNK_H
+#define FREQUENCY_CHUNK_H
+
+
+#include <cstdint>
+#include <vector>
+
+#include "BlockIndex.h"
+#include "huffman_tree/block_splitter/BlockSplitter.h"
+#include "huffman_tree/histogram/ByteHistogram.h"
+
+class FrequencyChunk {
+public:
+    // public data members
+    uint64_t begin{0}; // byte offset of the chunk in the original file
+    uint64_t end{0};
+    ByteHistogram histogram{};
+    BlockSplitter splitter{}; // only counted when splitting the file into blocks
+    uint64_t bitOffset{0}; // bit offset of the chunk in the Huffman Code
+    uint8_t headByte{0}; // bits of the first byte shared with the previous chunk
+    std::vector<BlockIndexEntry> blockIndexEntries{}; // sync points within the chunk
+    uint32_t checksum{0}; // CRC32C of the characters of the chunk
+};
+
+
+#endif // FREQUENCY_CHUNK_H
@@ -0,0 +1,28 @@
+// Huffman Codeword Header and Implementation
+
+// A HuffmanCodeword is the Huffman Code of a single character stored as an integer rather than a string of '0' and
+// '1' characters. The code is held in the lowest length bits of bits, with the first bit of the code (the first turn
+// taken from the root) being the most significant of those bits. This is the form directly accepted by
+// BitWriter::writeBits.
+
+// The EncodingTable holds the codeword of every character, indexed by the unsigned value of the character.
+
+#ifndef HUFFMAN_CODEWORD_H
+#define HUFFMAN_CODEWORD_H
+
+
+#include <array>
+#include <cstdint>
+
+class HuffmanCodeword {
+public:
+    // public data members
+    uint64_t bits{0};
+    uint8_t length{0}; // 0 indicates that the character does not occur
+};
+
+// https://www.learncpp.com/cpp-tutorial/typedefs-and-type-aliases/
+typedef std::array<HuffmanCodeword, 256> EncodingTable; // simple alias for the encoding table type
+
+
+#endif // HUFFMAN_CODEWORD_H
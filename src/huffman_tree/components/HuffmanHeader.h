@@ -1,8 +1,66 @@
 // Huffman Header Implementation
 
-// This class contains the true byte count of the sections written to file, namely the File Information Code,
-// Tree Representation, and Huffman Code. They are stored and read as 32-bit unsigned integers, which covers the size
-// of most text files. The header written to file will always be 12 bytes.
+// This class contains the true bit count of the sections written to file, namely the File Information Code,
+// Tree Representation, and Huffman Code, along with what is needed to recognize a compressed file and how it was
+// written. Two versions of the header exist.
+
+// Version 1 stores the three lengths as 32-bit unsigned integers and nothing else, so the header written to file is
+// always 12 bytes. This limits the Huffman Code to about 512 MB, and leaves no way of telling a compressed file apart
+// from any other file. Version 1 files can still be read, but have none of the features below.
+
+// Version 2 starts with the magic bytes "HZIP" and a version byte, so that a file which is not a compressed file (or
+// is of a newer version) is rejected after reading only a few bytes. These are followed by the feature flags, the
+// size of the original file and the three lengths, each written as a variable-length integer (varint): 7 bits of the
+// value per byte, least significant group first, with the high bit of each byte set when more bytes follow. Small
+// values take a single byte while any 64-bit value fits in at most 10 bytes.
+
+// https://protobuf.dev/programming-guides/encoding/#varints
+
+// [Magic "HZIP"] > [Version] > [Flags] > [Original Size] > [Info Length] > [Tree Length] > [Encoding Length]
+
+// A file compressed in streaming mode does not know the length of its Huffman Code when the header is written. In that
+// case the STREAMED flag is set, and the Huffman Code section is instead a sequence of blocks, each prefixed by its own
+// bit count as a varint, and terminated by a block with a bit count of 0. Version 1 files are never streamed.
+
+// The BLOCK_INDEX flag is set when a BlockIndex follows the Huffman Code.
+
+// The CANONICAL flag is set when the Huffman Code uses canonical codes, in which case the Tree Representation section
+// holds only the code length of every character (see generateCodeLengthTable) instead of the preorder tree.
+
+// The ADAPTIVE flag is set when the Huffman Code was encoded with an AdaptiveHuffman tree, in a single pass over the
+// original file. The Tree Representation section is then empty, as the decoder builds the same tree as it decodes.
+// The tree carries on from one streamed or piped block to the next.
+
+// The CONTEXT flag is set when every character was encoded with the codes of the cluster of the character before it
+// (see ContextModel), in which case the Tree Representation section holds the tables of every cluster instead of a
+// single code length table. Such a file also has the CANONICAL flag, and its BlockIndex (if any) also holds the
+// character before every sync point.
+
+// The SPLIT flag is likewise set when the original file was cut into blocks which each have their own table or reuse
+// the table of the block before (see BlockSplitter), in which case the Tree Representation section holds the header
+// of every block, and the Huffman Code of every block follows that of the block before it.
+
+// The DICTIONARY flag is set when the file was encoded with the codes of a Dictionary trained beforehand, in which case
+// the Tree Representation section holds only the 32-bit ID of the dictionary, which must be given to decompress the
+// file. Such a file also has the CANONICAL flag.
+
+// The CHECKSUM flag is set when the CRC32C of the original file (see checksum_utils) follows the Huffman Code as a
+// 32-bit unsigned integer, after the terminating block of a streamed file or piped stream, and before any BlockIndex,
+// which is found from the end of the file. The decompressed file is rejected when its CRC32C differs.
+
+// The INTERLEAVED flag is set when the characters of every block of the Huffman Code are split between several bit
+// streams, each block with a header of its own (see InterleavedStreams). Only a file with a single table, its own or
+// that of a Dictionary, can have the flag, and never a streamed file or piped stream.
+
+// The PIPED flag is set for a stream compressed from a pipe, whose size is not known and which cannot be read twice
+// (see HuffmanTree::compressPiped). The header then has an original size and lengths of 0, and is followed by a
+// sequence of blocks, each with its own canonical codes counted from that block alone (or with an empty table when
+// adaptive), and terminated by a block with an original size of 0:
+
+// [Original Size] > [Table Length] > [Encoding Length] > [Code Length Table] > [Huffman Code]
+
+// The three lengths are varints, and both sections are padded to whole bytes. A file with a flag this program does
+// not know is rejected, as it cannot be read correctly.
 
 // Not relevant to this project, but further reading about big-endian and little-endian systems could be interesting.
 // https://library.mosse-institute.com/articles/2022/04/endian-systems-explained-little-endian-vs-big-endian/endian-systems-explained-little-endian-vs-big-endian.html
@@ -15,14 +73,36 @@
 
 class HuffmanHeader {
 public:
+    static constexpr uint8_t MAGIC[4]{'H', 'Z', 'I', 'P'};
+    static constexpr uint8_t CURRENT_VERSION{2};
+
+    // feature flags
+    static constexpr uint64_t STREAMED{1 << 0};
+    static constexpr uint64_t BLOCK_INDEX{1 << 1};
+    static constexpr uint64_t CANONICAL{1 << 2};
+    static constexpr uint64_t PIPED{1 << 3};
+    static constexpr uint64_t ADAPTIVE{1 << 4};
+    static constexpr uint64_t CONTEXT{1 << 5};
+    static constexpr uint64_t SPLIT{1 << 6};
+    static constexpr uint64_t DICTIONARY{1 << 7};
+    static constexpr uint64_t CHECKSUM{1 << 8};
+    static constexpr uint64_t INTERLEAVED{1 << 9};
+    static constexpr uint64_t KNOWN_FLAGS{STREAMED | BLOCK_INDEX | CANONICAL | PIPED | ADAPTIVE | CONTEXT | SPLIT |
+        DICTIONARY | CHECKSUM | INTERLEAVED};
+
     // constructor
-    HuffmanHeader(uint32_t iLength, uint32_t tLength, uint32_t eLength)
+    HuffmanHeader(uint64_t iLength, uint64_t tLength, uint64_t eLength)
         : infoLength(iLength), treeLength(tLength), encodingLength(eLength) {}
 
     // data members
-    uint32_t infoLength{};
-    uint32_t treeLength{};
-    uint32_t encodingLength{};
+    uint8_t version{CURRENT_VERSION};
+    uint64_t flags{0};
+    uint64_t originalSize{0};
+    uint64_t infoLength{};
+    uint64_t treeLength{};
+    uint64_t encodingLength{};
+
+    [[nodiscard]] bool hasFlag(uint64_t flag) const { return (flags & flag) != 0; }
 };
 
 
@@ -0,0 +1,229 @@
+// Context Model Implementation
+
+#include "ContextModel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "huffman_tree/bit_stream/PackedBits.h"
+#include "utils/generate/generate_utils.h"
+
+void ContextModel::reset() {
+    clusters.fill(0);
+    encodingTables.clear();
+    decodingTables.clear();
+    encodedBits = 0;
+    previous = 0;
+}
+
+bool ContextModel::build(const ContextHistogram& histogram, TreeBuilderEngine engine, unsigned maxCodeLength,
+                         uint64_t singleTableBits) {
+    reset();
+    if (histogram.total() < MIN_ORIGINAL_SIZE) {
+        return false;
+    }
+
+    // try each number of tables, keeping the smallest Huffman Code and tables found so far
+    uint64_t bestBits{singleTableBits};
+    ContextClusters bestClusters{};
+    std::vector<EncodingTable> bestTables{};
+    uint64_t bestEncodedBits{0};
+    for (unsigned tableCount{2}; tableCount <= MAX_TABLES; tableCount *= 2) {
+        cluster(histogram, tableCount, clusters);
+        encodedBits = buildTables(histogram, clusters, engine, maxCodeLength, encodingTables);
+
+        PackedBits representation{};
+        generateContextTables(representation, *this);
+        if (encodedBits + representation.bitLength < bestBits) {
+            bestBits = encodedBits + representation.bitLength;
+            bestClusters = clusters;
+            bestTables = encodingTables;
+            bestEncodedBits = encodedBits;
+        }
+    }
+
+    clusters = bestClusters;
+    encodingTables = bestTables;
+    encodedBits = bestEncodedBits;
+    return !encodingTables.empty();
+}
+
+bool ContextModel::setTables(const ContextClusters& contextClusters, const std::vector<EncodingTable>& tables,
+                             unsigned decodingTableBits) {
+    reset();
+
+    // every context must refer to one of the tables
+    for (uint8_t table : contextClusters) {
+        if (table >= tables.size()) {
+            return false;
+        }
+    }
+
+    clusters = contextClusters;
+    encodingTables = tables;
+    for (const EncodingTable& table : encodingTables) {
+        decodingTables.emplace_back(table, decodingTableBits);
+    }
+    return true;
+}
+
+void ContextModel::encode(const uint8_t* data, std::size_t size, BitWriter& writer) {
+    encode(data, size, writer, previous);
+}
+
+void ContextModel::encode(const uint8_t* data, std::size_t size, BitWriter& writer, uint8_t& previousCharacter) const {
+    for (std::size_t i{0}; i < size; ++i) {
+        const HuffmanCodeword& codeword{encodingTables[clusters[previousCharacter]][data[i]]};
+        writer.writeBits(codeword.bits, codeword.length);
+        previousCharacter = data[i];
+    }
+}
+
+std::size_t ContextModel::decode(BitReader& reader, uint64_t bitLength, uint8_t* output, std::size_t capacity,
+                                 bool& corrupted) {
+    return decode(reader, bitLength, output, capacity, corrupted, previous);
+}
+
+std::size_t ContextModel::decode(BitReader& reader, uint64_t bitLength, uint8_t* output, std::size_t capacity,
+                                 bool& corrupted, uint8_t& previousCharacter) const {
+    std::size_t count{0};
+
+    // each character is decoded with the table of the character before it
+    while (count < capacity && reader.position() < bitLength) {
+        if (!decodingTables[clusters[previousCharacter]].decodeCharacter(reader, previousCharacter)) {
+            corrupted = true;
+            break;
+        }
+        output[count++] = previousCharacter;
+    }
+
+    return count;
+}
+
+unsigned ContextModel::indexBits(unsigned tableCount) {
+    unsigned bits{0};
+    while (((tableCount - 1) >> bits) != 0) {
+        ++bits;
+    }
+    return bits;
+}
+
+void ContextModel::cluster(const ContextHistogram& histogram, unsigned tableCount, ContextClusters& result) {
+    result.fill(0);
+
+    // the contexts which occur, from the most to the least frequent, with the characters which follow each of them
+    std::array<uint64_t, ContextHistogram::CONTEXT_COUNT> contextTotals{};
+    std::vector<uint8_t> contexts{};
+    std::vector<std::vector<uint8_t>> followers(ContextHistogram::CONTEXT_COUNT);
+    for (std::size_t context{0}; context < ContextHistogram::CONTEXT_COUNT; ++context) {
+        const uint64_t* row{histogram.row(static_cast<uint8_t>(context))};
+        for (std::size_t character{0}; character < 256; ++character) {
+            if (row[character] != 0) {
+                contextTotals[context] += row[character];
+                followers[context].push_back(static_cast<uint8_t>(character));
+            }
+        }
+        if (contextTotals[context] != 0) {
+            contexts.push_back(static_cast<uint8_t>(context));
+        }
+    }
+    std::stable_sort(contexts.begin(), contexts.end(), [&contextTotals](uint8_t a, uint8_t b) {
+        return contextTotals[a] > contextTotals[b];
+    });
+
+    // seed every cluster with one of the most frequent contexts
+    tableCount = std::min<unsigned>(tableCount, static_cast<unsigned>(contexts.size()));
+    std::vector<std::array<uint64_t, 256>> clusterFrequencies(tableCount);
+    for (unsigned table{0}; table < tableCount; ++table) {
+        const uint64_t* row{histogram.row(contexts[table])};
+        std::copy(row, row + 256, clusterFrequencies[table].begin());
+    }
+
+    std::vector<std::array<double, 256>> costs(tableCount);
+    for (unsigned iteration{0}; iteration < MAX_ITERATIONS; ++iteration) {
+        // estimate the bits taken by every character in every cluster
+        for (unsigned table{0}; table < tableCount; ++table) {
+            uint64_t total{0};
+            for (uint64_t frequency : clusterFrequencies[table]) {
+                total += frequency;
+            }
+            for (std::size_t character{0}; character < 256; ++character) {
+                costs[table][character] = std::log2((static_cast<double>(total) + 128.0) /
+                                                    (static_cast<double>(clusterFrequencies[table][character]) + 0.5));
+            }
+        }
+
+        // move every context to the cluster which encodes it in the fewest bits
+        bool moved{false};
+        for (uint8_t context : contexts) {
+            const uint64_t* row{histogram.row(context)};
+            double bestCost{std::numeric_limits<double>::max()};
+            uint8_t bestTable{0};
+            for (unsigned table{0}; table < tableCount; ++table) {
+                double cost{0};
+                for (uint8_t character : followers[context]) {
+                    cost += static_cast<double>(row[character]) * costs[table][character];
+                }
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestTable = static_cast<uint8_t>(table);
+                }
+            }
+            moved = moved || iteration == 0 || result[context] != bestTable;
+            result[context] = bestTable;
+        }
+        if (!moved) {
+            break;
+        }
+
+        // recount the frequencies of every cluster
+        for (std::array<uint64_t, 256>& frequencies : clusterFrequencies) {
+            frequencies.fill(0);
+        }
+        for (uint8_t context : contexts) {
+            const uint64_t* row{histogram.row(context)};
+            for (uint8_t character : followers[context]) {
+                clusterFrequencies[result[context]][character] += row[character];
+            }
+        }
+    }
+
+    // renumber the clusters left with contexts, in order, so that no table is empty
+    std::array<int, MAX_TABLES> renumbered{};
+    renumbered.fill(-1);
+    int nextTable{0};
+    for (uint8_t context : contexts) {
+        if (renumbered[result[context]] == -1) {
+            renumbered[result[context]] = nextTable++;
+        }
+    }
+    for (uint8_t context : contexts) {
+        result[context] = static_cast<uint8_t>(renumbered[result[context]]);
+    }
+}
+
+uint64_t ContextModel::buildTables(const ContextHistogram& histogram, const ContextClusters& contextClusters,
+                                   TreeBuilderEngine engine, unsigned maxCodeLength,
+                                   std::vector<EncodingTable>& tables) {
+    // combine the frequencies of the contexts of each cluster
+    std::size_t tableCount{static_cast<std::size_t>(*std::max_element(contextClusters.begin(),
+                                                                       contextClusters.end())) + 1};
+    std::vector<ByteHistogram> clusterHistograms(tableCount);
+    for (std::size_t context{0}; context < ContextHistogram::CONTEXT_COUNT; ++context) {
+        const uint64_t* row{histogram.row(static_cast<uint8_t>(context))};
+        ByteHistogram& clusterHistogram{clusterHistograms[contextClusters[context]]};
+        for (std::size_t character{0}; character < 256; ++character) {
+            clusterHistogram.frequencies[character] += row[character];
+        }
+    }
+
+    // build the canonical codes of each cluster as for a single Huffman Tree
+    tables.assign(tableCount, EncodingTable{});
+    uint64_t encodedBits{0};
+    for (std::size_t table{0}; table < tableCount; ++table) {
+        encodedBits += generateLimitedEncodingTable(tables[table], clusterHistograms[table], engine, maxCodeLength);
+    }
+
+    return encodedBits;
+}
@@ -0,0 +1,103 @@
+// Context Model Header
+
+// A single Huffman Tree gives every character the same code wherever it appears, which is the best that can be done
+// knowing only how often each character occurs (an order-0 model). Knowing the previous character as well (an order-1
+// model) does better on text, where the previous character says a lot about the next one (see ContextHistogram), by
+// encoding every character with a code built for what usually follows the character before it.
+
+// https://en.wikipedia.org/wiki/Prediction_by_partial_matching
+
+// A table for each of the 256 previous characters (contexts) would cost more to write to file than it saves on all but
+// the largest files, and most contexts are followed by much the same characters anyway (every lowercase vowel, say).
+// The contexts are therefore clustered into at most MAX_TABLES clusters, and a Huffman Tree is built from the combined
+// frequencies of each cluster, with its codes written as a code length table like any canonical file.
+
+// The contexts are clustered with k-means: the most frequent contexts seed the clusters, and then every context is
+// moved to the cluster whose codes would encode it in the fewest bits, and the frequencies of every cluster recounted,
+// until no context moves. The number of bits a code takes is estimated from the frequencies of the cluster as
+// log2(total / frequency) (its information content), with every character given half an occurrence in every cluster,
+// so that the cost of a character not yet in the cluster is high but not infinite.
+
+// https://en.wikipedia.org/wiki/K-means_clustering
+
+// build clusters the contexts into 2, 4, 8 and 16 clusters, and keeps whichever makes the file the smallest once its
+// tables are counted, but only when that is smaller than the single Huffman Tree (its table included). A file of
+// fewer than MIN_ORIGINAL_SIZE bytes always keeps the single table, as its tables would cost more than they save.
+
+// The Tree Representation section of a file with context tables (marked by the CONTEXT flag of the header) holds the
+// number of tables, the table of every context, and then the code length table of each cluster:
+
+// [Table Count - 1 (4 bits)] > [Table of Each Context (256 * index bits)] > [Code Length Table] > ...
+
+// where the index bits are the fewest bits which can hold the table count - 1 (see generateContextTables and
+// instantiateContextModel). encode and decode carry the previous character from one call to the next, starting
+// from 0, so the blocks of a file must be encoded and decoded in order, unless seek first sets the previous character
+// to that recorded at a sync point of the BlockIndex. The overloads taking previousCharacter carry it in the caller's
+// variable instead and leave the model unchanged, so that several threads can encode or decode different parts of a
+// file with the same tables at once (see parallel_utils).
+
+#ifndef CONTEXT_MODEL_H
+#define CONTEXT_MODEL_H
+
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "huffman_tree/bit_stream/BitReader.h"
+#include "huffman_tree/bit_stream/BitWriter.h"
+#include "huffman_tree/components/HuffmanCodeword.h"
+#include "huffman_tree/decoding_table/DecodingTable.h"
+#include "huffman_tree/histogram/ContextHistogram.h"
+#include "huffman_tree/tree_builder/TreeBuilder.h"
+
+typedef std::array<uint8_t, ContextHistogram::CONTEXT_COUNT> ContextClusters; // the table of every context
+
+class ContextModel {
+public:
+    static constexpr unsigned MAX_TABLES{16};
+    static constexpr unsigned TABLE_COUNT_BITS{4};
+    static constexpr uint64_t MIN_ORIGINAL_SIZE{1 << 12};
+    static constexpr unsigned MAX_ITERATIONS{16}; // of the k-means clustering
+
+    void reset(); // post-condition: there are no tables, and the previous character is 0
+
+    // builds the context tables, returning false (with no tables) if they do not make the Huffman Code and its tables
+    // smaller than singleTableBits
+    bool build(const ContextHistogram& histogram, TreeBuilderEngine engine, unsigned maxCodeLength,
+               uint64_t singleTableBits);
+    // replaces the tables with those read from file, returning false if they are invalid
+    bool setTables(const ContextClusters& clusters, const std::vector<EncodingTable>& tables,
+                   unsigned decodingTableBits);
+
+    void encode(const uint8_t* data, std::size_t size, BitWriter& writer);
+    void encode(const uint8_t* data, std::size_t size, BitWriter& writer, uint8_t& previousCharacter) const;
+    // decodes up to capacity characters, stopping at bitLength
+    std::size_t decode(BitReader& reader, uint64_t bitLength, uint8_t* output, std::size_t capacity, bool& corrupted);
+    std::size_t decode(BitReader& reader, uint64_t bitLength, uint8_t* output, std::size_t capacity, bool& corrupted,
+                       uint8_t& previousCharacter) const;
+    void seek(uint8_t previousCharacter) { previous = previousCharacter; } // continues after previousCharacter
+
+    // getters
+    [[nodiscard]] const ContextClusters& getClusters() const { return clusters; }
+    [[nodiscard]] const std::vector<EncodingTable>& getEncodingTables() const { return encodingTables; }
+    [[nodiscard]] unsigned getTableCount() const { return static_cast<unsigned>(encodingTables.size()); }
+    [[nodiscard]] uint64_t getEncodedBits() const { return encodedBits; } // bits of the Huffman Code, once built
+    [[nodiscard]] static unsigned indexBits(unsigned tableCount); // bits of the table index of each context
+
+private:
+    ContextClusters clusters{};
+    std::vector<EncodingTable> encodingTables{};
+    std::vector<DecodingTable> decodingTables{}; // only when decompressing
+    uint64_t encodedBits{0};
+    uint8_t previous{0};
+
+    static void cluster(const ContextHistogram& histogram, unsigned tableCount, ContextClusters& result);
+    // returns the number of bits of the Huffman Code
+    static uint64_t buildTables(const ContextHistogram& histogram, const ContextClusters& contextClusters,
+                                TreeBuilderEngine engine, unsigned maxCodeLength, std::vector<EncodingTable>& tables);
+};
+
+
+#endif // CONTEXT_MODEL_H
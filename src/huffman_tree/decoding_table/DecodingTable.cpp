@@ -0,0 +1,174 @@
+// Decoding Table Implementation
+
+#include "DecodingTable.h"
+
+#include <algorithm>
+
+DecodingTable::DecodingTable(const EncodingTable& encodingTable, unsigned tableBits)
+    : primaryBits(std::clamp(tableBits, MIN_TABLE_BITS, MAX_TABLE_BITS)) {
+    // gather every code which occurs
+    std::vector<PartialCode> codes{};
+    for (std::size_t character{0}; character < encodingTable.size(); ++character) {
+        const HuffmanCodeword& codeword{encodingTable[character]};
+        if (codeword.length != 0) {
+            codes.push_back(PartialCode{codeword.bits, codeword.length, static_cast<uint8_t>(character)});
+            longestCode = std::max(longestCode, static_cast<unsigned>(codeword.length));
+        }
+    }
+
+    buildLevel(codes, primaryBits);
+}
+
+std::size_t DecodingTable::buildLevel(const std::vector<PartialCode>& codes, unsigned levelBits) {
+    std::size_t base{entries.size()};
+    entries.resize(base + (std::size_t{1} << levelBits));
+
+    // codes which end within this level fill every entry they are a prefix of
+    // codes which are longer are grouped by their first levelBits bits for a secondary table
+    std::vector<std::vector<PartialCode>> longCodes(std::size_t{1} << levelBits);
+    for (const PartialCode& code : codes) {
+        if (code.length <= levelBits) {
+            std::size_t first{static_cast<std::size_t>(code.bits) << (levelBits - code.length)};
+            std::size_t last{first + (std::size_t{1} << (levelBits - code.length))};
+            for (std::size_t i{first}; i < last; ++i) {
+                entries[base + i] = Entry{code.character, code.length, 0};
+            }
+        } else {
+            unsigned remainingLength{code.length - levelBits};
+            std::size_t prefix{static_cast<std::size_t>(code.bits >> remainingLength)};
+            uint64_t remainingBits{code.bits & ((uint64_t{1} << remainingLength) - 1)};
+            longCodes[prefix].push_back(PartialCode{remainingBits, static_cast<uint8_t>(remainingLength),
+                                                    code.character});
+        }
+    }
+
+    // build secondary tables only as wide as the longest code that uses them
+    for (std::size_t prefix{0}; prefix < longCodes.size(); ++prefix) {
+        if (longCodes[prefix].empty()) {
+            continue;
+        }
+
+        unsigned maxLength{0};
+        for (const PartialCode& code : longCodes[prefix]) {
+            maxLength = std::max(maxLength, static_cast<unsigned>(code.length));
+        }
+
+        unsigned subTableBits{std::min(maxLength, primaryBits)};
+        std::size_t subTable{buildLevel(longCodes[prefix], subTableBits)}; // may resize entries
+        entries[base + prefix] = Entry{static_cast<uint32_t>(subTable), static_cast<uint8_t>(levelBits),
+                                       static_cast<uint8_t>(subTableBits)};
+    }
+
+    return base;
+}
+
+std::size_t DecodingTable::decode(BitReader& reader, uint64_t bitLength, uint8_t* output, std::size_t capacity,
+                                  bool& corrupted) const {
+    const Entry* table{entries.data()};
+    std::size_t count{0};
+
+    // a table with codes too long to be decoded from the filled bits is decoded one checked character at a time
+    if (longestCode > BitReader::FILL_BITS) {
+        while (count < capacity && reader.position() < bitLength) {
+            if (!decodeCharacter(reader, output[count])) {
+                corrupted = true;
+                break;
+            }
+            ++count;
+        }
+        return count;
+    }
+
+    // otherwise fill the reader once for as many characters as the filled bits hold, decoding them from copies of the
+    // bits and the table width (as they would otherwise be reloaded after every character written to output, which
+    // may alias them)
+    unsigned tableBits{primaryBits};
+    while (count < capacity && reader.position() < bitLength) {
+        reader.fill();
+        uint64_t bits{reader.peekFilled(64)};
+        uint64_t usableBits{reader.filledBits() - longestCode}; // a character starting after these may not be filled
+        uint64_t endBits{bitLength - reader.position()};
+        uint64_t usedBits{0};
+        do {
+            unsigned length{decodeBits(table, tableBits, bits, output[count])};
+            if (length == 0) {
+                reader.skipFilled(static_cast<unsigned>(usedBits));
+                corrupted = true;
+                return count;
+            }
+            bits <<= length;
+            usedBits += length;
+            ++count;
+        } while (usedBits <= usableBits && usedBits < endBits && count < capacity);
+        reader.skipFilled(static_cast<unsigned>(usedBits));
+    }
+
+    return count;
+}
+
+bool DecodingTable::decodeCharacter(BitReader& reader, uint8_t& character) const {
+    // the same as a single character of decode
+    const Entry* entry{&entries[reader.peekBits(primaryBits)]};
+    while (entry->subTableBits != 0) {
+        reader.skipBits(entry->length);
+        entry = &entries[entry->value + reader.peekBits(entry->subTableBits)];
+    }
+    if (entry->length == 0) {
+        return false;
+    }
+
+    reader.skipBits(entry->length);
+    character = static_cast<uint8_t>(entry->value);
+    return true;
+}
+
+bool DecodingTable::decodeInterleaved(BitReader* readers, std::size_t readerCount, std::size_t firstReader,
+                                      uint8_t* output, std::size_t count) const {
+    const Entry* table{entries.data()};
+    std::size_t i{0};
+
+    // one character at a time until the next character is that of the first reader
+    for (std::size_t next{firstReader}; i < count && next != 0; ++i) {
+        if (!decodeCharacter(readers[next], output[i])) {
+            return false;
+        }
+        next = next + 1 == readerCount ? 0 : next + 1;
+    }
+
+    // then whole rounds of charactersPerFill characters from every reader, each reader filled once per round
+    std::size_t charactersPerFill{longestCode == 0 ? 0 : BitReader::FILL_BITS / longestCode};
+    std::size_t roundSize{readerCount * charactersPerFill};
+    for (; roundSize != 0 && count - i >= roundSize; i += roundSize) {
+        for (std::size_t j{0}; j < readerCount; ++j) {
+            readers[j].fill();
+        }
+
+        uint8_t* round{output + i};
+        for (std::size_t k{0}; k < charactersPerFill; ++k) {
+            for (std::size_t j{0}; j < readerCount; ++j) {
+                BitReader& reader{readers[j]};
+                const Entry* entry{&table[reader.peekFilled(primaryBits)]};
+                while (entry->subTableBits != 0) {
+                    reader.skipFilled(entry->length);
+                    entry = &table[entry->value + reader.peekFilled(entry->subTableBits)];
+                }
+                if (entry->length == 0) {
+                    return false;
+                }
+
+                reader.skipFilled(entry->length);
+                round[k * readerCount + j] = static_cast<uint8_t>(entry->value);
+            }
+        }
+    }
+
+    // and the characters after the last whole round one at a time
+    for (std::size_t next{0}; i < count; ++i) {
+        if (!decodeCharacter(readers[next], output[i])) {
+            return false;
+        }
+        next = next + 1 == readerCount ? 0 : next + 1;
+    }
+
+    return true;
+}
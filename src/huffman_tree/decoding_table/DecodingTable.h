@@ -0,0 +1,116 @@
+// Decoding Table Header
+
+// Walking the Huffman Tree one bit at a time requires a branch and a pointer dereference for every bit of the Huffman
+// Code. The DecodingTable instead resolves a whole character per lookup: the next tableBits bits of the code are
+// used as an index into a table of 2^tableBits entries, and the entry holds both the character and the true length of
+// its code, so that the reader can skip exactly that many bits. Every index that starts with the same code of length
+// L <= tableBits holds the same entry (2^(tableBits - L) copies of it).
+
+// Codes longer than tableBits cannot be resolved by the primary table alone. For these, the primary entry links to a
+// secondary table that is indexed by the bits following the first tableBits bits. A secondary table is only as wide
+// as the longest code sharing its prefix requires (and never wider than tableBits), and may in turn link to further
+// tables, so a code of any length can be decoded. Since long codes belong to rare characters, the secondary tables
+// are seldom visited.
+
+// The table width is configurable between 8 and 12 bits. Wider tables resolve more codes in a single lookup at the cost
+// of a longer build and more cache pressure; 11 bits is a good default for text files.
+
+// The table is built from the encoding table (character to code mapping) of the Huffman Tree, so any tree that can be
+// encoded can also be decoded this way. An entry with length 0 corresponds to a bit sequence that is not the prefix of
+// any code, which can only happen with a corrupted file.
+
+// decode does not check for a refill of the reader on every character. It fills the reader once (see BitReader::fill),
+// after which the reader holds at least FILL_BITS bits, and decodes characters from the filled bits without checking
+// them for as long as they still hold the longest code of the table, which is about 10 characters of text for every
+// refill with codes of up to 15 bits. A table with codes longer than FILL_BITS is decoded one checked character at a
+// time instead.
+
+// decodeInterleaved decodes characters which were written to several bit streams in turn (see InterleavedStreams).
+// Each lookup of a stream depends on the length of the code before it in the same stream only, so the lookups of
+// neighbouring streams do not wait for each other, and the processor works on all of them at once. As no code is
+// longer than the longest code of the table, every reader is filled once for as many characters as BitReader::FILL_BITS
+// always holds (3 with codes of up to 15 bits), and those characters are decoded without checking the buffered bits.
+
+#ifndef DECODING_TABLE_H
+#define DECODING_TABLE_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "huffman_tree/bit_stream/BitReader.h"
+#include "huffman_tree/components/HuffmanCodeword.h"
+
+class DecodingTable {
+public:
+    static constexpr unsigned MIN_TABLE_BITS{8};
+    static constexpr unsigned MAX_TABLE_BITS{12};
+    static constexpr unsigned DEFAULT_TABLE_BITS{11};
+
+    // constructor
+    explicit DecodingTable(const EncodingTable& encodingTable,
+                           unsigned tableBits = DEFAULT_TABLE_BITS);
+
+    // decodes characters into output until bitLength bits of the reader have been consumed or capacity is reached.
+    // returns the number of characters written, setting corrupted if an invalid code is found
+    std::size_t decode(BitReader& reader, uint64_t bitLength, uint8_t* output, std::size_t capacity,
+                       bool& corrupted) const;
+    // decodes a single character, returning false if an invalid code is found
+    bool decodeCharacter(BitReader& reader, uint8_t& character) const;
+    // decodes count characters from readers in turn, starting with firstReader, returning false if an invalid code is
+    // found (see InterleavedStreams)
+    bool decodeInterleaved(BitReader* readers, std::size_t readerCount, std::size_t firstReader, uint8_t* output,
+                           std::size_t count) const;
+
+    [[nodiscard]] unsigned getTableBits() const { return primaryBits; }
+
+private:
+    // a leaf entry holds a character in value; a link entry holds the index of a secondary table in value and its
+    // width in subTableBits. length is the number of bits consumed at this level of the table.
+    class Entry {
+    public:
+        uint32_t value{0};
+        uint8_t length{0};
+        uint8_t subTableBits{0};
+    };
+
+    // a code relative to the table level being built: its remaining bits after the prefix of the parent tables
+    class PartialCode {
+    public:
+        uint64_t bits{0};
+        uint8_t length{0};
+        uint8_t character{0};
+    };
+
+    unsigned primaryBits{DEFAULT_TABLE_BITS};
+    unsigned longestCode{0};
+    std::vector<Entry> entries{}; // primary table first, followed by every secondary table
+
+    std::size_t buildLevel(const std::vector<PartialCode>& codes, unsigned levelBits); // returns index of the level
+    // decodes the character whose code starts at the most significant bit of bits, which must hold the whole code,
+    // returning the length of the code, or 0 if the code is invalid
+    static unsigned decodeBits(const Entry* table, unsigned primaryBits, uint64_t bits, uint8_t& character);
+};
+
+// decodeBits is called for every character decoded, so it is inline
+
+inline unsigned DecodingTable::decodeBits(const Entry* table, unsigned primaryBits, uint64_t bits, uint8_t& character) {
+    // the same as a single character of decodeCharacter, on bits which are already at hand (every entry is copied, so
+    // that writing the character does not reload it)
+    Entry entry{table[bits >> (64 - primaryBits)]};
+    unsigned length{0};
+    while (entry.subTableBits != 0) {
+        length += entry.length;
+        bits <<= entry.length;
+        entry = table[entry.value + (bits >> (64 - entry.subTableBits))];
+    }
+    if (entry.length == 0) {
+        return 0;
+    }
+
+    character = static_cast<uint8_t>(entry.value);
+    return length + entry.length;
+}
+
+#endif // DECODING_TABLE_H
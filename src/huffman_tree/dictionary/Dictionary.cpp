@@ -0,0 +1,54 @@
+// Dictionary Implementation
+
+#include "Dictionary.h"
+
+#include <cstdio>
+
+#include "utils/generate/generate_utils.h"
+
+void Dictionary::build(const ByteHistogram& histogram, TreeBuilderEngine engine, unsigned maxCodeLength,
+                       unsigned decodingTableBits) {
+    // count every character once more, so that even characters the sample lacks have a code
+    ByteHistogram trainingHistogram{histogram};
+    for (uint64_t& frequency : trainingHistogram.frequencies) {
+        ++frequency;
+    }
+
+    EncodingTable table{};
+    generateLimitedEncodingTable(table, trainingHistogram, engine, maxCodeLength);
+    setTable(table, decodingTableBits);
+}
+
+void Dictionary::setTable(const EncodingTable& table, unsigned decodingTableBits) {
+    encodingTable = table;
+    decodingTable = DecodingTable{encodingTable, decodingTableBits};
+    id = computeId(encodingTable);
+}
+
+bool Dictionary::encodedBits(const ByteHistogram& histogram, uint64_t& bits) const {
+    bits = 0;
+    for (std::size_t character{0}; character < encodingTable.size(); ++character) {
+        uint64_t frequency{histogram.frequencies[character]};
+        if (frequency != 0 && encodingTable[character].length == 0) {
+            return false;
+        }
+        bits += frequency * encodingTable[character].length;
+    }
+    return true;
+}
+
+uint32_t Dictionary::computeId(const EncodingTable& table) {
+    // FNV-1a over the code length of every character, which is all the canonical codes depend on
+    uint32_t hash{2166136261u};
+    for (const HuffmanCodeword& codeword : table) {
+        hash ^= codeword.length;
+        hash *= 16777619u;
+    }
+    return hash == 0 ? 1 : hash;
+}
+
+std::string Dictionary::formatId(uint32_t id) {
+    char digits[9]{};
+    std::snprintf(digits, sizeof(digits), "%08x", static_cast<unsigned>(id));
+    return digits;
+}
@@ -0,0 +1,69 @@
+// Dictionary Header
+
+// Every compressed file carries its own code length table, which is small next to a large file but is most of the
+// compressed size of a small one, so that a file of a few hundred bytes can even grow when compressed. Many small
+// files of the same kind (JSON records, say) have much the same frequencies anyway, so a Dictionary instead holds a
+// single table trained on a sample of such files, which a compressed file refers to by its ID rather than embedding.
+
+// build trains the table from the combined histogram of the sample files, the same way as the table of a single file
+// (see generateLimitedEncodingTable), except that every character is counted once more than it occurs, so that every
+// character has a code and any file can be encoded with the dictionary, even with characters the sample lacks.
+
+// The ID is the FNV-1a hash of the code lengths, so two dictionaries with the same ID have the same codes, and a file
+// is never decoded with the codes of another dictionary by mistake (other than by a hash collision). An ID of 0 is
+// never used, so that it can mean that no dictionary was used.
+
+// https://en.wikipedia.org/wiki/Fowler%E2%80%93Noll%E2%80%93Vo_hash_function
+
+// A dictionary file (written by writeDictionaryFile and read by readDictionaryFile) holds the magic bytes "HZDC", a
+// version byte, the ID as a 32-bit unsigned integer, and the code length table (see generateCodeLengthTable):
+
+// [Magic "HZDC"] > [Version] > [ID] > [Code Length Table]
+
+// The DecodingTable of the dictionary is built once when its table is set, so that the files compressed with it do not
+// each build their own (see DictionaryCache).
+
+#ifndef DICTIONARY_H
+#define DICTIONARY_H
+
+
+#include <cstdint>
+#include <string>
+
+#include "huffman_tree/components/HuffmanCodeword.h"
+#include "huffman_tree/decoding_table/DecodingTable.h"
+#include "huffman_tree/histogram/ByteHistogram.h"
+#include "huffman_tree/tree_builder/TreeBuilder.h"
+
+class Dictionary {
+public:
+    static constexpr uint8_t MAGIC[4]{'H', 'Z', 'D', 'C'};
+    static constexpr uint8_t CURRENT_VERSION{1};
+    static constexpr unsigned ID_BITS{32};
+
+    // trains the table from the frequencies of the sample files
+    void build(const ByteHistogram& histogram, TreeBuilderEngine engine, unsigned maxCodeLength,
+               unsigned decodingTableBits = DecodingTable::DEFAULT_TABLE_BITS);
+    // replaces the table with one read from file
+    void setTable(const EncodingTable& table, unsigned decodingTableBits = DecodingTable::DEFAULT_TABLE_BITS);
+
+    // sets bits to the number of bits the histogram takes with the codes of the dictionary, returning false if any of
+    // its characters has no code
+    bool encodedBits(const ByteHistogram& histogram, uint64_t& bits) const;
+
+    // getters
+    [[nodiscard]] uint32_t getId() const { return id; }
+    [[nodiscard]] const EncodingTable& getEncodingTable() const { return encodingTable; }
+    [[nodiscard]] const DecodingTable& getDecodingTable() const { return decodingTable; }
+
+    [[nodiscard]] static uint32_t computeId(const EncodingTable& table);
+    [[nodiscard]] static std::string formatId(uint32_t id); // as 8 hexadecimal digits
+
+private:
+    uint32_t id{0};
+    EncodingTable encodingTable{};
+    DecodingTable decodingTable{EncodingTable{}};
+};
+
+
+#endif // DICTIONARY_H
@@ -0,0 +1,48 @@
+// Dictionary Cache Implementation
+
+#include "DictionaryCache.h"
+
+#include <iostream>
+
+#include "input_source/InputSource.h"
+#include "utils/compression/compression_utils.h"
+
+bool DictionaryCache::load(const std::string& path, unsigned decodingTableBits) {
+    InputSource input{path};
+    if (!input.isOpen()) {
+        std::cout << "Error: Failed to read dictionary file " << path << ".\n";
+        return false;
+    }
+
+    Dictionary dictionary{};
+    if (!readDictionaryFile(input, dictionary, decodingTableBits)) {
+        return false;
+    }
+
+    // a dictionary with the same ID has the same codes, so only the first is kept
+    if (find(dictionary.getId()) == nullptr) {
+        dictionaries.push_back(dictionary);
+    }
+    return true;
+}
+
+const Dictionary* DictionaryCache::find(uint32_t id) const {
+    for (const Dictionary& dictionary : dictionaries) {
+        if (dictionary.getId() == id) {
+            return &dictionary;
+        }
+    }
+    return nullptr;
+}
+
+const Dictionary* DictionaryCache::findSmallest(const ByteHistogram& histogram, uint64_t& bits) const {
+    const Dictionary* smallest{nullptr};
+    for (const Dictionary& dictionary : dictionaries) {
+        uint64_t dictionaryBits{0};
+        if (dictionary.encodedBits(histogram, dictionaryBits) && (smallest == nullptr || dictionaryBits < bits)) {
+            smallest = &dictionary;
+            bits = dictionaryBits;
+        }
+    }
+    return smallest;
+}
@@ -0,0 +1,41 @@
+// Dictionary Cache Header
+
+// A file compressed with a Dictionary holds only its ID, so every dictionary which files may have been compressed with
+// must be given when they are decompressed. The DictionaryCache loads each dictionary file once, before any file is
+// compressed or decompressed, and then hands out the same Dictionary (with its DecodingTable already built) to every
+// file, so that a batch of small files does not read and build the same table for each of them.
+
+// find looks a dictionary up by the ID a compressed file refers to, while findSmallest picks the dictionary which
+// encodes a file in the fewest bits when compressing. Neither changes the cache, so once loaded it can be shared by
+// any number of threads. Loading a dictionary with the ID of one already loaded keeps the first, as they are the same.
+
+#ifndef DICTIONARY_CACHE_H
+#define DICTIONARY_CACHE_H
+
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Dictionary.h"
+#include "huffman_tree/decoding_table/DecodingTable.h"
+#include "huffman_tree/histogram/ByteHistogram.h"
+
+class DictionaryCache {
+public:
+    // reads the dictionary file, returning false (after printing an error) if it is not a valid dictionary file
+    bool load(const std::string& path, unsigned decodingTableBits = DecodingTable::DEFAULT_TABLE_BITS);
+
+    [[nodiscard]] const Dictionary* find(uint32_t id) const; // nullptr if not loaded
+    // the dictionary which encodes the histogram in the fewest bits, setting bits to that number (nullptr if none can)
+    [[nodiscard]] const Dictionary* findSmallest(const ByteHistogram& histogram, uint64_t& bits) const;
+
+    [[nodiscard]] bool empty() const { return dictionaries.empty(); }
+    [[nodiscard]] const std::vector<Dictionary>& getDictionaries() const { return dictionaries; }
+
+private:
+    std::vector<Dictionary> dictionaries{};
+};
+
+
+#endif // DICTIONARY_CACHE_H
@@ -2,7 +2,7 @@
 
 #include "FrequencyHashMap.h"
 
-FrequencyHashMap::FrequencyHashMap(std::ifstream& input, int bucketsCount) : buckets(bucketsCount) {
+FrequencyHashMap::FrequencyHashMap(std::ifstream& input, int bucketsCount) : buckets(bucketsCount, NO_NODE) {
     input.clear(); // check if error state
     input.seekg(0, std::ios::beg);
 
@@ -20,21 +20,21 @@ void FrequencyHashMap::insertHashNode(const char key) {
 }
 
 // recursive helper function that inserts node in the manner of a BST
-void FrequencyHashMap::insertBST(FrequencyHashNode*& root, const char key) {
+void FrequencyHashMap::insertBST(uint16_t& root, const char key) {
     // where node with key does not exist in the bucket, create new node
-    if (root == nullptr) {
-        FrequencyHashNode* newPtr{new FrequencyHashNode(key)};
-        root = newPtr;
+    if (root == NO_NODE) {
+        root = nodes.add(FrequencyHashNode(key));
         return;
     }
 
     // where node with key already exists, just increment the frequency instead of creating new node
     // else traverse tree recursively
-    if (root->key == key) {
-        ++root->frequency;
-    } else if (key < root->key) {
-        insertBST(root->left, key);
+    FrequencyHashNode& node{nodes[root]};
+    if (node.key == key) {
+        ++node.frequency;
+    } else if (key < node.key) {
+        insertBST(node.left, key);
     } else {
-        insertBST(root->right, key);
+        insertBST(node.right, key);
     }
 }
\ No newline at end of file
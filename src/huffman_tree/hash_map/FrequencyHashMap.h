@@ -6,8 +6,13 @@
 // but the hash map is only used for insertion, therefore it has been implemented accordingly.
 
 // In this implementation, buckets and chaining are used to account for collisions. An array (vector) of
-// pointers to FrequencyHashNode are stored. The chaining of each node is implemented as a Binary Search Tree (BST)
-// rather than a standard Linked List. This makes the insertions on the chain O(log base 2 of N).
+// indices of FrequencyHashNode in a NodeArena are stored, the arena holding one node for each of the 256
+// characters. The chaining of each node is implemented as a Binary Search Tree (BST) rather than a standard
+// Linked List. This makes the insertions on the chain O(log base 2 of N).
+
+// The ByteHistogram has since replaced this map in the compression of files, as an array indexed by the character
+// does the same job with far less work for only 256 possible characters. The map is kept as the reference against
+// which ByteHistogram::selfTest checks every histogram engine.
 
 #ifndef FREQUENCY_HASHMAP_H
 #define FREQUENCY_HASHMAP_H
@@ -22,14 +27,16 @@
 class FrequencyHashMap {
 public:
     FrequencyHashMap(std::ifstream& input, int bucketsCount); // constructor
-    std::vector<FrequencyHashNode*> buckets; // public data member is fine
+    // public data members are fine
+    std::vector<uint16_t> buckets;
+    NodeArena<FrequencyHashNode, 256> nodes{};
 
 private:
     std::hash<char> hash; // hash object
 
     // helper functions
     void insertHashNode(char key);
-    static void insertBST(FrequencyHashNode*& root, char key);
+    void insertBST(uint16_t& root, char key);
 };
 
 
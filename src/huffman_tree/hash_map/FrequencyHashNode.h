@@ -1,21 +1,27 @@
 // Frequency Hash Node Header and Implementation
 
-// There are the nodes used for chaining in the Frequency Hash Map. Pointers to the left and right are provided
-// so that a BST can be created.
+// There are the nodes used for chaining in the Frequency Hash Map. The indices of the left and right nodes in the
+// arena of the map are provided so that a BST can be created.
 
 #ifndef FREQUENCY_HASH_NODE_H
 #define FREQUENCY_HASH_NODE_H
 
 
+#include <cstdint>
+
+#include "huffman_tree/node_arena/NodeArena.h"
+
 class FrequencyHashNode {
 public:
-    explicit FrequencyHashNode(char value) : key(value) {} // constructor
+    // constructors
+    FrequencyHashNode() = default; // for the arena
+    explicit FrequencyHashNode(char value) : key(value) {}
 
     // public data members are fine
     char key{}; // un-hashed key for comparisons
-    int frequency{1};
-    FrequencyHashNode* left{nullptr};
-    FrequencyHashNode* right{nullptr};
+    uint64_t frequency{1};
+    uint16_t left{NO_NODE};
+    uint16_t right{NO_NODE};
 };
 
 
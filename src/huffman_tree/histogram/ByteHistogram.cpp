@@ -0,0 +1,113 @@
+// Byte Histogram Implementation
+
+#include "ByteHistogram.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "huffman_tree/hash_map/FrequencyHashMap.h"
+
+ByteHistogram::ByteHistogram(HistogramEngine engine) : engine(engine) {}
+
+void ByteHistogram::count(const uint8_t* data, std::size_t size) {
+    switch (engine) {
+    case HistogramEngine::SIMPLE:
+        countSimple(data, size);
+        break;
+    case HistogramEngine::INTERLEAVED:
+        countInterleaved(data, size);
+        break;
+    }
+}
+
+void ByteHistogram::countSource(InputSource& input) {
+    // count each block where it is (the block buffer is only used when the file is not mapped)
+    std::vector<uint8_t> block{};
+    const uint8_t* data{nullptr};
+    uint64_t position{0};
+    while (std::size_t size{input.view(position, READ_BLOCK_SIZE, data, block)}) {
+        count(data, size);
+        input.release(position, size);
+        position += size;
+    }
+}
+
+void ByteHistogram::merge(const ByteHistogram& other) {
+    for (std::size_t i{0}; i < frequencies.size(); ++i) {
+        frequencies[i] += other.frequencies[i];
+    }
+}
+
+uint64_t ByteHistogram::total() const {
+    uint64_t sum{0};
+    for (uint64_t frequency : frequencies) {
+        sum += frequency;
+    }
+    return sum;
+}
+
+bool ByteHistogram::selfTest(const std::string& path) {
+    // reference frequencies from the original hash map
+    std::array<uint64_t, 256> expected{};
+    std::ifstream stream{path, std::ios::in | std::ios::binary};
+    FrequencyHashMap hashMap{stream, 10};
+    for (uint16_t i{0}; i < hashMap.nodes.size(); ++i) {
+        expected[static_cast<unsigned char>(hashMap.nodes[i].key)] = hashMap.nodes[i].frequency;
+    }
+
+    // every engine must agree with it
+    InputSource input{path};
+    for (HistogramEngine engine : {HistogramEngine::SIMPLE, HistogramEngine::INTERLEAVED}) {
+        ByteHistogram histogram{engine};
+        histogram.countSource(input);
+        if (histogram.frequencies != expected) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void ByteHistogram::countSimple(const uint8_t* data, std::size_t size) {
+    for (std::size_t i{0}; i < size; ++i) {
+        ++frequencies[data[i]];
+    }
+}
+
+void ByteHistogram::countInterleaved(const uint8_t* data, std::size_t size) {
+    // a round is small enough that no 32-bit count can overflow before the tables are summed
+    constexpr std::size_t MAX_ROUND_SIZE{std::size_t{1} << 30};
+
+    while (size > 0) {
+        std::size_t roundSize{std::min(size, MAX_ROUND_SIZE)};
+        uint32_t tables[4][256]{};
+
+        // consecutive bytes go to different tables
+        std::size_t i{0};
+        for (; i + 8 <= roundSize; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            ++tables[0][word & 0xFF];
+            ++tables[1][(word >> 8) & 0xFF];
+            ++tables[2][(word >> 16) & 0xFF];
+            ++tables[3][(word >> 24) & 0xFF];
+            ++tables[0][(word >> 32) & 0xFF];
+            ++tables[1][(word >> 40) & 0xFF];
+            ++tables[2][(word >> 48) & 0xFF];
+            ++tables[3][word >> 56];
+        }
+        for (; i < roundSize; ++i) {
+            ++tables[0][data[i]];
+        }
+
+        // sum the tables into the 64-bit frequencies
+        for (std::size_t j{0}; j < 256; ++j) {
+            frequencies[j] += uint64_t{tables[0][j]} + tables[1][j] + tables[2][j] + tables[3][j];
+        }
+
+        data += roundSize;
+        size -= roundSize;
+    }
+}
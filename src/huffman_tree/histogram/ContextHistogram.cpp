@@ -0,0 +1,27 @@
+// Context Histogram Implementation
+
+#include "ContextHistogram.h"
+
+#include <numeric>
+
+uint8_t ContextHistogram::count(const uint8_t* data, std::size_t size, uint8_t previous) {
+    uint64_t* table{frequencies.data()};
+    std::size_t context{static_cast<std::size_t>(previous) << 8};
+
+    for (std::size_t i{0}; i < size; ++i) {
+        ++table[context | data[i]];
+        context = static_cast<std::size_t>(data[i]) << 8;
+    }
+
+    return static_cast<uint8_t>(context >> 8);
+}
+
+void ContextHistogram::merge(const ContextHistogram& other) {
+    for (std::size_t i{0}; i < frequencies.size(); ++i) {
+        frequencies[i] += other.frequencies[i];
+    }
+}
+
+uint64_t ContextHistogram::total() const {
+    return std::accumulate(frequencies.begin(), frequencies.end(), uint64_t{0});
+}
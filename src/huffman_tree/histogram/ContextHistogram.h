@@ -0,0 +1,43 @@
+// Context Histogram Header
+
+// The ByteHistogram counts how often each character occurs, no matter what comes before it. In text, however, the
+// previous character says a lot about the next one: a "q" is almost always followed by a "u", and a space is rarely
+// followed by another space. The ContextHistogram instead counts every pair of characters, keeping a row of 256
+// frequencies for every previous character (its context), which is what the ContextModel builds its tables from.
+
+// The first character of the file is counted in the context of the character 0, as if the file were preceded by it.
+// A file counted one block at a time carries the last character of each block over to the next, and a chunk of the
+// file counted on its own (see countFrequenciesParallel) starts from the character before it. The pairs are counted in
+// the same pass over the file as the ByteHistogram (or BlockSplitter), so counting them never reads the file again.
+
+// The rows take 256 * 256 64-bit counts (512 KB), so they are held on the heap rather than in an array.
+
+#ifndef CONTEXT_HISTOGRAM_H
+#define CONTEXT_HISTOGRAM_H
+
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ContextHistogram {
+public:
+    static constexpr std::size_t CONTEXT_COUNT{256};
+
+    ContextHistogram() : frequencies(CONTEXT_COUNT * 256) {} // constructor
+
+    // public data member is fine
+    std::vector<uint64_t> frequencies; // indexed by the previous character * 256 + the character
+
+    // counts the characters of the block, the first of which follows previous. returns the last character
+    uint8_t count(const uint8_t* data, std::size_t size, uint8_t previous);
+    void merge(const ContextHistogram& other);
+    void clear() { std::fill(frequencies.begin(), frequencies.end(), 0); }
+
+    [[nodiscard]] const uint64_t* row(uint8_t context) const { return &frequencies[context * 256]; }
+    [[nodiscard]] uint64_t total() const;
+};
+
+
+#endif // CONTEXT_HISTOGRAM_H
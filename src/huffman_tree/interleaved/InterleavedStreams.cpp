@@ -0,0 +1,159 @@
+// Interleaved Streams Implementation
+
+#include "InterleavedStreams.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "utils/compression/compression_utils.h"
+
+InterleavedStreams::InterleavedStreams(const EncodingTable& encodingTable, unsigned streamCount)
+    : encodingTable(&encodingTable), streamCount(std::clamp(streamCount, 1u, MAX_STREAMS)),
+      streams(this->streamCount) {}
+
+InterleavedStreams::InterleavedStreams(const DecodingTable& decodingTable) : decodingTable(&decodingTable) {}
+
+unsigned InterleavedStreams::chooseStreamCount(const EncodingTable& encodingTable, unsigned streamCount) {
+    unsigned longestCode{0};
+    for (const HuffmanCodeword& codeword : encodingTable) {
+        longestCode = std::max(longestCode, static_cast<unsigned>(codeword.length));
+    }
+
+    // the same characters per refill as decodeInterleaved
+    if (longestCode == 0 || BitReader::FILL_BITS / longestCode < MIN_CHARACTERS_PER_FILL) {
+        return 1;
+    }
+    return streamCount;
+}
+
+void InterleavedStreams::encode(const uint8_t* data, std::size_t size, BitWriter& writer) {
+    // write character k to stream k % blockStreams, where a block of fewer characters than streams has fewer streams
+    auto blockStreams{static_cast<unsigned>(std::min<std::size_t>(streamCount, size))};
+    std::vector<BitWriter> writers{};
+    for (unsigned i{0}; i < blockStreams; ++i) {
+        streams[i].clear();
+        writers.emplace_back(streams[i]);
+    }
+    std::size_t next{0};
+    for (std::size_t i{0}; i < size; ++i) {
+        const HuffmanCodeword& codeword{(*encodingTable)[data[i]]};
+
+        if (codeword.length != 0) {
+            writers[next].writeBits(codeword.bits, codeword.length);
+        } else {
+            std::cout << "Character not found in encoding table.\n";
+        }
+        next = next + 1 == blockStreams ? 0 : next + 1;
+    }
+    for (BitWriter& streamWriter : writers) {
+        streamWriter.flush();
+    }
+
+    // the header of the block, then every stream padded to a whole byte
+    writeVarint(writer, size);
+    writer.writeByte(static_cast<uint8_t>(blockStreams));
+    for (unsigned i{0}; i < blockStreams; ++i) {
+        writeVarint(writer, streams[i].bitLength);
+    }
+    for (unsigned i{0}; i < blockStreams; ++i) {
+        const std::vector<uint8_t>& bytes{streams[i].bytes};
+        std::size_t byte{0};
+        for (; byte + 8 <= bytes.size(); byte += 8) {
+            uint64_t word{0};
+            for (std::size_t j{0}; j < 8; ++j) {
+                word = (word << 8) | bytes[byte + j];
+            }
+            writer.writeBits(word, 64);
+        }
+        for (; byte < bytes.size(); ++byte) {
+            writer.writeByte(bytes[byte]);
+        }
+    }
+}
+
+std::size_t InterleavedStreams::decode(BitReader& reader, uint64_t bitLength, uint8_t* output, std::size_t capacity,
+                                       bool& corrupted) {
+    std::size_t count{0};
+
+    // decode each block from its streams, moving on to the next block once every stream has been read
+    while (count < capacity && !corrupted) {
+        if (remaining == 0) {
+            if (reader.position() >= bitLength) {
+                break;
+            }
+            if (!startBlock(reader, bitLength)) {
+                corrupted = true;
+                break;
+            }
+        }
+
+        auto blockCapacity{static_cast<std::size_t>(std::min<uint64_t>(capacity - count, remaining))};
+        if (!decodingTable->decodeInterleaved(readers.data(), readers.size(), nextReader, output + count,
+                                              blockCapacity)) {
+            corrupted = true;
+            break;
+        }
+        count += blockCapacity;
+        remaining -= blockCapacity;
+        nextReader = (nextReader + blockCapacity) % readers.size();
+
+        if (remaining == 0 && !finishBlock(reader)) {
+            corrupted = true;
+        }
+    }
+
+    return count;
+}
+
+bool InterleavedStreams::startBlock(BitReader& reader, uint64_t bitLength) {
+    // every block starts on a byte boundary, with at least one character and at most MAX_STREAMS streams
+    uint64_t characterCount{0};
+    if (reader.position() % 8 != 0 || !readVarint(reader, characterCount) || characterCount == 0 ||
+        characterCount > BLOCK_SIZE) {
+        return false;
+    }
+    auto count{static_cast<unsigned>(reader.readByte())};
+    if (count == 0 || count > MAX_STREAMS) {
+        return false;
+    }
+
+    // the streams must lie within the section
+    streamLengths.resize(count);
+    uint64_t byteCount{0};
+    for (uint64_t& streamLength : streamLengths) {
+        if (!readVarint(reader, streamLength) || streamLength > bitLength) {
+            return false;
+        }
+        byteCount += (streamLength + 7) / 8;
+    }
+    uint64_t start{reader.position()};
+    BitSpan span{reader.span()};
+    if (start > bitLength || byteCount > (bitLength - start) / 8 || start / 8 + byteCount > span.byteLength) {
+        return false;
+    }
+
+    // give every stream a reader of its own, where the section's reader stays until the block has been decoded, so
+    // that it is not taken to have ended while characters of the block are left
+    readers.clear();
+    const uint8_t* streamBytes{span.bytes + start / 8};
+    for (uint64_t streamLength : streamLengths) {
+        auto streamByteCount{static_cast<std::size_t>((streamLength + 7) / 8)};
+        readers.emplace_back(streamBytes, streamByteCount, streamLength);
+        streamBytes += streamByteCount;
+    }
+    blockEnd = start + byteCount * 8;
+
+    remaining = characterCount;
+    nextReader = 0;
+    return true;
+}
+
+bool InterleavedStreams::finishBlock(BitReader& reader) const {
+    for (std::size_t i{0}; i < readers.size(); ++i) {
+        if (readers[i].position() != streamLengths[i]) {
+            return false;
+        }
+    }
+    reader.seek(blockEnd);
+    return true;
+}
@@ -0,0 +1,88 @@
+// Interleaved Streams Header
+
+// Decoding a Huffman Code is a chain of lookups: where the code of a character starts is only known once the length
+// of the code before it has been looked up, so the processor waits for each lookup before it can begin the next one,
+// however little else it has to do. Interleaved streams break that chain by writing the characters of a block to
+// several bit streams in turn, character k to stream k % streamCount. Each stream is then a chain of its own, and
+// since the decoder takes a character from each stream in turn (see DecodingTable::decodeInterleaved), the lookups of
+// the other streams are carried out while one waits.
+
+// https://fgiesen.wordpress.com/2018/02/19/reading-bits-in-far-too-many-ways-part-1/
+
+// The Huffman Code of a file with interleaved streams (marked by the INTERLEAVED flag of the header) is a sequence of
+// blocks of at most BLOCK_SIZE characters, each of which starts with its own header:
+
+// [Character Count] > [Stream Count (8 bits)] > [Bit Length of Each Stream] > [Stream 0] > ... > [Stream N - 1]
+
+// where the count and bit lengths are varints, and every stream is padded to a whole byte, so that each block and
+// each stream starts on a byte boundary. The decoder gives every stream a BitReader of its own from the bit lengths,
+// and checks at the end of the block that each stream has been read to exactly its bit length. As every block
+// describes itself, a block can be decoded without any other, and a sync point of the BlockIndex is always the start
+// of a block. The header and padding of a block take about 16 bytes with 4 streams, under 0.03% of a full block, and
+// a block of fewer characters than streams has only as many streams as characters.
+
+// Only the single table of a file (its own, or that of a Dictionary) can be interleaved: the tables of a ContextModel
+// depend on the character before, and those of an AdaptiveHuffman tree on every character before, which is the very
+// chain the streams are meant to break. encode carries nothing from one block to the next, while decode carries the
+// block being decoded from one call to the next, so that a block can be decoded a buffer at a time.
+
+// Streams only pay off when every refill of their readers is good for several characters. decodeInterleaved decodes
+// BitReader::FILL_BITS / (longest code) characters of each stream per refill, while a single stream decodes as many
+// characters as the filled bits hold. With 3 characters per refill (codes of 15 bits, as with text) the streams decode
+// about as fast as a single stream, and with 2 (a few very common characters and many rare ones) slower, while with
+// 5 or more (binary data) they decode up to twice as fast. chooseStreamCount therefore falls back to a single stream
+// when the longest code leaves fewer than MIN_CHARACTERS_PER_FILL characters for every refill.
+
+#ifndef INTERLEAVED_STREAMS_H
+#define INTERLEAVED_STREAMS_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "huffman_tree/bit_stream/BitReader.h"
+#include "huffman_tree/bit_stream/BitWriter.h"
+#include "huffman_tree/bit_stream/PackedBits.h"
+#include "huffman_tree/components/HuffmanCodeword.h"
+#include "huffman_tree/decoding_table/DecodingTable.h"
+
+class InterleavedStreams {
+public:
+    static constexpr unsigned MAX_STREAMS{16};
+    static constexpr std::size_t BLOCK_SIZE{1 << 16}; // most characters in a block
+    static constexpr unsigned MIN_CHARACTERS_PER_FILL{4}; // of each stream, for streams to be written at all
+
+    // constructors
+    InterleavedStreams(const EncodingTable& encodingTable, unsigned streamCount); // when compressing
+    explicit InterleavedStreams(const DecodingTable& decodingTable); // when decompressing
+
+    // writes size characters (at least 1 and at most BLOCK_SIZE) as one block, starting on a byte boundary
+    void encode(const uint8_t* data, std::size_t size, BitWriter& writer);
+    // decodes up to capacity characters, stopping at bitLength
+    std::size_t decode(BitReader& reader, uint64_t bitLength, uint8_t* output, std::size_t capacity, bool& corrupted);
+
+    [[nodiscard]] unsigned getStreamCount() const { return streamCount; }
+
+    // the number of streams to write with the codes of encodingTable, which is streamCount or 1
+    static unsigned chooseStreamCount(const EncodingTable& encodingTable, unsigned streamCount);
+
+private:
+    const EncodingTable* encodingTable{nullptr};
+    const DecodingTable* decodingTable{nullptr};
+    unsigned streamCount{1};
+    std::vector<PackedBits> streams{}; // only when compressing
+
+    // the block being decoded, and the characters left in it
+    std::vector<BitReader> readers{};
+    std::vector<uint64_t> streamLengths{};
+    uint64_t remaining{0};
+    std::size_t nextReader{0};
+    uint64_t blockEnd{0}; // where the section's reader goes once the block has been decoded
+
+    bool startBlock(BitReader& reader, uint64_t bitLength); // returns false if the header of the block is invalid
+    bool finishBlock(BitReader& reader) const; // returns false if a stream was not read to its end
+};
+
+
+#endif // INTERLEAVED_STREAMS_H
@@ -0,0 +1,50 @@
+// Node Arena Header and Implementation
+
+// Creating every node of a tree with new places the nodes wherever the allocator finds room, so following the
+// children of a node means jumping to an unrelated part of memory (a likely cache miss), and every node must later be
+// found again to be deleted. As the trees in this program have a known maximum number of nodes (a Huffman Tree of
+// 256 characters has 256 leaf nodes and 255 non-leaf nodes), the nodes are instead stored in a NodeArena: a fixed
+// array of Capacity nodes, handed out in order, where a node refers to its children by their 16-bit index in the
+// array rather than by a pointer.
+
+// Adding a node never allocates memory, and clear simply starts handing out nodes from the beginning of the array
+// again, so the same arena can be reused for any number of trees. NO_NODE takes the place of nullptr for a missing
+// child, and is also returned by add once the arena is full (which can only happen with a corrupted file).
+
+#ifndef NODE_ARENA_H
+#define NODE_ARENA_H
+
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+constexpr uint16_t NO_NODE{UINT16_MAX}; // index of a missing node
+
+template <typename Node, std::size_t Capacity>
+class NodeArena {
+public:
+    static_assert(Capacity < NO_NODE, "every node must have a 16-bit index");
+
+    // returns the index of the added node
+    uint16_t add(const Node& node) {
+        if (count == Capacity) {
+            return NO_NODE;
+        }
+        nodes[count] = node;
+        return static_cast<uint16_t>(count++);
+    }
+
+    Node& operator[](uint16_t index) { return nodes[index]; }
+    const Node& operator[](uint16_t index) const { return nodes[index]; }
+
+    [[nodiscard]] std::size_t size() const { return count; }
+    void clear() { count = 0; }
+
+private:
+    std::array<Node, Capacity> nodes{};
+    std::size_t count{0};
+};
+
+
+#endif // NODE_ARENA_H
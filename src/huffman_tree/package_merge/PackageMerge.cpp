@@ -0,0 +1,73 @@
+// Package Merge Implementation
+
+#include "PackageMerge.h"
+
+#include <algorithm>
+#include <vector>
+
+PackageMerge::PackageMerge(const ByteHistogram& histogram, unsigned maxLength) {
+    // the characters which occur, in order of frequency (and then of character value)
+    std::vector<uint8_t> characters{};
+    for (std::size_t character{0}; character < histogram.frequencies.size(); ++character) {
+        if (histogram.frequencies[character] != 0) {
+            characters.push_back(static_cast<uint8_t>(character));
+        }
+    }
+    std::stable_sort(characters.begin(), characters.end(), [&histogram](uint8_t a, uint8_t b) {
+        return histogram.frequencies[a] < histogram.frequencies[b];
+    });
+
+    // special case: one character (or none) still needs a code of 1 bit
+    if (characters.size() <= 1) {
+        this->maxLength = 1;
+        for (uint8_t character : characters) {
+            codeLengths[character] = 1;
+        }
+        return;
+    }
+
+    // raise the maximum length until every character can have its own code
+    unsigned minimumLength{1};
+    while ((std::size_t{1} << minimumLength) < characters.size()) {
+        ++minimumLength;
+    }
+    this->maxLength = std::min(std::max(maxLength, minimumLength), MAX_LENGTH);
+
+    // lists[i] holds whether each item of the list for length i + 1 is a package (true) or a coin (false); the coins
+    // of a list always appear in order of frequency, so only the number of coins selected needs to be known later
+    std::vector<std::vector<bool>> lists(this->maxLength);
+    std::vector<uint64_t> packages{};
+    for (unsigned level{this->maxLength}; level >= 1; --level) {
+        std::vector<bool>& list{lists[level - 1]};
+        std::vector<uint64_t> merged{};
+        std::size_t coin{0};
+        std::size_t package{0};
+
+        // merge the coins and the packages of the longer length in order of value, coins first on ties
+        while (coin < characters.size() || package < packages.size()) {
+            bool takePackage{coin == characters.size() ||
+                (package < packages.size() && packages[package] < histogram.frequencies[characters[coin]])};
+            merged.push_back(takePackage ? packages[package++] : histogram.frequencies[characters[coin++]]);
+            list.push_back(takePackage);
+        }
+
+        // pair the items into packages for the next shorter length
+        packages.clear();
+        for (std::size_t i{0}; i + 1 < merged.size(); i += 2) {
+            packages.push_back(merged[i] + merged[i + 1]);
+        }
+    }
+
+    // select the first 2n - 2 items of the shortest length, following each selected package into the longer length
+    std::size_t selected{2 * characters.size() - 2};
+    for (unsigned level{1}; level <= this->maxLength && selected > 0; ++level) {
+        const std::vector<bool>& list{lists[level - 1]};
+        std::size_t coins{0};
+        for (std::size_t i{0}; i < selected; ++i) {
+            if (!list[i]) {
+                ++codeLengths[characters[coins++]];
+            }
+        }
+        selected = 2 * (selected - coins);
+    }
+}
@@ -0,0 +1,47 @@
+// Package Merge Header
+
+// The Huffman Tree built by the priority queue gives the shortest possible Huffman Code, but places no limit on how
+// long a single code may become. With very skewed frequencies (for example, frequencies following the Fibonacci
+// sequence), a rare character can end up with a code dozens of bits long, which forces the DecodingTable into many
+// levels of secondary tables and makes decoding speed depend on the file.
+
+// The package-merge algorithm finds the code lengths that give the shortest Huffman Code among all codes whose
+// lengths do not exceed maxLength. Each character is thought of as a coin whose value is its frequency, with one
+// coin of every character available at each length from 1 to maxLength. Starting from the longest length, the coins of
+// the list are paired into packages (the two lowest first), and the packages are merged with the coins of the next
+// shorter length in order of value. The first 2n - 2 items of the final list (n being the number of characters) are
+// the cheapest way to pay for a complete code, and the code length of a character is the number of lists in which
+// its coin was selected, either directly or as part of a selected package.
+
+// https://en.wikipedia.org/wiki/Package-merge_algorithm
+
+// As the result is only a set of code lengths, the codes are assigned in canonical order (see
+// generateCanonicalEncodingTable) rather than read from a Huffman Tree. A maxLength too small to give every character
+// its own code (less than the base 2 logarithm of the number of characters) is raised to the smallest one that can.
+
+#ifndef PACKAGE_MERGE_H
+#define PACKAGE_MERGE_H
+
+
+#include <array>
+#include <cstdint>
+
+#include "huffman_tree/histogram/ByteHistogram.h"
+
+class PackageMerge {
+public:
+    static constexpr unsigned MAX_LENGTH{64}; // the longest code a HuffmanCodeword can hold
+
+    PackageMerge(const ByteHistogram& histogram, unsigned maxLength); // constructor
+
+    // getters called after construction of the code lengths
+    [[nodiscard]] const std::array<uint8_t, 256>& getCodeLengths() const { return codeLengths; }
+    [[nodiscard]] unsigned getMaxLength() const { return maxLength; }
+
+private:
+    std::array<uint8_t, 256> codeLengths{}; // 0 for characters which do not occur
+    unsigned maxLength{0};
+};
+
+
+#endif // PACKAGE_MERGE_H
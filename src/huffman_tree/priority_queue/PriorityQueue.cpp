@@ -4,114 +4,95 @@
 
 #include "PriorityQueue.h"
 
-PriorityQueue::PriorityQueue(const FrequencyHashMap& hashMap) {
-    for (FrequencyHashNode* tree : hashMap.buckets) {
-        traverseBST(tree);
+uint16_t PriorityQueue::buildTree(const ByteHistogram& histogram, HuffmanNodeArena& arena) {
+    nodes = &arena;
+    queueSize = 0;
+
+    // populate the queue with every character that occurs
+    for (std::size_t character{0}; character < histogram.frequencies.size(); ++character) {
+        if (histogram.frequencies[character] != 0) {
+            enqueue(static_cast<char>(character), histogram.frequencies[character]);
+        }
     }
 
     // construct Huffman Tree
     constructHuffmanTree();
+    return getHuffmanTree();
 }
 
-// constructor helper functions
-
-void PriorityQueue::traverseBST(const FrequencyHashNode* root) {
-    // base case
-    if (root == nullptr) {
-        return;
-    }
-
-    // traverse preorder, going through every node and populating the queue
-    enqueue(root->key, root->frequency);
-    traverseBST(root->left);
-    traverseBST(root->right);
-}
+// build helper functions
 
 void PriorityQueue::constructHuffmanTree() {
-    // base case when only one pointer left in queue
-    if (queue.size() == 1) {
-        return;
+    // continue until only one node (or none, for an empty file) is left in queue
+    while (queueSize > 1) {
+        // extract the two most minimum nodes from queue
+        uint16_t minimumA{dequeue()};
+        uint16_t minimumB{dequeue()};
+
+        // create a non-leaf HuffmanNode with the combined weights
+        uint64_t weight{(*nodes)[minimumA].weight + (*nodes)[minimumB].weight};
+        uint16_t newNode{nodes->add(HuffmanNode(weight, minimumA, minimumB))};
+
+        // add new HuffmanNode back to queue
+        enqueue(newNode);
     }
-
-    // extract the two most minimum nodes from queue
-    HuffmanNode* minimumA{dequeue()};
-    HuffmanNode* minimumB{dequeue()};
-
-    // create a non-leaf HuffmanNode with the combined weights
-    HuffmanNode* newPtr{new HuffmanNode(minimumA->weight + minimumB->weight)};
-    newPtr->left = minimumA;
-    newPtr->right = minimumB;
-
-    // add new HuffmanNode back to queue
-    enqueue(newPtr);
-
-    // recursively continue
-    constructHuffmanTree();
 }
 
 // heap functions
 
 void PriorityQueue::reHeapUp(std::size_t endIndex) {
-    if (endIndex > 0) {
-        // base case is at root node
+    // move up until the root node is reached or the parent is no heavier
+    while (endIndex > 0) {
         std::size_t parentIndex{getParent(endIndex)};
-
-        // swap and continue reHeapUp as necessary
-        if (queue[parentIndex]->weight > queue[endIndex]->weight) {
-            std::swap(*queue[parentIndex], *queue[endIndex]);
-            reHeapUp(parentIndex);
+        if (weightAt(parentIndex) <= weightAt(endIndex)) {
+            return;
         }
+
+        std::swap(queue[parentIndex], queue[endIndex]);
+        endIndex = parentIndex;
     }
 }
 
 void PriorityQueue::reHeapDown(std::size_t startIndex, std::size_t endIndex) {
-    std::size_t leftChildIndex{getLeftChild(startIndex)};
-    std::size_t rightChildIndex{getRightChild(startIndex)};
-
-    if (leftChildIndex <= endIndex) {
-        // base case is when left index is past the last vector index
-        std::size_t minChildIndex;
-
-        if (leftChildIndex == endIndex) {
-            // if left child is the last node, set it as the min
-            minChildIndex = leftChildIndex;
-        } else {
-            // set min child accordingly
-            minChildIndex = queue[rightChildIndex]->weight < queue[leftChildIndex]->weight
-                                ? rightChildIndex
-                                : leftChildIndex;
+    // move down until the left index is past the last index or both children are no lighter
+    while (getLeftChild(startIndex) <= endIndex) {
+        std::size_t leftChildIndex{getLeftChild(startIndex)};
+        std::size_t rightChildIndex{getRightChild(startIndex)};
+
+        // if left child is the last node, set it as the min, otherwise set min child accordingly
+        std::size_t minChildIndex{leftChildIndex};
+        if (leftChildIndex != endIndex && weightAt(rightChildIndex) < weightAt(leftChildIndex)) {
+            minChildIndex = rightChildIndex;
         }
 
-        // swap and continue reHeapDown as necessary
-        if (queue[startIndex]->weight > queue[minChildIndex]->weight) {
-            std::swap(*queue[startIndex], *queue[minChildIndex]);
-            reHeapDown(minChildIndex, endIndex);
+        if (weightAt(startIndex) <= weightAt(minChildIndex)) {
+            return;
         }
+
+        std::swap(queue[startIndex], queue[minChildIndex]);
+        startIndex = minChildIndex;
     }
 }
 
-void PriorityQueue::enqueue(char key, int weight) {
-    queue.push_back(new HuffmanNode(key, weight));
-    reHeapUp(queue.size() - 1);
+void PriorityQueue::enqueue(char key, uint64_t weight) {
+    enqueue(nodes->add(HuffmanNode(key, weight)));
 }
 
-void PriorityQueue::enqueue(HuffmanNode* node) {
-    queue.push_back(node);
-    reHeapUp(queue.size() - 1);
+void PriorityQueue::enqueue(uint16_t node) {
+    queue[queueSize++] = node;
+    reHeapUp(queueSize - 1);
 }
 
-HuffmanNode* PriorityQueue::dequeue() {
+uint16_t PriorityQueue::dequeue() {
     // check if empty
-    if (queue.empty()) {
-        return nullptr;
+    if (queueSize == 0) {
+        return NO_NODE;
     }
 
-    HuffmanNode* dequeuedPtr{queue.front()}; // get dequeued pointer
-    queue[0] = queue[queue.size() - 1]; // assign last pointer to root
-    queue.pop_back(); // delete last pointer
+    uint16_t dequeuedNode{queue[0]}; // get dequeued node
+    queue[0] = queue[--queueSize]; // move last node to root
 
-    std::size_t length{queue.size()}; // check for overflow
-    reHeapDown(0, length == 0 ? 0 : length - 1);
+    reHeapDown(0, queueSize == 0 ? 0 : queueSize - 1); // check for overflow
 
-    return dequeuedPtr;
+    return dequeuedNode;
 }
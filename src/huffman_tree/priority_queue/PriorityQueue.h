@@ -3,36 +3,49 @@
 // The second step of Huffman Coding algorithm is to arrange the nodes such that every successive pair of nodes
 // with the lowest weights become the children of a new node with the combined weight, which is added back to the queue.
 // The Huffman Tree is created when all nodes are combined and the priority queue only has one node at the end. The
-// pointer to the root of the Huffman Tree is later used in another class.
+// index of the root of the Huffman Tree is later used in another class.
 
 // In this implementation, a priority queue would be appropriate, with the nodes having the minimum weights being
 // dequeued first for the construction of the Huffman Tree. A minimum heap is used to implement the priority queue,
 // as it offers a guaranteed O(log base 2 of N) for enqueue and dequeue operations. (For a BST, it is the same when
 // the tree is balanced but O(N) for both when skewed; for a linked list enqueue is O(N) and dequeue is O(1).)
 
-// The minimum heap itself is implemented as an array (vector). The vector STL class provides a number of useful
-// methods for the implementation of the heap. Pointers to HuffmanNode objects are stored in the vector so that
-// the final pointer with the Huffman Tree can be copied while keeping the objects intact.
+// The minimum heap itself is implemented as an array. As there are never more than 256 nodes in the queue (one for
+// each character), a fixed std::array is used along with the count of nodes in the queue, so that no memory is
+// allocated. The nodes themselves are added to the HuffmanNodeArena of the Huffman Tree, and only their 16-bit
+// indices are stored and swapped in the heap, which leaves the nodes in place so that the final index of the root of
+// the Huffman Tree refers to the complete tree.
+
+// The queue is filled directly from a ByteHistogram, in the order of the character values, so the same frequencies
+// always result in the same Huffman Tree. An empty histogram (from an empty file) results in an empty tree (NO_NODE).
+
+// The priority queue is the HEAP engine of the TreeBuilder interface. The nodes are combined, and the heap restored
+// after each change, with loops rather than recursion.
 
 #ifndef PRIORITY_QUEUE_H
 #define PRIORITY_QUEUE_H
 
 
-#include <vector>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 
-#include "huffman_tree/hash_map/FrequencyHashMap.h"
+#include "huffman_tree/histogram/ByteHistogram.h"
 #include "huffman_tree/HuffmanNode.h"
+#include "huffman_tree/tree_builder/TreeBuilder.h"
 
-class PriorityQueue {
+class PriorityQueue : public TreeBuilder {
 public:
-    explicit PriorityQueue(const FrequencyHashMap& hashMap); // constructor
-    [[nodiscard]] HuffmanNode* getHuffmanTree() const { return queue[0]; } // getter called after construction of Huffman Tree
+    uint16_t buildTree(const ByteHistogram& histogram, HuffmanNodeArena& arena) override;
+    // getter called after construction of Huffman Tree
+    [[nodiscard]] uint16_t getHuffmanTree() const { return queueSize == 0 ? NO_NODE : queue[0]; }
 private:
-    std::vector<HuffmanNode*> queue{};
+    HuffmanNodeArena* nodes{nullptr};
+    std::array<uint16_t, 256> queue{};
+    std::size_t queueSize{0};
 
-    // constructor helper functions
-    void traverseBST(const FrequencyHashNode* root);
-    void constructHuffmanTree(); // post-condition: single pointer in queue representing root of Huffman Tree
+    // build helper functions
+    void constructHuffmanTree(); // post-condition: single node in queue representing root of Huffman Tree
 
     // heap functions
     static std::size_t getParent(std::size_t index) { return (index - 1) / 2; }
@@ -40,9 +53,10 @@ private:
     static std::size_t getRightChild(std::size_t index) { return (index * 2) + 2; }
     void reHeapUp(std::size_t endIndex);
     void reHeapDown(std::size_t startIndex, std::size_t endIndex);
-    void enqueue(char key, int weight);
-    void enqueue(HuffmanNode* node); // overload function for constructHuffmanTree
-    HuffmanNode* dequeue();
+    [[nodiscard]] uint64_t weightAt(std::size_t index) const { return (*nodes)[queue[index]].weight; }
+    void enqueue(char key, uint64_t weight);
+    void enqueue(uint16_t node); // overload function for constructHuffmanTree
+    uint16_t dequeue();
 };
 
 
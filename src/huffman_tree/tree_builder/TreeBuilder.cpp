@@ -0,0 +1,14 @@
+// Tree Builder Implementation
+
+#include "TreeBuilder.h"
+
+#include "huffman_tree/priority_queue/PriorityQueue.h"
+#include "TwoQueueBuilder.h"
+
+uint16_t TreeBuilder::build(TreeBuilderEngine engine, const ByteHistogram& histogram, HuffmanNodeArena& nodes) {
+    PriorityQueue priorityQueue{};
+    TwoQueueBuilder twoQueueBuilder{};
+    TreeBuilder& builder{engine == TreeBuilderEngine::HEAP ? static_cast<TreeBuilder&>(priorityQueue)
+                                                           : static_cast<TreeBuilder&>(twoQueueBuilder)};
+    return builder.buildTree(histogram, nodes);
+}
@@ -0,0 +1,45 @@
+// Tree Builder Header
+
+// A TreeBuilder builds the Huffman Tree from the frequencies of the characters. Two engines with this common
+// interface exist, so that either can be chosen (and compared against the other) without the Huffman Tree knowing
+// how its tree is built.
+
+// The HEAP engine is the PriorityQueue, which repeatedly removes the two nodes with the lowest weights from a minimum
+// heap and adds back their combined node, taking O(N log N) time.
+
+// The TWO_QUEUE engine is the TwoQueueBuilder, which sorts the characters once and then builds the tree in O(N) time,
+// as the combined nodes are created in order of weight and can simply be kept in a second queue.
+
+// Both engines break ties between equal weights by a fixed rule, so the same frequencies always result in the same
+// Huffman Tree on any computer. The two engines may however build differently shaped trees for the same frequencies
+// (each is a Huffman Tree, so the Huffman Code has the same length either way).
+
+// The build function dispatches to the engine selected in the CompressionOptions. The builder is created on the stack,
+// so building a tree still allocates no memory.
+
+#ifndef TREE_BUILDER_H
+#define TREE_BUILDER_H
+
+
+#include <cstdint>
+
+#include "huffman_tree/histogram/ByteHistogram.h"
+#include "huffman_tree/HuffmanNode.h"
+
+enum class TreeBuilderEngine {
+    HEAP,
+    TWO_QUEUE,
+};
+
+class TreeBuilder {
+public:
+    virtual ~TreeBuilder() = default;
+
+    // adds the Huffman Tree of the histogram to the arena, returning the index of its root (NO_NODE if empty)
+    virtual uint16_t buildTree(const ByteHistogram& histogram, HuffmanNodeArena& nodes) = 0;
+
+    static uint16_t build(TreeBuilderEngine engine, const ByteHistogram& histogram, HuffmanNodeArena& nodes);
+};
+
+
+#endif // TREE_BUILDER_H
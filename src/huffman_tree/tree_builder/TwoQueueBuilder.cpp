@@ -0,0 +1,53 @@
+// Two Queue Builder Implementation
+
+#include "TwoQueueBuilder.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+uint16_t TwoQueueBuilder::buildTree(const ByteHistogram& histogram, HuffmanNodeArena& nodes) {
+    // sort the characters which occur by weight, then by character value
+    std::array<uint8_t, 256> characters{};
+    std::size_t characterCount{0};
+    for (std::size_t character{0}; character < histogram.frequencies.size(); ++character) {
+        if (histogram.frequencies[character] != 0) {
+            characters[characterCount++] = static_cast<uint8_t>(character);
+        }
+    }
+    std::sort(characters.begin(), characters.begin() + characterCount, [&histogram](uint8_t a, uint8_t b) {
+        return histogram.frequencies[a] != histogram.frequencies[b] ? histogram.frequencies[a] < histogram.frequencies[b]
+                                                                    : a < b;
+    });
+
+    // an empty file has no tree
+    if (characterCount == 0) {
+        return NO_NODE;
+    }
+
+    // the leaf queue is the range of leaf nodes, the combined queue the range of nodes added after them
+    auto leafFront{static_cast<uint16_t>(nodes.size())};
+    for (std::size_t i{0}; i < characterCount; ++i) {
+        nodes.add(HuffmanNode(static_cast<char>(characters[i]), histogram.frequencies[characters[i]]));
+    }
+    auto leafEnd{static_cast<uint16_t>(nodes.size())};
+    uint16_t combinedFront{leafEnd};
+
+    // take the front with the lower weight, preferring the leaf queue on ties
+    auto takeMinimum{[&]() -> uint16_t {
+        if (leafFront < leafEnd &&
+            (combinedFront == nodes.size() || nodes[leafFront].weight <= nodes[combinedFront].weight)) {
+            return leafFront++;
+        }
+        return combinedFront++;
+    }};
+
+    // every combination removes two nodes and adds one, until only the root is left
+    for (std::size_t i{1}; i < characterCount; ++i) {
+        uint16_t minimumA{takeMinimum()};
+        uint16_t minimumB{takeMinimum()};
+        nodes.add(HuffmanNode(nodes[minimumA].weight + nodes[minimumB].weight, minimumA, minimumB));
+    }
+
+    return static_cast<uint16_t>(nodes.size() - 1);
+}
@@ -0,0 +1,30 @@
+// Two Queue Builder Header
+
+// When the leaf nodes are taken in order of weight, every combined node is at least as heavy as the one combined
+// before it, so the combined nodes come out already sorted. Instead of a heap, two queues are then enough: one of the
+// leaf nodes sorted by weight, and one of the combined nodes in the order they are created. The two lowest weights are
+// always at the front of these queues, so every step takes O(1) time, and after the single sort the whole tree is
+// built in O(N) time without any recursion.
+
+// https://en.wikipedia.org/wiki/Huffman_coding#Compression
+
+// Both queues are simply ranges of the HuffmanNodeArena: the leaf nodes are added in sorted order, and the combined
+// nodes are added after them in the order they are created, so each queue is only an index to its front. The leaf
+// nodes are sorted by weight and then by character value, and when the fronts of both queues have the same weight
+// the leaf node is taken first (which also keeps the tree as shallow as possible).
+
+#ifndef TWO_QUEUE_BUILDER_H
+#define TWO_QUEUE_BUILDER_H
+
+
+#include <cstdint>
+
+#include "TreeBuilder.h"
+
+class TwoQueueBuilder : public TreeBuilder {
+public:
+    uint16_t buildTree(const ByteHistogram& histogram, HuffmanNodeArena& nodes) override;
+};
+
+
+#endif // TWO_QUEUE_BUILDER_H
@@ -0,0 +1,218 @@
+// Input Source Implementation
+
+#include "InputSource.h"
+
+#include <algorithm>
+#include <chrono>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define INPUT_SOURCE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+InputSource::InputSource(const std::string& path) {
+    auto start{std::chrono::steady_clock::now()};
+    if (map(path)) {
+        open = true;
+        readNanoseconds += elapsedNanoseconds(start);
+        return;
+    }
+
+    // buffered fallback, where the size is only known if the stream can seek
+    stream.open(path, std::ios::in | std::ios::binary); // read in binary mode
+    open = static_cast<bool>(stream);
+    if (open && stream.seekg(0, std::ios::end)) {
+        std::streampos end{stream.tellg()};
+        fileSize = end > 0 ? static_cast<uint64_t>(end) : 0;
+    }
+    stream.clear();
+    stream.seekg(0, std::ios::beg);
+    stream.clear(); // a pipe cannot seek, which is fine as it is at its start
+    readNanoseconds += elapsedNanoseconds(start);
+}
+
+InputSource::InputSource(const uint8_t* data, std::size_t size)
+    : open(true), inMemory(true), mapping(data), fileSize(size) {}
+
+InputSource::InputSource(std::istream& source) : forwardStream(&source) {
+    open = static_cast<bool>(source);
+}
+
+InputSource::InputSource(InputSource& source, uint64_t offset, uint64_t size) : open(source.isOpen()) {
+    // the range ends at the end of the source at the latest
+    uint64_t sourceSize{source.size()};
+    fileSize = offset < sourceSize ? std::min(size, sourceSize - offset) : 0;
+    if (source.mapping != nullptr) {
+        inMemory = true; // the mapping belongs to the source
+        mapping = source.mapping + std::min(offset, sourceSize);
+    } else {
+        parent = &source;
+        parentOffset = offset;
+    }
+}
+
+InputSource::~InputSource() {
+#if defined(INPUT_SOURCE_MMAP)
+    if (mapping != nullptr && !inMemory) {
+        munmap(const_cast<uint8_t*>(mapping), static_cast<std::size_t>(fileSize));
+    }
+#endif
+}
+
+std::size_t InputSource::view(uint64_t position, std::size_t maxSize, const uint8_t*& data,
+                              std::vector<uint8_t>& buffer) {
+    if (forwardStream != nullptr) {
+        return viewForward(position, maxSize, data, buffer);
+    }
+    if (parent != nullptr) {
+        if (position >= fileSize) {
+            data = nullptr;
+            return 0;
+        }
+        auto rangeSize{static_cast<std::size_t>(std::min<uint64_t>(maxSize, fileSize - position))};
+        return parent->view(parentOffset + position, rangeSize, data, buffer);
+    }
+
+    // an empty file is open without a mapping, as mmap cannot map 0 bytes
+    if (mapping != nullptr || (open && !stream.is_open())) {
+        if (position >= fileSize) {
+            data = nullptr;
+            return 0;
+        }
+        data = mapping + position;
+        return static_cast<std::size_t>(std::min<uint64_t>(maxSize, fileSize - position));
+    }
+
+    // read into the caller's buffer, seeking only when not reading on from the previous position
+    std::lock_guard<std::mutex> lock{streamMutex};
+    auto start{std::chrono::steady_clock::now()};
+    if (position != streamPosition) {
+        stream.clear();
+        stream.seekg(static_cast<std::streamoff>(position), std::ios::beg);
+    }
+    if (buffer.size() < maxSize) {
+        buffer.resize(maxSize);
+    }
+    stream.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(maxSize));
+    auto count{static_cast<std::size_t>(stream.gcount())};
+    streamPosition = position + count;
+    readNanoseconds += elapsedNanoseconds(start);
+
+    data = buffer.data();
+    return count;
+}
+
+void InputSource::release(uint64_t position, std::size_t size) {
+#if defined(INPUT_SOURCE_MMAP)
+    // bytes in memory are not ours to release
+    if (mapping == nullptr || inMemory || position >= fileSize) {
+        return;
+    }
+
+    // only whole pages can be released, so the range is shrunk to the pages it fully covers
+    auto pageSize{static_cast<uint64_t>(sysconf(_SC_PAGESIZE))};
+    uint64_t begin{(position + pageSize - 1) / pageSize * pageSize};
+    uint64_t end{std::min<uint64_t>(position + size, fileSize) / pageSize * pageSize};
+    if (begin < end) {
+        madvise(const_cast<uint8_t*>(mapping) + begin, static_cast<std::size_t>(end - begin), MADV_DONTNEED);
+    }
+#else
+    (void)position;
+    (void)size;
+#endif
+}
+
+bool InputSource::map(const std::string& path) {
+#if defined(INPUT_SOURCE_MMAP)
+    int descriptor{::open(path.c_str(), O_RDONLY)};
+    if (descriptor < 0) {
+        return false;
+    }
+
+    // only regular files can be mapped
+    struct stat status{};
+    bool mapped{false};
+    if (fstat(descriptor, &status) == 0 && S_ISREG(status.st_mode)) {
+        fileSize = static_cast<uint64_t>(status.st_size);
+        if (fileSize == 0) {
+            mapped = true;
+        } else {
+            void* address{mmap(nullptr, static_cast<std::size_t>(fileSize), PROT_READ, MAP_PRIVATE, descriptor, 0)};
+            if (address != MAP_FAILED) {
+                madvise(address, static_cast<std::size_t>(fileSize), MADV_SEQUENTIAL);
+                mapping = static_cast<const uint8_t*>(address);
+                mapped = true;
+            }
+        }
+    }
+
+    // the mapping stays valid after the file is closed
+    close(descriptor);
+    if (!mapped) {
+        fileSize = 0;
+    }
+    return mapped;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+std::size_t InputSource::viewForward(uint64_t position, std::size_t maxSize, const uint8_t*& data,
+                                     std::vector<uint8_t>& buffer) {
+    std::lock_guard<std::mutex> lock{streamMutex};
+    auto start{std::chrono::steady_clock::now()};
+    data = nullptr;
+
+    // the bytes before the last view have already been dropped
+    if (position < windowStart) {
+        return 0;
+    }
+
+    // drop the bytes before the position, skipping over any which were never read
+    uint64_t windowEnd{windowStart + window.size()};
+    if (position >= windowEnd) {
+        window.clear();
+        uint64_t skipped{position - windowEnd};
+        if (skipped > 0) {
+            forwardStream->ignore(static_cast<std::streamsize>(skipped));
+            if (static_cast<uint64_t>(forwardStream->gcount()) < skipped) {
+                windowStart = windowEnd + static_cast<uint64_t>(forwardStream->gcount());
+                return 0;
+            }
+        }
+    } else {
+        window.erase(window.begin(), window.begin() + static_cast<std::ptrdiff_t>(position - windowStart));
+    }
+    windowStart = position;
+
+    // read on until the window holds the whole view, growing it one read at a time so that a length read from a
+    // corrupted stream cannot allocate more than the stream holds
+    constexpr std::size_t READ_SIZE{1 << 20};
+    while (window.size() < maxSize && *forwardStream) {
+        std::size_t previousSize{window.size()};
+        std::size_t readSize{std::min(maxSize - previousSize, READ_SIZE)};
+        window.resize(previousSize + readSize);
+        forwardStream->read(reinterpret_cast<char*>(window.data() + previousSize),
+                            static_cast<std::streamsize>(readSize));
+        window.resize(previousSize + static_cast<std::size_t>(forwardStream->gcount()));
+    }
+    readNanoseconds += elapsedNanoseconds(start);
+
+    // copied into the caller's buffer, as the window moves on with the next view
+    std::size_t count{std::min(maxSize, window.size())};
+    if (buffer.size() < count) {
+        buffer.resize(count);
+    }
+    std::copy(window.begin(), window.begin() + static_cast<std::ptrdiff_t>(count), buffer.begin());
+    data = buffer.data();
+    return count;
+}
+
+uint64_t InputSource::elapsedNanoseconds(std::chrono::steady_clock::time_point start) {
+    auto elapsed{std::chrono::steady_clock::now() - start};
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
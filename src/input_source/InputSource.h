@@ -0,0 +1,101 @@
+// Input Source Header
+
+// The InputSource gives access to the bytes of a file being compressed or decompressed. On Linux/macOS, a regular file
+// is memory-mapped with mmap: the whole file appears in memory and its pages are loaded by the operating system as
+// they are first touched, so the bytes can be counted, encoded or decoded exactly where they are without ever being
+// copied into a buffer. The mapping is marked with madvise(MADV_SEQUENTIAL), as every pass over the file reads it from
+// start to end, so that the operating system reads well ahead of the program and drops pages soon after.
+
+// https://man7.org/linux/man-pages/man2/mmap.2.html
+// https://man7.org/linux/man-pages/man2/madvise.2.html
+
+// When the file cannot be mapped (on Windows, or for a pipe or other special file) the InputSource falls back to
+// reading through a std::ifstream. A pipe can then only be read once from start to end, as it cannot seek.
+
+// An InputSource can also be made from bytes already in memory, which are viewed in place like a mapped file (this is
+// how each block read from a pipe is compressed), or from a stream which is already open, such as std::cin. A stream
+// is never seeked: it is read strictly forward into a window, and only the bytes from the position of the last view
+// onwards are kept, so a view may start anywhere from the start of the last view on, but never before it. This is
+// all the reading of a compressed stream needs, as each of its sections is viewed in order.
+
+// An InputSource can also be a range of another InputSource, such as one member of an archive (see ArchiveReader),
+// which is then read as though it were a whole file of its own: positions start from the beginning of the range, and
+// nothing past its end can be viewed. The range of a mapped file points straight into the mapping, while any other
+// range views the other InputSource, so that a member is never copied out of the archive first.
+
+// view is the single way of reading: it makes up to maxSize bytes starting at a given position available through
+// data, and returns how many bytes that is (0 at the end of the file). For a mapped file, data simply points into the
+// mapping; otherwise the bytes are read into the buffer given by the caller, and data points to the buffer. In both
+// cases the bytes remain valid until the next call with the same buffer. view can be called by several threads at
+// once, each with its own buffer, as the fallback stream is protected by a mutex.
+
+// getReadSeconds gives the time spent reading the file so far: the time taken to map it, or for the fallback the time
+// spent in every read of the stream. For a mapped file, the pages are read by the operating system as they are first
+// touched, which is counted in the time of whatever touches them instead.
+
+// release tells the operating system that a range of a mapped file is no longer needed, so that its pages can be
+// dropped from the memory of the program right away (they stay in the file cache of the operating system, so a later
+// pass over the file is still fast). Every pass releases each block once it is done with it, so that memory use does
+// not grow with the size of the file, which matters most in streaming mode.
+
+#ifndef INPUT_SOURCE_H
+#define INPUT_SOURCE_H
+
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class InputSource {
+public:
+    // constructors
+    explicit InputSource(const std::string& path);
+    InputSource(const uint8_t* data, std::size_t size); // bytes in memory, which must outlive the InputSource
+    explicit InputSource(std::istream& source); // an open stream, read only from start to end
+    InputSource(InputSource& source, uint64_t offset, uint64_t size); // a range of source, which must outlive it
+    ~InputSource();
+    InputSource(const InputSource&) = delete;
+    InputSource& operator=(const InputSource&) = delete;
+
+    std::size_t view(uint64_t position, std::size_t maxSize, const uint8_t*& data, std::vector<uint8_t>& buffer);
+    void release(uint64_t position, std::size_t size);
+
+    [[nodiscard]] bool isOpen() const { return open; }
+    [[nodiscard]] bool isMapped() const { return mapping != nullptr; }
+    [[nodiscard]] uint64_t size() const { return fileSize; } // 0 if unknown (such as for a pipe)
+    [[nodiscard]] double getReadSeconds() const { return static_cast<double>(readNanoseconds) / 1e9; }
+
+private:
+    bool open{false};
+    bool inMemory{false}; // the mapping points to bytes in memory rather than a mapped file
+    const uint8_t* mapping{nullptr};
+    uint64_t fileSize{0};
+    std::atomic<uint64_t> readNanoseconds{0};
+
+    // buffered fallback
+    std::ifstream stream{};
+    uint64_t streamPosition{0};
+    std::mutex streamMutex{};
+
+    // open stream, read strictly forward
+    std::istream* forwardStream{nullptr};
+    std::vector<uint8_t> window{}; // bytes read from the stream from windowStart onwards
+    uint64_t windowStart{0};
+
+    // range of another InputSource which is not mapped
+    InputSource* parent{nullptr};
+    uint64_t parentOffset{0};
+
+    bool map(const std::string& path); // returns false if the file cannot be mapped
+    std::size_t viewForward(uint64_t position, std::size_t maxSize, const uint8_t*& data, std::vector<uint8_t>& buffer);
+    static uint64_t elapsedNanoseconds(std::chrono::steady_clock::time_point start);
+};
+
+
+#endif // INPUT_SOURCE_H
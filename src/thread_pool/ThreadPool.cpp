@@ -0,0 +1,70 @@
+// Thread Pool Implementation
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned threadCount) {
+    threadCount = std::max(threadCount, 1u);
+    for (unsigned i{0}; i < threadCount; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        tasks.push(std::move(task));
+        ++unfinishedTasks;
+    }
+    taskAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock{mutex};
+    tasksFinished.wait(lock, [this] { return unfinishedTasks == 0; });
+}
+
+unsigned ThreadPool::defaultThreadCount() {
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            taskAvailable.wait(lock, [this] { return stopping || !tasks.empty(); });
+
+            // queued tasks are still finished when stopping
+            if (tasks.empty()) {
+                return;
+            }
+
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+
+        task();
+
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            --unfinishedTasks;
+            if (unfinishedTasks == 0) {
+                tasksFinished.notify_all();
+            }
+        }
+    }
+}
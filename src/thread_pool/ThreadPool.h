@@ -0,0 +1,51 @@
+// Thread Pool Header
+
+// The ThreadPool keeps a fixed number of worker threads alive for its lifetime and runs submitted tasks on them, so
+// that work split into independent pieces (such as chunks of a large file) can use every core of the computer without
+// creating a thread per piece. Tasks are taken from a shared first-in first-out queue protected by a mutex.
+
+// wait blocks the calling thread until every submitted task has finished, after which results written by the tasks
+// can be safely read. The destructor finishes any queued tasks and joins the workers.
+
+// https://en.cppreference.com/w/cpp/thread/condition_variable
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threadCount); // constructor
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+    void wait(); // post-condition: every submitted task has finished
+
+    [[nodiscard]] std::size_t getThreadCount() const { return workers.size(); }
+
+    static unsigned defaultThreadCount(); // number of hardware threads, at least 1
+
+private:
+    std::vector<std::thread> workers{};
+    std::queue<std::function<void()>> tasks{};
+    std::mutex mutex{};
+    std::condition_variable taskAvailable{};
+    std::condition_variable tasksFinished{};
+    std::size_t unfinishedTasks{0};
+    bool stopping{false};
+
+    void workerLoop();
+};
+
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,112 @@
+// Work Stealing Pool Implementation
+
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(unsigned threadCount) {
+    threadCount = std::max(threadCount, 1u);
+    for (unsigned i{0}; i < threadCount; ++i) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (unsigned i{0}; i < threadCount; ++i) {
+        workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkStealingPool::submit(std::function<void()> task) {
+    // deal the task to the next queue in turn
+    std::size_t index{0};
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        index = nextQueue;
+        nextQueue = (nextQueue + 1) % queues.size();
+    }
+    {
+        std::lock_guard<std::mutex> lock{queues[index]->mutex};
+        queues[index]->tasks.push_back(std::move(task));
+    }
+
+    // only counted once it is in a queue, so that a reserved task can always be found
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        ++queuedTasks;
+        ++unfinishedTasks;
+    }
+    taskAvailable.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lock{mutex};
+    tasksFinished.wait(lock, [this] { return unfinishedTasks == 0; });
+}
+
+void WorkStealingPool::workerLoop(std::size_t index) {
+    while (true) {
+        // reserve one of the queued tasks, sleeping until there is one
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            taskAvailable.wait(lock, [this] { return stopping || queuedTasks > 0; });
+
+            // queued tasks are still finished when stopping
+            if (queuedTasks == 0) {
+                return;
+            }
+            --queuedTasks;
+        }
+
+        // the reserved task is in one of the queues, though another worker may take the one first seen
+        std::function<void()> task;
+        while (!takeTask(index, task)) {
+            std::this_thread::yield();
+        }
+
+        task();
+
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            --unfinishedTasks;
+            if (unfinishedTasks == 0) {
+                tasksFinished.notify_all();
+            }
+        }
+    }
+}
+
+bool WorkStealingPool::takeTask(std::size_t index, std::function<void()>& task) {
+    // take from the front of the worker's own queue first
+    {
+        WorkerQueue& queue{*queues[index]};
+        std::lock_guard<std::mutex> lock{queue.mutex};
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+
+    // otherwise steal from the back of the other queues, starting with the next one
+    for (std::size_t offset{1}; offset < queues.size(); ++offset) {
+        WorkerQueue& queue{*queues[(index + offset) % queues.size()]};
+        std::lock_guard<std::mutex> lock{queue.mutex};
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            return true;
+        }
+    }
+
+    return false;
+}
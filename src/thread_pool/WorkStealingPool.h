@@ -0,0 +1,66 @@
+// Work Stealing Pool Header
+
+// The WorkStealingPool runs submitted tasks on a fixed number of worker threads like the ThreadPool, but every worker
+// has its own queue of tasks instead of all of them sharing one. Tasks are dealt out to the queues in turn as they are
+// submitted, and each worker takes tasks from the front of its own queue, in the order they were submitted. Only when
+// its own queue is empty does a worker steal a task from the back of another worker's queue, so workers rarely compete
+// for the same queue, and no worker is idle while any task is still waiting.
+
+// This suits a large number of independent tasks of very different sizes (such as whole files in the batch mode of
+// the driver), where a single shared queue would be locked by every worker for every task. A count of queued tasks
+// (protected by the mutex of the pool) lets idle workers sleep until a task is submitted, and each worker reserves a
+// task from the count before looking for it, so a worker never searches the queues in vain for long.
+
+// https://en.wikipedia.org/wiki/Work_stealing
+
+// wait and the destructor behave exactly as they do for the ThreadPool.
+
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned threadCount); // constructor
+    ~WorkStealingPool();
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(std::function<void()> task);
+    void wait(); // post-condition: every submitted task has finished
+
+    [[nodiscard]] std::size_t getThreadCount() const { return workers.size(); }
+
+private:
+    class WorkerQueue {
+    public:
+        std::deque<std::function<void()>> tasks{};
+        std::mutex mutex{};
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues{}; // one per worker
+    std::vector<std::thread> workers{};
+    std::size_t nextQueue{0}; // queue given the next submitted task
+
+    std::mutex mutex{};
+    std::condition_variable taskAvailable{};
+    std::condition_variable tasksFinished{};
+    std::size_t queuedTasks{0}; // tasks in the queues which no worker has reserved
+    std::size_t unfinishedTasks{0};
+    bool stopping{false};
+
+    void workerLoop(std::size_t index);
+    bool takeTask(std::size_t index, std::function<void()>& task); // returns false if every queue is empty
+};
+
+
+#endif // WORK_STEALING_POOL_H
@@ -0,0 +1,178 @@
+// Checksum Utilities Implementation
+
+#include "checksum_utils.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CHECKSUM_X86_CRC
+#include <nmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#define CHECKSUM_ARM_CRC
+#include <arm_acle.h>
+#endif
+
+// the CRC instruction is only compiled into the function which uses it, so the rest of the program still runs on a
+// processor without it
+#if defined(CHECKSUM_X86_CRC) && defined(__GNUC__)
+#define CHECKSUM_HARDWARE_TARGET __attribute__((target("sse4.2")))
+#else
+#define CHECKSUM_HARDWARE_TARGET
+#endif
+
+namespace {
+    constexpr uint32_t POLYNOMIAL{0x82F63B78}; // the Castagnoli polynomial, bit-reversed
+
+    using SlicingTables = std::array<std::array<uint32_t, 256>, 8>;
+
+    SlicingTables buildSlicingTables() {
+        // the first table holds the remainder of every byte, and each further table that of the byte followed by
+        // one more zero byte than the table before it
+        SlicingTables tables{};
+        for (uint32_t byte{0}; byte < 256; ++byte) {
+            uint32_t remainder{byte};
+            for (int bit{0}; bit < 8; ++bit) {
+                remainder = (remainder & 1) != 0 ? (remainder >> 1) ^ POLYNOMIAL : remainder >> 1;
+            }
+            tables[0][byte] = remainder;
+        }
+        for (std::size_t table{1}; table < tables.size(); ++table) {
+            for (std::size_t byte{0}; byte < 256; ++byte) {
+                uint32_t previous{tables[table - 1][byte]};
+                tables[table][byte] = (previous >> 8) ^ tables[0][previous & 0xFF];
+            }
+        }
+        return tables;
+    }
+
+    const SlicingTables& slicingTables() {
+        static const SlicingTables tables{buildSlicingTables()};
+        return tables;
+    }
+
+    uint32_t readUInt32LittleEndian(const uint8_t* data) {
+        return static_cast<uint32_t>(data[0]) | static_cast<uint32_t>(data[1]) << 8 |
+            static_cast<uint32_t>(data[2]) << 16 | static_cast<uint32_t>(data[3]) << 24;
+    }
+
+#if defined(CHECKSUM_X86_CRC) || defined(CHECKSUM_ARM_CRC)
+    CHECKSUM_HARDWARE_TARGET uint32_t updateCrc32cHardware(uint32_t checksum, const uint8_t* data, std::size_t size) {
+        uint32_t crc{~checksum};
+        while (size >= 8) {
+            uint64_t word{0};
+            std::memcpy(&word, data, sizeof(word));
+#if defined(CHECKSUM_X86_CRC)
+            crc = static_cast<uint32_t>(_mm_crc32_u64(crc, word));
+#else
+            crc = __crc32cd(crc, word);
+#endif
+            data += 8;
+            size -= 8;
+        }
+        for (; size > 0; --size) {
+#if defined(CHECKSUM_X86_CRC)
+            crc = _mm_crc32_u8(crc, *data++);
+#else
+            crc = __crc32cb(crc, *data++);
+#endif
+        }
+        return ~crc;
+    }
+#endif
+
+    // multiplies two polynomials modulo the CRC polynomial, where the highest bit is x^0
+    uint32_t multiplyModulo(uint32_t a, uint32_t b) {
+        if (a == 0) {
+            return 0;
+        }
+        uint32_t mask{1u << 31};
+        uint32_t product{0};
+        while (true) {
+            if ((a & mask) != 0) {
+                product ^= b;
+                if ((a & (mask - 1)) == 0) {
+                    break;
+                }
+            }
+            mask >>= 1;
+            b = (b & 1) != 0 ? (b >> 1) ^ POLYNOMIAL : b >> 1;
+        }
+        return product;
+    }
+
+    // x^(count * 2^power) modulo the CRC polynomial, from the squares x^(2^k)
+    uint32_t powerModulo(uint64_t count, unsigned power) {
+        static const std::array<uint32_t, 32> squares{[] {
+            std::array<uint32_t, 32> result{};
+            result[0] = 1u << 30; // x^1
+            for (std::size_t k{1}; k < result.size(); ++k) {
+                result[k] = multiplyModulo(result[k - 1], result[k - 1]);
+            }
+            return result;
+        }()};
+
+        uint32_t result{1u << 31}; // x^0
+        for (; count != 0; count >>= 1, ++power) {
+            if ((count & 1) != 0) {
+                result = multiplyModulo(squares[power & 31], result);
+            }
+        }
+        return result;
+    }
+}
+
+uint32_t updateCrc32c(uint32_t checksum, const uint8_t* data, std::size_t size) {
+#if defined(CHECKSUM_X86_CRC) || defined(CHECKSUM_ARM_CRC)
+    static const bool hardware{hasHardwareCrc32c()};
+    if (hardware) {
+        return updateCrc32cHardware(checksum, data, size);
+    }
+#endif
+    return updateCrc32cSoftware(checksum, data, size);
+}
+
+uint32_t updateCrc32cSoftware(uint32_t checksum, const uint8_t* data, std::size_t size) {
+    const SlicingTables& tables{slicingTables()};
+    uint32_t crc{~checksum};
+
+    // 8 bytes at a time, each looked up in its own table
+    while (size >= 8) {
+        uint32_t low{readUInt32LittleEndian(data) ^ crc};
+        uint32_t high{readUInt32LittleEndian(data + 4)};
+        crc = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF] ^ tables[5][(low >> 16) & 0xFF] ^
+            tables[4][low >> 24] ^ tables[3][high & 0xFF] ^ tables[2][(high >> 8) & 0xFF] ^
+            tables[1][(high >> 16) & 0xFF] ^ tables[0][high >> 24];
+        data += 8;
+        size -= 8;
+    }
+
+    // then the bytes left one at a time
+    for (; size > 0; --size) {
+        crc = (crc >> 8) ^ tables[0][(crc ^ *data++) & 0xFF];
+    }
+    return ~crc;
+}
+
+uint32_t combineCrc32c(uint32_t first, uint32_t second, uint64_t secondLength) {
+    // shifting the first checksum past every bit of the second chunk gives the checksum of the first chunk followed
+    // by zeros, to which the checksum of the second chunk adds its own bits
+    return multiplyModulo(powerModulo(secondLength, 3), first) ^ second;
+}
+
+bool hasHardwareCrc32c() {
+#if defined(CHECKSUM_X86_CRC) && defined(_MSC_VER)
+    int registers[4]{};
+    __cpuid(registers, 1);
+    return (registers[2] & (1 << 20)) != 0;
+#elif defined(CHECKSUM_X86_CRC)
+    return __builtin_cpu_supports("sse4.2") != 0;
+#elif defined(CHECKSUM_ARM_CRC)
+    return true;
+#else
+    return false;
+#endif
+}
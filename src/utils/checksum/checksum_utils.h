@@ -0,0 +1,41 @@
+// Checksum Utilities Header
+
+// A corrupted Huffman Code usually still decodes, only to the wrong characters, so nothing but a checksum of the
+// original file can tell that a decompressed file is not the file that was compressed. The CRC32C (Castagnoli) of the
+// original file is therefore written after the Huffman Code (see HuffmanHeader), and checked against the CRC32C of
+// the decompressed file.
+
+// https://en.wikipedia.org/wiki/Cyclic_redundancy_check
+
+// Neither side reads the file again for this: updateCrc32c is called on each block of the original file as it is
+// encoded, right before the block is encoded (while it is still in the cache), and on each buffer of characters as it
+// is decoded, right before the buffer is written. The checksum starts from 0 and carries on from one block to the
+// next, so the blocks of a file give the same checksum as the whole file at once.
+
+// updateCrc32c uses the CRC32 instruction of the processor where it has one (SSE 4.2 on x86-64, checked when the
+// program starts, or the CRC extension of ARMv8 when the program is compiled for it), which processes 8 bytes per
+// instruction. Otherwise updateCrc32cSoftware is used, which looks up 8 tables of 256 entries per 8 bytes
+// (slicing-by-8) rather than 1 table per byte, so that the 8 lookups do not wait on each other.
+
+// https://www.intel.com/content/www/us/en/docs/intrinsics-guide/index.html#text=crc32
+
+// When chunks of a file are encoded or decoded by several threads, each thread computes the checksum of its own chunk,
+// and combineCrc32c then gives the checksum of two consecutive chunks from their checksums and the length of the
+// second chunk, by multiplying the first checksum by x^(8 * length) modulo the CRC polynomial.
+
+// https://github.com/madler/zlib/blob/master/crc32.c
+
+#ifndef CHECKSUM_UTILS_H
+#define CHECKSUM_UTILS_H
+
+
+#include <cstddef>
+#include <cstdint>
+
+uint32_t updateCrc32c(uint32_t checksum, const uint8_t* data, std::size_t size);
+uint32_t updateCrc32cSoftware(uint32_t checksum, const uint8_t* data, std::size_t size);
+uint32_t combineCrc32c(uint32_t first, uint32_t second, uint64_t secondLength);
+bool hasHardwareCrc32c();
+
+
+#endif // CHECKSUM_UTILS_H
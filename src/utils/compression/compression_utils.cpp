@@ -2,104 +2,753 @@
 
 #include "compression_utils.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <vector>
+
+#include "huffman_tree/bit_stream/BitReader.h"
+#include "huffman_tree/bit_stream/BitWriter.h"
+#include "utils/checksum/checksum_utils.h"
+#include "utils/instantiate/instantiate_utils.h"
 
 // compress helper functions
 
-void writeSection(std::ofstream& output, const std::string& section) {
-    std::string string{section}; // copy over section string
-    // the calculation in parentheses gives us number of 0s to pad; extra % 8 ensures that
-    // if the string is already divisible by 8, then the padding becomes 0
-    std::size_t paddingCount{(8 - (section.length() % 8)) % 8};
-    string.append(paddingCount, '0'); // pad as necessary
-
-    // follow previous loop to write byte chunks
-    for (std::size_t i{0}; i < string.length(); i += 8) {
-        // construct the 8-bit byte chunk by setting the appropriate bit
-        // this time use the left shift operator (<<) to set the appropriate bit which gets set to byte
-        // via the bitwise OR operator (|)
-        int byte{0};
-        for (int j{0}; j < 8; ++j) {
-            if (string[i + j] == '1') {
-                // integer 1 represented as 00000001
-                byte |= (1 << (7 - j));
-            }
-        }
+void writeSection(std::ostream& output, const PackedBits& section) {
+    // the packed bytes already contain the padding of 0s in the last byte, so write them in a single call
+    output.write(reinterpret_cast<const char*>(section.bytes.data()),
+                 static_cast<std::streamsize>(section.byteLength()));
+}
 
-        // write byte chunk into file
-        char charByte{static_cast<char>(byte)};
-        output.write(&charByte, 1);
+void writeHeader(std::ostream& output, const HuffmanHeader& header) {
+    // always written as the current version
+    PackedBits headerBits{};
+    BitWriter writer{headerBits};
+    for (uint8_t byte : HuffmanHeader::MAGIC) {
+        writer.writeByte(byte);
     }
+    writer.writeByte(HuffmanHeader::CURRENT_VERSION);
+    for (uint64_t value : {header.flags, header.originalSize, header.infoLength, header.treeLength,
+                           header.encodingLength}) {
+        writeVarint(writer, value);
+    }
+    writer.flush();
+
+    writeSection(output, headerBits);
 }
 
-void writeCompressedFile(const std::string& destination, const HuffmanHeader& header, const std::string& information,
-                         const std::string& representation, const std::string& encoding) {
-    std::ofstream output{destination, std::ios::out | std::ios::binary}; // write in binary mode
-    if (!output) {
-        std::cout << "File Write Error\n";
-        return;
+void writeVarint(BitWriter& writer, uint64_t value) {
+    // 7 bits at a time, setting the high bit while more bytes follow
+    while (value >= 0x80) {
+        writer.writeByte(static_cast<uint8_t>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    writer.writeByte(static_cast<uint8_t>(value));
+}
+
+void writeUInt32(BitWriter& writer, uint32_t value) {
+    for (int i{0}; i < 4; ++i) {
+        writer.writeByte(static_cast<uint8_t>(value >> (i * 8)));
     }
+}
 
+void writeUInt64(BitWriter& writer, uint64_t value) {
+    writeUInt32(writer, static_cast<uint32_t>(value));
+    writeUInt32(writer, static_cast<uint32_t>(value >> 32));
+}
+
+void writeChecksum(std::ostream& output, uint32_t checksum) {
+    PackedBits checksumBits{};
+    BitWriter writer{checksumBits};
+    writeUInt32(writer, checksum);
+    writer.flush();
+    writeSection(output, checksumBits);
+}
+
+void writeBlockIndex(std::ostream& output, const BlockIndex& blockIndex) {
+    PackedBits indexBits{};
+    BitWriter writer{indexBits};
+    for (const BlockIndexEntry& entry : blockIndex.entries) {
+        writeUInt64(writer, entry.bitOffset);
+        writeUInt64(writer, entry.outputOffset);
+        if (blockIndex.previousCharacters) {
+            writer.writeByte(entry.previous);
+        }
+    }
+    writeUInt64(writer, blockIndex.originalSize);
+    writeUInt32(writer, static_cast<uint32_t>(blockIndex.entries.size()));
+    writeUInt32(writer, BlockIndex::MAGIC);
+    writer.flush();
+
+    writeSection(output, indexBits);
+}
+
+void writeCompressedFile(std::ostream& output, const HuffmanHeader& header, const PackedBits& information,
+                         const PackedBits& representation, const PackedBits& encoding, uint32_t checksum,
+                         const BlockIndex& blockIndex) {
     // write to file each section
-    output.write(reinterpret_cast<const char*>(&header), sizeof(HuffmanHeader)); // always 12 bytes
+    writeHeader(output, header); // at least 10 bytes
     writeSection(output, information); // always in byte chunks
     writeSection(output, representation); // may have padding at the end
     writeSection(output, encoding); // may have padding at the end
+    if (header.hasFlag(HuffmanHeader::CHECKSUM)) {
+        writeChecksum(output, checksum); // always 4 bytes
+    }
 
-    output.close();
+    // the block index is only worth writing when there is more than one block
+    if (!blockIndex.empty()) {
+        writeBlockIndex(output, blockIndex);
+    }
+}
+
+void writeStreamedCompressedFile(std::ostream& output, const HuffmanHeader& header, const PackedBits& information,
+                                 const PackedBits& representation, InputSource& input,
+                                 const BlockEncoder& encodeBlock, std::size_t blockSize) {
+    // the first sections are written as usual, with the STREAMED flag set in the header
+    writeHeader(output, header);
+    writeSection(output, information);
+    writeSection(output, representation);
+
+    // the input block and encoded block are reused, and every block of the file is released once encoded,
+    // so memory use is the same for every block
+    std::vector<uint8_t> block{};
+    const uint8_t* data{nullptr};
+    PackedBits encodedBlock{};
+    uint64_t position{0};
+    uint32_t checksum{0};
+    while (std::size_t count{input.view(position, blockSize, data, block)}) {
+        // each block ends on a whole character, so it can be padded and decoded independently
+        checksum = updateCrc32c(checksum, data, count);
+        encodedBlock.clear();
+        BitWriter writer{encodedBlock};
+        encodeBlock(data, count, writer);
+        writer.flush();
+
+        writeBlockLength(output, encodedBlock.bitLength);
+        writeSection(output, encodedBlock);
+
+        input.release(position, count);
+        position += count;
+    }
+
+    // a block with a length of 0 terminates the Huffman Code
+    writeBlockLength(output, 0);
+    if (header.hasFlag(HuffmanHeader::CHECKSUM)) {
+        writeChecksum(output, checksum);
+    }
+}
+
+void writeBlockLength(std::ostream& output, uint64_t bitLength) {
+    PackedBits lengthBits{};
+    BitWriter writer{lengthBits};
+    writeVarint(writer, bitLength);
+    writer.flush();
+    writeSection(output, lengthBits);
+}
+
+void writePipedBlock(std::ostream& output, uint64_t originalSize, const PackedBits& lengthTable,
+                     const PackedBits& encoding) {
+    PackedBits lengthBits{};
+    BitWriter writer{lengthBits};
+    for (uint64_t value : {originalSize, lengthTable.bitLength, encoding.bitLength}) {
+        writeVarint(writer, value);
+    }
+    writer.flush();
+
+    writeSection(output, lengthBits);
+    writeSection(output, lengthTable);
+    writeSection(output, encoding);
+}
+
+void writeArchiveHeader(std::ostream& output) {
+    PackedBits headerBits{};
+    BitWriter writer{headerBits};
+    for (uint8_t byte : ArchiveIndex::MAGIC) {
+        writer.writeByte(byte);
+    }
+    writer.writeByte(ArchiveIndex::CURRENT_VERSION);
+    writer.flush();
+
+    writeSection(output, headerBits);
+}
+
+void writeArchiveIndex(std::ostream& output, const ArchiveIndex& archiveIndex, uint64_t indexOffset) {
+    PackedBits indexBits{};
+    BitWriter writer{indexBits};
+    for (const ArchiveEntry& entry : archiveIndex.entries) {
+        writeVarint(writer, entry.name.size());
+        for (char character : entry.name) {
+            writer.writeByte(static_cast<uint8_t>(character));
+        }
+        for (uint64_t value : {entry.offset, entry.compressedSize, entry.originalSize}) {
+            writeVarint(writer, value);
+        }
+        writeUInt32(writer, entry.dictionaryId);
+    }
+    writeUInt64(writer, indexOffset);
+    writeUInt32(writer, static_cast<uint32_t>(archiveIndex.entries.size()));
+    writeUInt32(writer, ArchiveIndex::INDEX_MAGIC);
+    writer.flush();
+
+    writeSection(output, indexBits);
+}
+
+bool writeDictionaryFile(const std::string& destination, const Dictionary& dictionary) {
+    std::ofstream output{destination, std::ios::out | std::ios::binary}; // write in binary mode
+    if (!output) {
+        std::cout << "File Write Error\n";
+        return false;
+    }
+
+    // the magic bytes, version and ID, followed by the code length table
+    PackedBits contents{};
+    BitWriter writer{contents};
+    for (uint8_t byte : Dictionary::MAGIC) {
+        writer.writeByte(byte);
+    }
+    writer.writeByte(Dictionary::CURRENT_VERSION);
+    writeUInt32(writer, dictionary.getId());
+    generateCodeLengthTable(writer, dictionary.getEncodingTable());
+    writer.flush();
+
+    writeSection(output, contents);
+    return static_cast<bool>(output);
 }
 
 // decompress helper functions
 
-void readSection(std::ifstream& input, std::string& section, uint32_t size) {
+void readSection(InputSource& input, uint64_t& position, PackedBits& section, uint64_t size) {
     section.clear();
 
-    // read the section and instantiate the appropriate data member
-    int bytesCount{(static_cast<int>(size) + 7) / 8};
-    for (int i{0}; i < bytesCount; ++i) {
-        // this ensures file pointer ends after the padding
-        char byte{};
-        input.read(&byte, 1);
+    // copy the whole section at once, including the padding, and move the position past it
+    section.bitLength = size;
+    const uint8_t* data{nullptr};
+    std::size_t count{input.view(position, section.byteLength(), data, section.bytes)};
+    if (data != section.bytes.data()) {
+        section.bytes.assign(data, data + count);
+    }
+    section.bytes.resize(count);
+    position += count;
+}
+
+bool readHeader(InputSource& input, uint64_t& position, HuffmanHeader& header) {
+    // the first 4 bytes are either the magic bytes or the first length of a version 1 header
+    std::vector<uint8_t> buffer{};
+    const uint8_t* data{nullptr};
+    if (input.view(position, 5, data, buffer) < 5) {
+        std::cout << "Error: File is too short to be a compressed file.\n";
+        return false;
+    }
 
-        for (int j{0}; j < 8; ++j) {
-            if (i * 8 + j < static_cast<int>(size)) { // don't count padding bits
-                section += (byte & (1 << (7 - j))) ? '1' : '0';
-            }
+    bool isMagic{true};
+    for (int i{0}; i < 4; ++i) {
+        isMagic = isMagic && data[i] == HuffmanHeader::MAGIC[i];
+    }
+
+    if (!isMagic) {
+        // version 1: three 32-bit lengths stored least significant byte first
+        PackedBits headerBits{};
+        readSection(input, position, headerBits, 12 * 8);
+        if (headerBits.bytes.size() < 12) {
+            std::cout << "Error: File is too short to be a compressed file.\n";
+            return false;
+        }
+
+        BitReader reader{headerBits};
+        header.version = 1;
+        header.flags = 0;
+        header.originalSize = 0;
+        header.infoLength = readUInt32(reader);
+        header.treeLength = readUInt32(reader);
+        header.encodingLength = readUInt32(reader);
+        return true;
+    }
+
+    // version 2 onwards: reject versions newer than this program
+    header.version = data[4];
+    position += 5;
+    if (header.version < 2 || header.version > HuffmanHeader::CURRENT_VERSION) {
+        std::cout << "Error: Unsupported .hzip version " << static_cast<int>(header.version) << ".\n";
+        return false;
+    }
+
+    for (uint64_t* value : {&header.flags, &header.originalSize, &header.infoLength, &header.treeLength,
+                            &header.encodingLength}) {
+        if (!readVarint(input, position, *value)) {
+            std::cout << "Error: Corrupted .hzip header.\n";
+            return false;
+        }
+    }
+
+    // a flag this program does not know changes how the file is read, so the file cannot be read correctly
+    if ((header.flags & ~HuffmanHeader::KNOWN_FLAGS) != 0) {
+        std::cout << "Error: Unsupported .hzip features.\n";
+        return false;
+    }
+
+    return true;
+}
+
+bool readVarint(InputSource& input, uint64_t& position, uint64_t& value) {
+    // view the most bytes a varint can take, which may go past the end of the file
+    std::vector<uint8_t> buffer{};
+    const uint8_t* data{nullptr};
+    std::size_t count{input.view(position, 10, data, buffer)};
+
+    value = 0;
+    for (std::size_t i{0}; i < count; ++i) {
+        value |= static_cast<uint64_t>(data[i] & 0x7F) << (i * 7);
+        if ((data[i] & 0x80) == 0) {
+            position += i + 1;
+            return true;
         }
     }
+
+    return false; // the file ended, or more than 10 bytes cannot be a 64-bit value
+}
+
+bool readVarint(BitReader& reader, uint64_t& value) {
+    // the same as from a file, a byte at a time from the reader
+    value = 0;
+    for (unsigned i{0}; i < 10 && reader.remaining() >= 8; ++i) {
+        uint8_t byte{reader.readByte()};
+        value |= static_cast<uint64_t>(byte & 0x7F) << (i * 7);
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+uint32_t readUInt32(BitReader& reader) {
+    uint32_t value{0};
+    for (int i{0}; i < 4; ++i) {
+        value |= static_cast<uint32_t>(reader.readByte()) << (i * 8);
+    }
+    return value;
 }
 
-void readCompressedFile(std::ifstream& input, HuffmanHeader& header, std::string& information,
-                        std::string& representation, std::string& encoding) {
+uint64_t readUInt64(BitReader& reader) {
+    uint64_t low{readUInt32(reader)};
+    uint64_t high{readUInt32(reader)};
+    return low | (high << 32);
+}
+
+bool readChecksum(InputSource& input, uint64_t& position, uint32_t& checksum) {
+    PackedBits checksumBits{};
+    readSection(input, position, checksumBits, 32);
+    BitReader checksumReader{checksumBits};
+    checksum = readUInt32(checksumReader);
+    return checksumBits.bytes.size() == 4;
+}
+
+bool readBlockIndex(InputSource& input, BlockIndex& blockIndex, bool previousCharacters) {
+    blockIndex.entries.clear();
+    blockIndex.originalSize = 0;
+    blockIndex.previousCharacters = previousCharacters;
+
+    // the index is at the end of the file
+    uint64_t fileSize{input.size()};
+    if (fileSize < BlockIndex::TRAILER_SIZE) {
+        return false;
+    }
+
+    // check the trailer for the magic value
+    PackedBits trailerBits{};
+    uint64_t position{fileSize - BlockIndex::TRAILER_SIZE};
+    readSection(input, position, trailerBits, BlockIndex::TRAILER_SIZE * 8);
+    BitReader trailerReader{trailerBits};
+    uint64_t originalSize{readUInt64(trailerReader)};
+    uint32_t entryCount{readUInt32(trailerReader)};
+    uint32_t magic{readUInt32(trailerReader)};
+    uint64_t indexSize{uint64_t{entryCount} * blockIndex.entrySize() + BlockIndex::TRAILER_SIZE};
+    if (trailerBits.bytes.size() < BlockIndex::TRAILER_SIZE || magic != BlockIndex::MAGIC || indexSize > fileSize) {
+        return false;
+    }
+
+    PackedBits indexBits{};
+    position = fileSize - indexSize;
+    readSection(input, position, indexBits, uint64_t{entryCount} * blockIndex.entrySize() * 8);
+    BitReader indexReader{indexBits};
+    for (uint32_t i{0}; i < entryCount; ++i) {
+        BlockIndexEntry entry{};
+        entry.bitOffset = readUInt64(indexReader);
+        entry.outputOffset = readUInt64(indexReader);
+        if (previousCharacters) {
+            entry.previous = indexReader.readByte();
+        }
+        blockIndex.entries.push_back(entry);
+    }
+    blockIndex.originalSize = originalSize;
+
+    return indexBits.bytes.size() == indexBits.byteLength();
+}
+
+bool readArchiveIndex(InputSource& input, ArchiveIndex& archiveIndex) {
+    archiveIndex.entries.clear();
+
+    // the archive starts with its magic bytes and version
+    uint64_t fileSize{input.size()};
+    PackedBits headerBits{};
+    uint64_t position{0};
+    readSection(input, position, headerBits, ArchiveIndex::HEADER_SIZE * 8);
+    BitReader headerReader{headerBits};
+    bool isMagic{headerBits.bytes.size() == ArchiveIndex::HEADER_SIZE};
+    for (uint8_t byte : ArchiveIndex::MAGIC) {
+        isMagic = isMagic && headerReader.readByte() == byte;
+    }
+    if (!isMagic || fileSize < ArchiveIndex::HEADER_SIZE + ArchiveIndex::TRAILER_SIZE) {
+        std::cout << "Error: File is not an archive.\n";
+        return false;
+    }
+    uint8_t version{headerReader.readByte()};
+    if (version < 1 || version > ArchiveIndex::CURRENT_VERSION) {
+        std::cout << "Error: Unsupported archive version " << static_cast<int>(version) << ".\n";
+        return false;
+    }
+
+    // the trailer at the end of the archive gives where the index starts
+    PackedBits trailerBits{};
+    position = fileSize - ArchiveIndex::TRAILER_SIZE;
+    readSection(input, position, trailerBits, ArchiveIndex::TRAILER_SIZE * 8);
+    BitReader trailerReader{trailerBits};
+    uint64_t indexOffset{readUInt64(trailerReader)};
+    uint32_t entryCount{readUInt32(trailerReader)};
+    uint32_t magic{readUInt32(trailerReader)};
+    uint64_t indexEnd{fileSize - ArchiveIndex::TRAILER_SIZE};
+    if (magic != ArchiveIndex::INDEX_MAGIC || indexOffset < ArchiveIndex::HEADER_SIZE || indexOffset > indexEnd) {
+        std::cout << "Error: Archive index is corrupted.\n";
+        return false;
+    }
+
+    // every entry must lie between the header and the index, and come after the entry before it by name
+    PackedBits indexBits{};
+    position = indexOffset;
+    readSection(input, position, indexBits, (indexEnd - indexOffset) * 8);
+    BitReader indexReader{indexBits};
+    for (uint32_t i{0}; i < entryCount; ++i) {
+        ArchiveEntry entry{};
+        uint64_t nameLength{0};
+        if (!readVarint(indexReader, nameLength) || nameLength > ArchiveIndex::MAX_NAME_LENGTH ||
+            indexReader.remaining() < nameLength * 8) {
+            break;
+        }
+        for (uint64_t j{0}; j < nameLength; ++j) {
+            entry.name.push_back(static_cast<char>(indexReader.readByte()));
+        }
+        if (!readVarint(indexReader, entry.offset) || !readVarint(indexReader, entry.compressedSize) ||
+            !readVarint(indexReader, entry.originalSize) || indexReader.remaining() < 32) {
+            break;
+        }
+        entry.dictionaryId = readUInt32(indexReader);
+
+        bool inArchive{entry.offset >= ArchiveIndex::HEADER_SIZE && entry.offset <= indexOffset &&
+            entry.compressedSize <= indexOffset - entry.offset};
+        bool sorted{archiveIndex.entries.empty() || archiveIndex.entries.back().name < entry.name};
+        if (!inArchive || !sorted) {
+            break;
+        }
+        archiveIndex.entries.push_back(entry);
+    }
+
+    if (archiveIndex.entries.size() != entryCount) {
+        archiveIndex.entries.clear();
+        std::cout << "Error: Archive index is corrupted.\n";
+        return false;
+    }
+    return true;
+}
+
+bool readPipedBlock(InputSource& input, uint64_t& position, uint64_t& originalSize, PackedBits& lengthTable,
+                    uint64_t& encodingLength) {
+    uint64_t tableLength{0};
+    if (!readVarint(input, position, originalSize)) {
+        return false;
+    }
+    if (originalSize == 0) {
+        return true; // the terminating block
+    }
+    if (!readVarint(input, position, tableLength) || !readVarint(input, position, encodingLength)) {
+        return false;
+    }
+
+    // every character takes at least 1 bit and at most MAX_CHARACTER_BITS
+    if (originalSize > MAX_PIPED_BLOCK_SIZE || tableLength > MAX_CODE_LENGTH_TABLE_BITS ||
+        encodingLength < originalSize || encodingLength > originalSize * MAX_CHARACTER_BITS) {
+        return false;
+    }
+
+    readSection(input, position, lengthTable, tableLength);
+    return lengthTable.bytes.size() == lengthTable.byteLength();
+}
+
+bool readCompressedFile(InputSource& input, HuffmanHeader& header, PackedBits& information,
+                        PackedBits& representation, uint64_t& encodingPosition) {
+    // read the header, rejecting anything that is not a compressed file
+    uint64_t position{0};
+    if (!readHeader(input, position, header)) {
+        return false;
+    }
+
+    // reject lengths the file cannot hold before allocating memory for them
+    uint64_t remainingBytes{input.size() > position ? input.size() - position : 0};
+    uint64_t sectionBytes{(header.infoLength + 7) / 8 + (header.treeLength + 7) / 8 + (header.encodingLength + 7) / 8};
+    if (header.hasFlag(HuffmanHeader::CHECKSUM) && !header.hasFlag(HuffmanHeader::STREAMED)) {
+        sectionBytes += 4;
+    }
+    if (sectionBytes > remainingBytes) {
+        std::cout << "Error: Compressed file is truncated or corrupted.\n";
+        return false;
+    }
+
     // read each section in the file and instantiate appropriate data members
-    input.read(reinterpret_cast<char*>(&header), sizeof(HuffmanHeader)); // always 12 bytes
-    readSection(input, information, header.infoLength); // always in byte chunks
-    readSection(input, representation, header.treeLength); // may have padding at the end
-    readSection(input, encoding, header.encodingLength); // may have padding at the end
+    readSection(input, position, information, header.infoLength); // always in byte chunks
+    readSection(input, position, representation, header.treeLength); // may have padding at the end
+
+    // the Huffman Code is left in place to be viewed directly when decoding
+    encodingPosition = position;
+    return true;
 }
 
-void writeDecompressedFile(const std::string& destination, HuffmanNode* root, const std::string& encodingString) {
+bool readDictionaryFile(InputSource& input, Dictionary& dictionary, unsigned decodingTableBits) {
+    // reject files which cannot hold the magic bytes, version and ID, or a longer table than can be written
+    constexpr uint64_t prefixBytes{sizeof(Dictionary::MAGIC) + 1 + 4};
+    if (input.size() < prefixBytes || input.size() > prefixBytes + MAX_CODE_LENGTH_TABLE_BITS / 8) {
+        std::cout << "Error: File is not a dictionary file.\n";
+        return false;
+    }
+
+    uint64_t position{0};
+    PackedBits contents{};
+    readSection(input, position, contents, input.size() * 8);
+    BitReader reader{contents};
+    bool isMagic{true};
+    for (uint8_t byte : Dictionary::MAGIC) {
+        isMagic = reader.readByte() == byte && isMagic;
+    }
+    if (!isMagic) {
+        std::cout << "Error: File is not a dictionary file.\n";
+        return false;
+    }
+    uint8_t version{reader.readByte()};
+    if (version < 1 || version > Dictionary::CURRENT_VERSION) {
+        std::cout << "Error: Unsupported dictionary version " << static_cast<int>(version) << ".\n";
+        return false;
+    }
+
+    // the codes must be those the ID was computed from
+    uint32_t id{readUInt32(reader)};
+    EncodingTable table{};
+    if (!instantiateCanonicalEncodingTable(table, reader) || Dictionary::computeId(table) != id) {
+        std::cout << "Error: Dictionary file is corrupted.\n";
+        return false;
+    }
+
+    dictionary.setTable(table, decodingTableBits);
+    return true;
+}
+
+bool writeDecompressedFile(const std::string& destination, const SectionDecoder& decoder,
+                           const BitSpan& encoding, uint32_t& checksum) {
     std::ofstream output(destination, std::ios::out | std::ios::binary); // write in binary mode
     if (!output) {
         std::cout << "Write Decompressed File Error\n";
-        return;
+        return false;
+    }
+
+    std::vector<uint8_t> buffer(DECODE_BUFFER_SIZE);
+    checksum = 0;
+    if (!decoder(output, encoding, buffer, checksum)) {
+        std::cout << "Corrupted Huffman Code Error\n";
+        return false;
     }
 
-    // traverse through Huffman Encoding and where a leaf node is reached, insert character
-    HuffmanNode* currentPtr{root};
-    for (char bit : encodingString) {
-        if (bit == '0') {
-            currentPtr = currentPtr->left;
-        } else if (bit == '1') {
-            currentPtr = currentPtr->right;
+    output.close();
+    return static_cast<bool>(output);
+}
+
+bool writeStreamedDecompressedFile(const std::string& destination, const SectionDecoder& decoder,
+                                   InputSource& input, uint64_t& position, uint32_t& checksum) {
+    std::ofstream output(destination, std::ios::out | std::ios::binary); // write in binary mode
+    if (!output) {
+        std::cout << "Write Decompressed File Error\n";
+        return false;
+    }
+
+    // view and decode one block at a time until the terminating block, releasing each block once decoded
+    std::vector<uint8_t> buffer(DECODE_BUFFER_SIZE);
+    std::vector<uint8_t> blockBuffer{};
+    const uint8_t* data{nullptr};
+    checksum = 0;
+    while (true) {
+        uint64_t bitLength{0};
+        if (!readVarint(input, position, bitLength)) {
+            std::cout << "Truncated Huffman Code Error\n";
+            return false;
+        }
+        if (bitLength == 0) {
+            break;
         }
 
-        // when a leaf node is reached, write to file and reset to root
-        if (!currentPtr->left && !currentPtr->right) {
-            output.put(currentPtr->key.value());
-            currentPtr = root;
+        auto byteLength{static_cast<std::size_t>((bitLength + 7) / 8)};
+        if (input.view(position, byteLength, data, blockBuffer) < byteLength) {
+            std::cout << "Truncated Huffman Code Error\n";
+            return false;
         }
+        if (!decoder(output, BitSpan{data, byteLength, bitLength}, buffer, checksum)) {
+            std::cout << "Corrupted Huffman Code Error\n";
+            return false;
+        }
+
+        input.release(position, byteLength);
+        position += byteLength;
     }
 
     output.close();
+    return static_cast<bool>(output);
+}
+
+namespace {
+    // the decoder of every overload of decodeSection has the same decode function
+    template <typename Decoder>
+    bool decodeSectionWith(std::ostream& output, Decoder& decoder, const BitSpan& encoding,
+                           std::vector<uint8_t>& buffer, uint32_t& checksum) {
+        // decode the Huffman Code one buffer of characters at a time, writing each full buffer in a single call, and
+        // update the checksum with each buffer while it is still in the cache
+        BitReader reader{encoding};
+        bool corrupted{false};
+        while (reader.position() < encoding.bitLength && !corrupted) {
+            std::size_t count{decoder.decode(reader, encoding.bitLength, buffer.data(), buffer.size(), corrupted)};
+            checksum = updateCrc32c(checksum, buffer.data(), count);
+            output.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(count));
+        }
+
+        return !corrupted;
+    }
+}
+
+bool decodeSection(std::ostream& output, const DecodingTable& decodingTable, const BitSpan& encoding,
+                   std::vector<uint8_t>& buffer, uint32_t& checksum) {
+    return decodeSectionWith(output, decodingTable, encoding, buffer, checksum);
+}
+
+bool decodeSection(std::ostream& output, AdaptiveHuffman& adaptiveHuffman, const BitSpan& encoding,
+                   std::vector<uint8_t>& buffer, uint32_t& checksum) {
+    // the tree carries on from the previous section
+    return decodeSectionWith(output, adaptiveHuffman, encoding, buffer, checksum);
+}
+
+bool decodeSection(std::ostream& output, ContextModel& contextModel, const BitSpan& encoding,
+                   std::vector<uint8_t>& buffer, uint32_t& checksum) {
+    // the previous character carries on from the previous section
+    return decodeSectionWith(output, contextModel, encoding, buffer, checksum);
+}
+
+bool decodeSection(std::ostream& output, BlockSplitter& blockSplitter, const BitSpan& encoding,
+                   std::vector<uint8_t>& buffer, uint32_t& checksum) {
+    // the current block carries on from the previous section
+    return decodeSectionWith(output, blockSplitter, encoding, buffer, checksum);
+}
+
+bool decodeSection(std::ostream& output, InterleavedStreams& interleavedStreams, const BitSpan& encoding,
+                   std::vector<uint8_t>& buffer, uint32_t& checksum) {
+    // the block of the streams carries on from the previous buffer
+    return decodeSectionWith(output, interleavedStreams, encoding, buffer, checksum);
+}
+
+namespace {
+    // the decoder of every overload of decodeRange has the same decode function
+    template <typename Decoder>
+    bool decodeRangeWith(Decoder& decoder, const BitSpan& encoding, uint64_t bitOffset, DecodedRange& range,
+                         std::vector<uint8_t>& buffer) {
+        // start reading at the byte holding the first bit, then skip to its bit
+        auto firstByte{static_cast<std::size_t>(bitOffset / 8)};
+        if (bitOffset > encoding.bitLength || firstByte > encoding.byteLength) {
+            return false;
+        }
+        BitReader reader{encoding.bytes + firstByte, encoding.byteLength - firstByte,
+                         encoding.bitLength - firstByte * 8};
+        reader.skipBits(static_cast<unsigned>(bitOffset % 8));
+        uint64_t bitLength{encoding.bitLength - firstByte * 8};
+
+        // the characters before the range are decoded into the buffer and dropped, and those of the range are decoded
+        // straight into the output
+        bool corrupted{false};
+        while (!range.done() && reader.position() < bitLength && !corrupted) {
+            std::size_t count{0};
+            if (range.skip > 0) {
+                auto capacity{static_cast<std::size_t>(std::min<uint64_t>(buffer.size(), range.skip))};
+                count = decoder.decode(reader, bitLength, buffer.data(), capacity, corrupted);
+                range.skip -= count;
+            } else {
+                auto capacity{static_cast<std::size_t>(std::min<uint64_t>(SIZE_MAX, range.remaining))};
+                count = decoder.decode(reader, bitLength, range.output, capacity, corrupted);
+                range.output += count;
+                range.remaining -= count;
+            }
+            if (count == 0) {
+                corrupted = true;
+            }
+        }
+
+        return !corrupted;
+    }
+}
+
+bool decodeRange(const DecodingTable& decodingTable, const BitSpan& encoding, uint64_t bitOffset, DecodedRange& range,
+                 std::vector<uint8_t>& buffer) {
+    return decodeRangeWith(decodingTable, encoding, bitOffset, range, buffer);
+}
+
+bool decodeRange(AdaptiveHuffman& adaptiveHuffman, const BitSpan& encoding, uint64_t bitOffset, DecodedRange& range,
+                 std::vector<uint8_t>& buffer) {
+    // the tree carries on from the previous section
+    return decodeRangeWith(adaptiveHuffman, encoding, bitOffset, range, buffer);
+}
+
+bool decodeRange(ContextModel& contextModel, const BitSpan& encoding, uint64_t bitOffset, DecodedRange& range,
+                 std::vector<uint8_t>& buffer) {
+    // the previous character carries on from the previous section, or is that of the sync point (see seek)
+    return decodeRangeWith(contextModel, encoding, bitOffset, range, buffer);
+}
+
+bool decodeRange(BlockSplitter& blockSplitter, const BitSpan& encoding, uint64_t bitOffset, DecodedRange& range,
+                 std::vector<uint8_t>& buffer) {
+    // the current block carries on from the previous section, or is that of the sync point (see seek)
+    return decodeRangeWith(blockSplitter, encoding, bitOffset, range, buffer);
+}
+
+bool decodeRange(InterleavedStreams& interleavedStreams, const BitSpan& encoding, uint64_t bitOffset,
+                 DecodedRange& range, std::vector<uint8_t>& buffer) {
+    // every sync point is the start of a block of the streams
+    return decodeRangeWith(interleavedStreams, encoding, bitOffset, range, buffer);
+}
+
+bool decodeStreamedRange(const RangeDecoder& decoder, InputSource& input, uint64_t& position,
+                         DecodedRange& range) {
+    // view and decode one block at a time until the range is filled, releasing each block once decoded
+    std::vector<uint8_t> buffer(DECODE_BUFFER_SIZE);
+    std::vector<uint8_t> blockBuffer{};
+    const uint8_t* data{nullptr};
+    while (!range.done()) {
+        uint64_t bitLength{0};
+        if (!readVarint(input, position, bitLength)) {
+            return false;
+        }
+        if (bitLength == 0) {
+            return true; // the file ended before the range did
+        }
+
+        auto byteLength{static_cast<std::size_t>((bitLength + 7) / 8)};
+        if (input.view(position, byteLength, data, blockBuffer) < byteLength ||
+            !decoder(BitSpan{data, byteLength, bitLength}, 0, range, buffer)) {
+            return false;
+        }
+
+        input.release(position, byteLength);
+        position += byteLength;
+    }
+
+    return true;
 }
@@ -2,38 +2,162 @@
 
 // This module encapsulates a number of functions used by the HuffmanTree compress and decompress functions. Both
 // writeCompressedFile and readCompressedFile functions consolidate a number of writeSection and readSection calls,
-// respectively. writeDecompressedFile is used to write the original file by traversing the Huffman Tree.
+// respectively. writeDecompressedFile is used to write the original file by decoding the Huffman Code. The compressed
+// file is written to an output stream opened by the caller (see HuffmanTree::write), which checks it afterwards.
 
-// When writing each section using writeSection, bits from the std::string representation are accumulated in byte
-// chunks. Each byte is manually constructed using the left shift (<<) and bitwise OR (|) operators. Padding of 0s is
-// accounted for in the Tree Representation and Huffman Code sections.
+// Every section is held in memory as PackedBits, already in the byte layout used in the file, so writeSection writes
+// it with a single bulk write. The Header is also written through a BitWriter, always as the current version (see
+// HuffmanHeader), with its values written as varints using writeVarint.
 
-// Reading each section using readSection works in a similar manner, accounting for the possible padded bits using
-// the size from the Huffman Header as an additional condition when reconstructing the data members.
+// Every read goes through an InputSource with an explicit position, which is moved past whatever was read. Reading
+// each section using readSection works in a similar manner to writing: the whole section, including any padded bits,
+// is copied with a single view, and the size from the Huffman Header is used as the true bit length of the section.
+// readHeader recognizes both header versions and rejects files which are not compressed files or are of a newer
+// version. readCompressedFile also rejects a header whose lengths do not fit in the rest of the file, before any
+// memory is allocated for the sections. Both return false (after printing an error) when the file is rejected.
 
-// The writeDecompressedFile iterates over the Huffman Code and uses the Huffman Tree in order to write the original
-// file. For every leaf node reached based on the traversal, a character is written to file.
+// readCompressedFile does not copy the Huffman Code, but returns its position so that it can be viewed in place (see
+// HuffmanTree::decompress). The writeDecompressedFile iterates over the Huffman Code with a BitReader and uses a
+// DecodingTable built from the Huffman Tree in order to write the original file. Each table lookup resolves a whole
+// character, which is collected in a buffer that is written to file once it is full.
+
+// The streamed variants are used for files compressed in streaming mode. writeStreamedCompressedFile encodes the
+// original file one block at a time, writing each block prefixed by its bit count as soon as it is encoded, followed
+// by a terminating block length of 0. writeStreamedDecompressedFile then views and decodes the blocks that follow the
+// first sections one at a time. Both release each block of the input once it is done with.
+
+// The Huffman Code is encoded and decoded through a BlockEncoder and a SectionDecoder given by the HuffmanTree, which
+// use either the encoding table and a DecodingTable, an AdaptiveHuffman tree updated as it goes (see CodingEngine), or
+// the tables of a ContextModel or a BlockSplitter, or InterleavedStreams. decodeSection decodes a section with any of
+// them.
+
+// Both sides also carry the checksum of the original file (see checksum_utils), which writeChecksum writes after the
+// Huffman Code and readChecksum reads back. writeStreamedCompressedFile updates it with each block before encoding
+// the block, and decodeSection with each buffer of characters before writing the buffer, so that neither reads the
+// original or decompressed file a second time.
+
+// writeBlockIndex writes the optional BlockIndex after the Huffman Code, and readBlockIndex looks for it at the end of
+// the file.
+
+// decodeRange decodes only part of a section, starting at any bit offset (such as a sync point of the BlockIndex) with
+// any of the same decoders, and stops as soon as the DecodedRange is filled, dropping the characters before it.
+// decodeStreamedRange does the same over the blocks of a streamed file, which have no sync points, reading no further
+// than the block which holds the end of the range. Neither updates a checksum, as only the whole file has one.
+
+// writeDictionaryFile and readDictionaryFile write and read a Dictionary file (see Dictionary for its layout), which
+// readDictionaryFile rejects (after printing an error) when it is not a dictionary file, is of a newer version, or its
+// code length table does not match its ID.
+
+// writeArchiveHeader and writeArchiveIndex write the header and central index of an archive (see ArchiveIndex), and
+// readArchiveIndex reads the index back, rejecting (after printing an error) a file which is not an archive, is of a
+// newer version, or has an entry which does not lie within the archive.
+
+// writePipedBlock and readPipedBlock write and read one block of a piped stream (see HuffmanHeader), which has its own
+// code length table. The writing functions take any output stream, so that a piped stream can be written to stdout.
+// readPipedBlock rejects lengths no block written by this program can have, before any memory is allocated for them.
 
 #ifndef COMPRESSION_UTILS_H
 #define COMPRESSION_UTILS_H
 
 
+#include <cstddef>
 #include <cstdint>
 #include <fstream>
+#include <functional>
+#include <ostream>
+#include <vector>
 
-#include "huffman_tree/HuffmanNode.h"
+#include "archive/ArchiveIndex.h"
+#include "huffman_tree/adaptive/AdaptiveHuffman.h"
+#include "huffman_tree/bit_stream/BitReader.h"
+#include "huffman_tree/bit_stream/BitWriter.h"
+#include "huffman_tree/bit_stream/PackedBits.h"
+#include "huffman_tree/block_splitter/BlockSplitter.h"
+#include "huffman_tree/components/BlockIndex.h"
+#include "huffman_tree/components/DecodedRange.h"
 #include "huffman_tree/components/HuffmanHeader.h"
+#include "huffman_tree/context_model/ContextModel.h"
+#include "huffman_tree/dictionary/Dictionary.h"
+#include "huffman_tree/decoding_table/DecodingTable.h"
+#include "huffman_tree/interleaved/InterleavedStreams.h"
+#include "input_source/InputSource.h"
+#include "utils/generate/generate_utils.h"
+
+constexpr std::size_t DECODE_BUFFER_SIZE{1 << 16}; // characters decoded before each write
+constexpr std::size_t MAX_PIPED_BLOCK_SIZE{1 << 26}; // bytes of the original stream in one piped block
+constexpr uint64_t MAX_CODE_LENGTH_TABLE_BITS{1 << 12};
+constexpr uint64_t MAX_CHARACTER_BITS{256 + 8}; // the longest adaptive code, that of the NYT leaf and a new character
+
+using BlockEncoder = std::function<void(const uint8_t* data, std::size_t size, BitWriter& writer)>;
+using SectionDecoder = std::function<bool(std::ostream& output, const BitSpan& encoding, std::vector<uint8_t>& buffer,
+                                          uint32_t& checksum)>;
+using RangeDecoder = std::function<bool(const BitSpan& encoding, uint64_t bitOffset, DecodedRange& range,
+                                        std::vector<uint8_t>& buffer)>;
 
 // compress helper functions
-void writeSection(std::ofstream& output, const std::string& section);
-void writeCompressedFile(const std::string& destination, const HuffmanHeader& header, const std::string& information,
-                         const std::string& representation, const std::string& encoding);
+void writeSection(std::ostream& output, const PackedBits& section);
+void writeHeader(std::ostream& output, const HuffmanHeader& header);
+void writeVarint(BitWriter& writer, uint64_t value);
+void writeUInt32(BitWriter& writer, uint32_t value);
+void writeUInt64(BitWriter& writer, uint64_t value);
+void writeChecksum(std::ostream& output, uint32_t checksum);
+void writeBlockIndex(std::ostream& output, const BlockIndex& blockIndex);
+void writeCompressedFile(std::ostream& output, const HuffmanHeader& header, const PackedBits& information,
+                         const PackedBits& representation, const PackedBits& encoding, uint32_t checksum,
+                         const BlockIndex& blockIndex);
+void writeStreamedCompressedFile(std::ostream& output, const HuffmanHeader& header, const PackedBits& information,
+                                 const PackedBits& representation, InputSource& input,
+                                 const BlockEncoder& encodeBlock, std::size_t blockSize);
+void writeBlockLength(std::ostream& output, uint64_t bitLength);
+void writePipedBlock(std::ostream& output, uint64_t originalSize, const PackedBits& lengthTable,
+                     const PackedBits& encoding);
+bool writeDictionaryFile(const std::string& destination, const Dictionary& dictionary); // false if it failed
+void writeArchiveHeader(std::ostream& output);
+void writeArchiveIndex(std::ostream& output, const ArchiveIndex& archiveIndex, uint64_t indexOffset);
 
 // decompress helper functions
-void readSection(std::ifstream& input, std::string& section, uint32_t size);
-void readCompressedFile(std::ifstream& input, HuffmanHeader& header, std::string& information,
-                        std::string& representation, std::string& encoding);
-void writeDecompressedFile(const std::string& destination, HuffmanNode* root, const std::string& encodingString);
-
+void readSection(InputSource& input, uint64_t& position, PackedBits& section, uint64_t size);
+bool readHeader(InputSource& input, uint64_t& position, HuffmanHeader& header);
+bool readVarint(InputSource& input, uint64_t& position, uint64_t& value);
+bool readVarint(BitReader& reader, uint64_t& value);
+uint32_t readUInt32(BitReader& reader);
+uint64_t readUInt64(BitReader& reader);
+bool readChecksum(InputSource& input, uint64_t& position, uint32_t& checksum); // returns false if the file ended
+// returns false if the file has no block index, whose entries hold their previous character if previousCharacters
+bool readBlockIndex(InputSource& input, BlockIndex& blockIndex, bool previousCharacters = false);
+bool readArchiveIndex(InputSource& input, ArchiveIndex& archiveIndex);
+bool readPipedBlock(InputSource& input, uint64_t& position, uint64_t& originalSize, PackedBits& lengthTable,
+                    uint64_t& encodingLength); // returns false if the stream is truncated or corrupted
+bool readCompressedFile(InputSource& input, HuffmanHeader& header, PackedBits& information,
+                        PackedBits& representation, uint64_t& encodingPosition);
+bool readDictionaryFile(InputSource& input, Dictionary& dictionary, unsigned decodingTableBits);
+// each returns false (after printing an error) if the file could not be written or the Huffman Code is corrupted
+bool writeDecompressedFile(const std::string& destination, const SectionDecoder& decoder,
+                           const BitSpan& encoding, uint32_t& checksum);
+bool writeStreamedDecompressedFile(const std::string& destination, const SectionDecoder& decoder,
+                                   InputSource& input, uint64_t& position, uint32_t& checksum);
+// each returns false if the Huffman Code is corrupted
+bool decodeSection(std::ostream& output, const DecodingTable& decodingTable, const BitSpan& encoding,
+                   std::vector<uint8_t>& buffer, uint32_t& checksum);
+bool decodeSection(std::ostream& output, AdaptiveHuffman& adaptiveHuffman, const BitSpan& encoding,
+                   std::vector<uint8_t>& buffer, uint32_t& checksum);
+bool decodeSection(std::ostream& output, ContextModel& contextModel, const BitSpan& encoding,
+                   std::vector<uint8_t>& buffer, uint32_t& checksum);
+bool decodeSection(std::ostream& output, BlockSplitter& blockSplitter, const BitSpan& encoding,
+                   std::vector<uint8_t>& buffer, uint32_t& checksum);
+bool decodeSection(std::ostream& output, InterleavedStreams& interleavedStreams, const BitSpan& encoding,
+                   std::vector<uint8_t>& buffer, uint32_t& checksum);
+bool decodeRange(const DecodingTable& decodingTable, const BitSpan& encoding, uint64_t bitOffset, DecodedRange& range,
+                 std::vector<uint8_t>& buffer);
+bool decodeRange(AdaptiveHuffman& adaptiveHuffman, const BitSpan& encoding, uint64_t bitOffset, DecodedRange& range,
+                 std::vector<uint8_t>& buffer);
+bool decodeRange(ContextModel& contextModel, const BitSpan& encoding, uint64_t bitOffset, DecodedRange& range,
+                 std::vector<uint8_t>& buffer);
+bool decodeRange(BlockSplitter& blockSplitter, const BitSpan& encoding, uint64_t bitOffset, DecodedRange& range,
+                 std::vector<uint8_t>& buffer);
+bool decodeRange(InterleavedStreams& interleavedStreams, const BitSpan& encoding, uint64_t bitOffset,
+                 DecodedRange& range, std::vector<uint8_t>& buffer);
+bool decodeStreamedRange(const RangeDecoder& decoder, InputSource& input, uint64_t& position,
+                         DecodedRange& range); // also false if the file is truncated
 
 #endif // COMPRESSION_UTILS_H
@@ -23,16 +23,31 @@
     }
 
     std::size_t getFileSize(const std::string& path) {
-        return std::filesystem::file_size(path);
+        std::error_code error{}; // 0 for a missing file, as with POSIX
+        std::uintmax_t size{std::filesystem::file_size(path, error)};
+        return error ? 0 : size;
     }
 
     std::string getDirectory(const std::string& path) {
-        std::filesystem::path filePath{path};
+        // made absolute first, as a bare file name has an empty parent path
+        std::filesystem::path filePath{std::filesystem::absolute(path)};
         return std::filesystem::canonical(filePath.parent_path()).string();
     }
 
+    bool renameFile(const std::string& from, const std::string& to) {
+        std::error_code error{};
+        std::filesystem::rename(from, to, error);
+        return !error;
+    }
+
+    void removeFile(const std::string& path) {
+        std::error_code error{}; // a missing file is not an error
+        std::filesystem::remove(path, error);
+    }
+
 #else // functions using POSIX
 
+#include <cstdio>
 #include <sys/stat.h>
 
 #ifdef _WIN32
@@ -77,4 +92,14 @@ std::string getDirectory(const std::string& path) {
     return (std::string::npos == pos) ? "" : fullPath.substr(0, pos);
 }
 
+bool renameFile(const std::string& from, const std::string& to) {
+    // std::rename does not replace an existing file on Windows
+    std::remove(to.c_str());
+    return std::rename(from.c_str(), to.c_str()) == 0;
+}
+
+void removeFile(const std::string& path) {
+    std::remove(path.c_str());
+}
+
 #endif
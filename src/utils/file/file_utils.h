@@ -11,16 +11,22 @@
 
 // These utilities can process both relative and absolute file paths.
 
+// renameFile replaces any file already at the new path, and removeFile does nothing if the file is missing, so that a
+// file can be written under a temporary name and then either put in place or thrown away.
+
 #ifndef FILE_UTILS_H
 #define FILE_UTILS_H
 
 
+#include <cstddef>
 #include <string>
 
 std::string getFileName(const std::string& path);
 std::string getFileExtension(const std::string& path);
 std::size_t getFileSize(const std::string& path);
 std::string getDirectory(const std::string& path);
+bool renameFile(const std::string& from, const std::string& to); // returns false if the file could not be renamed
+void removeFile(const std::string& path);
 
 
 #endif // FILE_UTILS_H
@@ -2,28 +2,39 @@
 
 #include "generate_utils.h"
 
+#include <algorithm>
+#include <array>
 #include <iostream>
+#include <vector>
+
+#include "huffman_tree/package_merge/PackageMerge.h"
+#include "utils/checksum/checksum_utils.h"
+#include "utils/compression/compression_utils.h"
 
 // generate encoding table
 
-void generateEncodingTable(EncodingTable& encodingTable, const HuffmanNode* root) {
-    encodingTable.clear();
-    generateEncodingTableHelper(encodingTable, root, "");
+void generateEncodingTable(EncodingTable& encodingTable, const HuffmanNodeArena& nodes, uint16_t root) {
+    encodingTable.fill(HuffmanCodeword{});
+    generateEncodingTableHelper(encodingTable, nodes, root, 0, 0);
 }
 
-void generateEncodingTableHelper(EncodingTable& encodingTable, const HuffmanNode* root, const std::string& code) {
-    // base case: past leaf node nullptr
-    if (root == nullptr) {
+void generateEncodingTableHelper(EncodingTable& encodingTable, const HuffmanNodeArena& nodes, uint16_t root,
+                                 uint64_t bits, uint8_t length) {
+    // base case: past leaf node
+    if (root == NO_NODE) {
         return;
     }
 
     // add encoding for only leaf nodes
-    if (root->left == nullptr && root->right == nullptr) {
+    const HuffmanNode& node{nodes[root]};
+    if (node.left == NO_NODE && node.right == NO_NODE) {
+        HuffmanCodeword& codeword{encodingTable[static_cast<unsigned char>(node.key.value_or(0))]};
+
         // special case: tree with only one node
-        if (code.empty()) {
-            encodingTable[root->key] = "0";
+        if (length == 0) {
+            codeword = HuffmanCodeword{0, 1};
         } else {
-            encodingTable[root->key] = code;
+            codeword = HuffmanCodeword{bits, length};
         }
 
         return; // short-circuit on successful addition
@@ -31,95 +42,397 @@ void generateEncodingTableHelper(EncodingTable& encodingTable, const HuffmanNode
 
     // for non-leaf nodes, recursively continue
     // here is where the Huffman Coding algorithm comes into play with 0 going left and 1 going right
-    generateEncodingTableHelper(encodingTable, root->left, code + "0");
-    generateEncodingTableHelper(encodingTable, root->right, code + "1");
+    generateEncodingTableHelper(encodingTable, nodes, node.left, bits << 1, static_cast<uint8_t>(length + 1));
+    generateEncodingTableHelper(encodingTable, nodes, node.right, (bits << 1) | 1, static_cast<uint8_t>(length + 1));
+}
+
+// generate canonical codes
+
+void generateCanonicalEncodingTable(EncodingTable& encodingTable) {
+    // count the characters of each code length
+    std::array<uint64_t, 256> lengthCounts{};
+    for (const HuffmanCodeword& codeword : encodingTable) {
+        ++lengthCounts[codeword.length];
+    }
+    lengthCounts[0] = 0; // characters which do not occur have no code
+
+    // the first code of each length is one past the last code of the previous length, with a 0 appended
+    std::array<uint64_t, 256> nextCodes{};
+    uint64_t code{0};
+    for (std::size_t length{1}; length < nextCodes.size(); ++length) {
+        code = (code + lengthCounts[length - 1]) << 1;
+        nextCodes[length] = code;
+    }
+
+    // assign consecutive codes to the characters of each length in the order of the character values
+    for (HuffmanCodeword& codeword : encodingTable) {
+        if (codeword.length != 0) {
+            codeword.bits = nextCodes[codeword.length]++;
+        }
+    }
+}
+
+uint64_t generateLimitedEncodingTable(EncodingTable& encodingTable, const ByteHistogram& histogram,
+                                      TreeBuilderEngine engine, unsigned maxCodeLength) {
+    HuffmanNodeArena nodes{};
+    generateEncodingTable(encodingTable, nodes, TreeBuilder::build(engine, histogram, nodes));
+
+    // replace the code lengths if any code is longer than the maximum
+    uint8_t longestLength{0};
+    for (const HuffmanCodeword& codeword : encodingTable) {
+        longestLength = std::max(longestLength, codeword.length);
+    }
+    if (maxCodeLength != 0 && longestLength > maxCodeLength) {
+        PackageMerge packageMerge{histogram, maxCodeLength};
+        for (std::size_t character{0}; character < encodingTable.size(); ++character) {
+            encodingTable[character].length = packageMerge.getCodeLengths()[character];
+        }
+    }
+    generateCanonicalEncodingTable(encodingTable);
+
+    uint64_t encodedBits{0};
+    for (std::size_t character{0}; character < encodingTable.size(); ++character) {
+        encodedBits += histogram.frequencies[character] * encodingTable[character].length;
+    }
+    return encodedBits;
+}
+
+void generateCodeLengthTable(PackedBits& lengthTable, const EncodingTable& encodingTable) {
+    lengthTable.clear();
+    BitWriter writer{lengthTable};
+    generateCodeLengthTable(writer, encodingTable);
+    writer.flush();
+}
+
+void generateCodeLengthTable(BitWriter& writer, const EncodingTable& encodingTable) {
+    // count the characters, the groups of 8 characters and the width of the longest length
+    uint64_t characterCount{0};
+    uint64_t groupCount{0};
+    unsigned lengthWidth{1};
+    for (std::size_t group{0}; group < 32; ++group) {
+        bool groupOccurs{false};
+        for (std::size_t i{0}; i < 8; ++i) {
+            uint8_t length{encodingTable[group * 8 + i].length};
+            if (length != 0) {
+                groupOccurs = true;
+                ++characterCount;
+                while ((length >> lengthWidth) != 0) {
+                    ++lengthWidth;
+                }
+            }
+        }
+        groupCount += groupOccurs ? 1 : 0;
+    }
+
+    // 9 bits for every leaf and 1 bit for every internal node, against the fixed part of the list and a length each
+    uint64_t treeLayoutBits{characterCount == 0 ? 0 : characterCount * 10 - 1};
+    uint64_t listLayoutBits{35 + groupCount * 8 + characterCount * lengthWidth};
+    if (treeLayoutBits <= listLayoutBits) {
+        writer.writeBit(false);
+        generateCanonicalTreeLayout(writer, encodingTable);
+    } else {
+        writer.writeBit(true);
+        generateLengthListLayout(writer, encodingTable);
+    }
+}
+
+void generateContextTables(PackedBits& representation, const ContextModel& contextModel) {
+    representation.clear();
+    BitWriter writer{representation};
+
+    // the number of tables, then the table of every context, then the code length table of every table
+    unsigned tableCount{contextModel.getTableCount()};
+    unsigned indexBits{ContextModel::indexBits(tableCount)};
+    writer.writeBits(tableCount - 1, ContextModel::TABLE_COUNT_BITS);
+    for (uint8_t table : contextModel.getClusters()) {
+        writer.writeBits(table, indexBits);
+    }
+    for (const EncodingTable& encodingTable : contextModel.getEncodingTables()) {
+        generateCodeLengthTable(writer, encodingTable);
+    }
+
+    writer.flush();
+}
+
+void generateBlockTables(PackedBits& representation, const BlockSplitter& blockSplitter) {
+    representation.clear();
+    BitWriter writer{representation};
+
+    // the number of blocks, then the size of every block followed by whether it reuses the table of the block before
+    // it, or else its own code length table
+    const std::vector<SplitBlock>& blocks{blockSplitter.getBlocks()};
+    writeVarint(writer, blocks.size());
+    for (std::size_t i{0}; i < blocks.size(); ++i) {
+        writeVarint(writer, blocks[i].size);
+        if (i != 0) {
+            bool reused{blocks[i].table == blocks[i - 1].table};
+            writer.writeBit(reused);
+            if (reused) {
+                continue;
+            }
+        }
+        generateCodeLengthTable(writer, blockSplitter.getEncodingTables()[blocks[i].table]);
+    }
+
+    writer.flush();
+}
+
+void generateDictionaryId(PackedBits& representation, const Dictionary& dictionary) {
+    representation.clear();
+    BitWriter writer{representation};
+    writeUInt32(writer, dictionary.getId());
+    writer.flush();
+}
+
+void generateCanonicalTreeLayout(BitWriter& writer, const EncodingTable& encodingTable) {
+    // order the characters by their codes, which is the order of their leaves in a preorder traversal
+    std::vector<uint8_t> characters{};
+    for (std::size_t character{0}; character < encodingTable.size(); ++character) {
+        if (encodingTable[character].length != 0) {
+            characters.push_back(static_cast<uint8_t>(character));
+        }
+    }
+    std::stable_sort(characters.begin(), characters.end(), [&encodingTable](uint8_t a, uint8_t b) {
+        return encodingTable[a].length < encodingTable[b].length;
+    });
+
+    // special case: tree with only one node, which is a leaf
+    if (characters.size() == 1) {
+        writer.writeBits(characters[0], 9);
+        return;
+    }
+
+    unsigned previousLength{0};
+    uint64_t previousCode{0};
+    for (uint8_t character : characters) {
+        const HuffmanCodeword& codeword{encodingTable[character]};
+
+        // the codes diverge at the first bit where they differ, where the previous code turned left and this one
+        // turns right, so the internal nodes of this code start one below that point
+        unsigned internalNodes{codeword.length};
+        if (previousLength != 0) {
+            unsigned divergence{0};
+            while (((previousCode >> (previousLength - 1 - divergence)) & 1) ==
+                   ((codeword.bits >> (codeword.length - 1 - divergence)) & 1)) {
+                ++divergence;
+            }
+            internalNodes = codeword.length - divergence - 1;
+        }
+
+        for (unsigned i{0}; i < internalNodes; ++i) {
+            writer.writeBit(true);
+        }
+        writer.writeBits(character, 9);
+
+        previousLength = codeword.length;
+        previousCode = codeword.bits;
+    }
+}
+
+void generateLengthListLayout(BitWriter& writer, const EncodingTable& encodingTable) {
+    // the lengths are all written with the width of the longest one
+    unsigned lengthWidth{1};
+    uint32_t groupBitmap{0};
+    for (std::size_t character{0}; character < encodingTable.size(); ++character) {
+        uint8_t length{encodingTable[character].length};
+        if (length != 0) {
+            groupBitmap |= uint32_t{1} << (31 - character / 8);
+            while ((length >> lengthWidth) != 0) {
+                ++lengthWidth;
+            }
+        }
+    }
+    writer.writeBits(lengthWidth - 1, 3);
+    writer.writeBits(groupBitmap, 32);
+
+    // the character mask of each group which has at least one character
+    for (std::size_t group{0}; group < 32; ++group) {
+        if ((groupBitmap >> (31 - group) & 1) != 0) {
+            uint8_t mask{0};
+            for (std::size_t i{0}; i < 8; ++i) {
+                if (encodingTable[group * 8 + i].length != 0) {
+                    mask |= static_cast<uint8_t>(0x80 >> i);
+                }
+            }
+            writer.writeByte(mask);
+        }
+    }
+
+    // the length of every character which occurs
+    for (const HuffmanCodeword& codeword : encodingTable) {
+        if (codeword.length != 0) {
+            writer.writeBits(codeword.length, lengthWidth);
+        }
+    }
 }
 
 // generate file information code
 
-void generateFileInfoCode(FileInformation& information, std::string& infoEncoding) {
+void generateFileInfoCode(FileInformation& information, PackedBits& infoEncoding) {
     infoEncoding.clear();
+    BitWriter writer{infoEncoding};
 
     // encode file name
     for (char c : information.fileName) {
-        for (int i{7}; i >= 0; --i) {
-            bool result{static_cast<bool>((c >> i) & 1)};
-            infoEncoding += result ? '1' : '0';
-        }
+        writer.writeByte(static_cast<uint8_t>(c));
     }
 
     // encode file extension
     for (char c : information.fileExtension) {
-        for (int i{7}; i >= 0; --i) {
-            bool result{static_cast<bool>((c >> i) & 1)};
-            infoEncoding += result ? '1' : '0';
-        }
+        writer.writeByte(static_cast<uint8_t>(c));
     }
+
+    writer.flush();
 }
 
 // generate tree representation
 
-void generateHuffmanTreeRepresentation(std::string& representation, const HuffmanNode* root) {
+void generateHuffmanTreeRepresentation(PackedBits& representation, const HuffmanNodeArena& nodes, uint16_t root) {
     representation.clear();
-    generateHuffmanTreeRepresentationHelper(representation, root);
+    BitWriter writer{representation};
+    generateHuffmanTreeRepresentationHelper(writer, nodes, root);
+    writer.flush();
 }
 
-void generateHuffmanTreeRepresentationHelper(std::string& representation, const HuffmanNode* root) {
+void generateHuffmanTreeRepresentationHelper(BitWriter& writer, const HuffmanNodeArena& nodes, uint16_t root) {
     // base case
-    if (root == nullptr) return;
+    if (root == NO_NODE) return;
+    const HuffmanNode& node{nodes[root]};
 
     // preorder traversal is used to record the tree representation
 
     // if the key has a value, encode 0 and then the 8-bit representation (9 bits total)
-    if (root->key.has_value()) {
-        representation += '0';
-
-        // get the character value and loop through every bit from left to right.
-        // for example, 'h' has the ASCII representation of '01101000'.
-        // loop down from 7 to 0 inclusive, using the right-shift operator (>>) based on index
-        // and using the bitwise AND operator (&) to evaluate the moved bit.
-
-        // https://www.geeksforgeeks.org/cpp-bitwise-operators/
-
-        char character{root->key.value()};
-        for (int i{7}; i >= 0; --i) {
-            bool result{static_cast<bool>((character >> i) & 1)};
-            representation += result ? '1' : '0';
-        }
+    if (node.key.has_value()) {
+        // for example, 'h' is written as 0 followed by its ASCII representation of '01101000'
+        writer.writeBits(static_cast<unsigned char>(node.key.value()), 9);
     } else {
         // non-leaf node
-        representation += '1';
+        writer.writeBit(true);
     }
 
     // recursively continue
-    generateHuffmanTreeRepresentationHelper(representation, root->left);
-    generateHuffmanTreeRepresentationHelper(representation, root->right);
+    generateHuffmanTreeRepresentationHelper(writer, nodes, node.left);
+    generateHuffmanTreeRepresentationHelper(writer, nodes, node.right);
 }
 
 // generate huffman code
 
-void generateHuffmanCode(std::ifstream& input, const EncodingTable& encodingTable, std::string& encodingString) {
-    // clear string and move file pointer back to beginning
-    encodingString.clear();
-    input.clear(); // check if error state
-    input.seekg(0, std::ios::beg);
+void generateHuffmanCode(InputSource& input, const EncodingTable& encodingTable, PackedBits& encoding,
+                         uint64_t blockIndexSize, BlockIndex& blockIndex, uint32_t& checksum) {
+    // clear encoding, block index and checksum
+    encoding.clear();
+    blockIndex.entries.clear();
+    checksum = 0;
+
+    // view the file a block at a time from its beginning and encode each block
+    BitWriter writer{encoding};
+    std::vector<uint8_t> block{};
+    const uint8_t* data{nullptr};
+    uint64_t position{0};
+    while (std::size_t count{input.view(position, ENCODE_BLOCK_SIZE, data, block)}) {
+        checksum = updateCrc32c(checksum, data, count);
+        generateIndexedHuffmanCodeBlock(data, count, position, encodingTable, writer, 0, blockIndexSize,
+                                        blockIndex.entries);
+        input.release(position, count);
+        position += count;
+    }
+    blockIndex.originalSize = position;
+
+    writer.flush();
+}
+
+void generateIndexedHuffmanCodeBlock(const uint8_t* data, std::size_t count, uint64_t position,
+                                     const EncodingTable& encodingTable, BitWriter& writer, uint64_t bitBase,
+                                     uint64_t blockIndexSize, std::vector<BlockIndexEntry>& entries) {
+    if (blockIndexSize == 0) {
+        generateHuffmanCodeBlock(data, count, encodingTable, writer);
+        return;
+    }
+
+    // encode up to each block boundary, recording a sync point whenever one is reached
+    while (count > 0) {
+        uint64_t offsetInBlock{position % blockIndexSize};
+        if (offsetInBlock == 0) {
+            entries.push_back(BlockIndexEntry{bitBase + writer.bitCount(), position});
+        }
+
+        auto length{static_cast<std::size_t>(std::min<uint64_t>(count, blockIndexSize - offsetInBlock))};
+        generateHuffmanCodeBlock(data, length, encodingTable, writer);
+
+        data += length;
+        count -= length;
+        position += length;
+    }
+}
 
-    char character;
-    while (input.get(character)) {
-        auto encoding{encodingTable.find(character)};
+void generateHuffmanCodeBlock(const uint8_t* data, std::size_t count, const EncodingTable& encodingTable,
+                              BitWriter& writer) {
+    for (std::size_t i{0}; i < count; ++i) {
+        const HuffmanCodeword& codeword{encodingTable[data[i]]};
 
-        if (encoding != encodingTable.end()) {
-            encodingString += encoding->second; // this has the Huffman Code for the single character
+        if (codeword.length != 0) {
+            writer.writeBits(codeword.bits, codeword.length); // this has the Huffman Code for the single character
         } else {
             std::cout << "Character not found in encoding table.\n";
         }
     }
 }
 
+void generateInterleavedHuffmanCode(InputSource& input, const EncodingTable& encodingTable, unsigned streamCount,
+                                    PackedBits& encoding, uint64_t blockIndexSize, BlockIndex& blockIndex,
+                                    uint32_t& checksum) {
+    // clear encoding, block index and checksum
+    encoding.clear();
+    blockIndex.entries.clear();
+    checksum = 0;
+
+    // view the file a block at a time from its beginning and write each block as interleaved streams
+    InterleavedStreams interleavedStreams{encodingTable, streamCount};
+    BitWriter writer{encoding};
+    std::vector<uint8_t> block{};
+    const uint8_t* data{nullptr};
+    uint64_t position{0};
+    while (std::size_t count{input.view(position, InterleavedStreams::BLOCK_SIZE, data, block)}) {
+        checksum = updateCrc32c(checksum, data, count);
+        generateInterleavedHuffmanCodeBlock(data, count, position, interleavedStreams, writer, 0, blockIndexSize,
+                                            blockIndex.entries);
+        input.release(position, count);
+        position += count;
+    }
+    blockIndex.originalSize = position;
+
+    writer.flush();
+}
+
+void generateInterleavedHuffmanCodeBlock(const uint8_t* data, std::size_t count, uint64_t position,
+                                         InterleavedStreams& interleavedStreams, BitWriter& writer, uint64_t bitBase,
+                                         uint64_t blockIndexSize, std::vector<BlockIndexEntry>& entries) {
+    // the same as generateIndexedHuffmanCodeBlock, with each part between sync points written as its own block
+    while (count > 0) {
+        auto length{static_cast<std::size_t>(std::min<uint64_t>(count, InterleavedStreams::BLOCK_SIZE))};
+        if (blockIndexSize != 0) {
+            uint64_t offsetInBlock{position % blockIndexSize};
+            if (offsetInBlock == 0) {
+                entries.push_back(BlockIndexEntry{bitBase + writer.bitCount(), position});
+            }
+            length = static_cast<std::size_t>(std::min<uint64_t>(length, blockIndexSize - offsetInBlock));
+        }
+        interleavedStreams.encode(data, length, writer);
+
+        data += length;
+        count -= length;
+        position += length;
+    }
+}
+
 // generate huffman header
 
-void generateHuffmanHeader(HuffmanHeader& header, std::size_t iLength, std::size_t tLength, std::size_t eLength) {
-    header.infoLength = static_cast<uint32_t>(iLength);
-    header.treeLength = static_cast<uint32_t>(tLength);
-    header.encodingLength = static_cast<uint32_t>(eLength);
+void generateHuffmanHeader(HuffmanHeader& header, uint64_t flags, uint64_t originalSize, uint64_t iLength,
+                           uint64_t tLength, uint64_t eLength) {
+    header.version = HuffmanHeader::CURRENT_VERSION;
+    header.flags = flags;
+    header.originalSize = originalSize;
+    header.infoLength = iLength;
+    header.treeLength = tLength;
+    header.encodingLength = eLength;
 }
@@ -6,52 +6,128 @@
 
 // The generateEncodingTable function traverses the Huffman binary tree and populates the encoding table with the
 // character to Huffman Code mapping. This is done when a leaf node is reached, otherwise traversal to the left adds 0
-// to the code, and traversal to the right adds 1.
+// to the code, and traversal to the right adds 1. The table is an array indexed by the unsigned value of the
+// character, and each code is stored as a packed HuffmanCodeword rather than a string.
 
-// The generateFileInfoCode function encodes the file name and extension inclusive of the period. To create the
-// ASCII byte representation, each character byte is read from the std::string, and looped for each bit using the
-// right shift (>>) and bitwise AND (&) operators.
+// The generateCanonicalEncodingTable function keeps only the code length of every character in the encoding table and
+// reassigns the codes in canonical order: shorter codes come first, codes of the same length are consecutive binary
+// numbers in the order of the character values, and the first code of each length follows on from the last code of
+// the previous length. As the codes can be rebuilt from the lengths alone, only the lengths need to be stored.
+
+// https://en.wikipedia.org/wiki/Canonical_Huffman_code
+
+// The generateLimitedEncodingTable function builds the canonical codes of a histogram without keeping its Huffman Tree,
+// with their lengths limited by PackageMerge as in HuffmanTree::limitCodeLengths, and returns the number of bits the
+// histogram takes with them. It builds every table of a ContextModel and a BlockSplitter.
+
+// The generateFileInfoCode function encodes the file name and extension inclusive of the period. Each character byte
+// is read from the std::string and written as 8 bits with a BitWriter.
 
 // The generateHuffmanTreeRepresentation function encodes the Huffman Tree by using preorder traversal, and noting
 // each node. For every non-leaf node, 1 is recorded; for every leaf node with a value, 0 is recorded and then the
-// 8-bit representation of the character using the right shift and bitwise AND operators.
+// 8-bit representation of the character.
+
+// The generateCodeLengthTable function encodes the code lengths of a canonical encoding table in place of the tree
+// representation, in whichever of two layouts is smaller, as marked by its first bit.
+
+// With a 0, the tree representation of the canonical tree follows (the tree whose codes are the canonical codes), as
+// written by generateHuffmanTreeRepresentation. The depth of each leaf is the code length of its character, so this
+// is cheapest when only a few characters occur. It is generated straight from the codes in canonical order, without a
+// Huffman Tree: between one leaf and the next, a 1 is written for every internal node below the point where their
+// codes diverge.
+
+// With a 1, the width in bits of every length (minus 1, in 3 bits) follows, then a 32-bit bitmap with one bit for each
+// group of 8 consecutive characters, set when any character of the group occurs. Each set group is then followed by an
+// 8-bit mask of which of its characters occur, and last come the lengths of those characters. For example, an English
+// text of 60 different characters takes about 45 bytes, compared to about 75 bytes for the tree representation.
+
+// [0] > [Tree Representation]
+// [1] > [Length Width] > [Group Bitmap] > [Character Masks] > [Code Lengths]
+
+// The generateContextTables function encodes the tables of a ContextModel in place of the code length table, with the
+// code length table of each cluster written one after the other by the BitWriter overload of generateCodeLengthTable.
+// The generateBlockTables function likewise encodes the header of every block of a BlockSplitter, and
+// generateDictionaryId only the ID of a Dictionary, whose codes are not written to the compressed file at all.
 
 // The generateHuffmanCode function uses the previously generated encoding table to take the original file and
-// create the complete Huffman Code.
+// create the complete Huffman Code. Each code is appended in a single BitWriter::writeBits call, so the Huffman Code
+// only ever occupies as much memory as its packed size. The file is viewed through the InputSource in blocks, and each block is encoded with
+// generateHuffmanCodeBlock, which is also used on its own when compressing in streaming mode. When a block index size
+// is given, the bit offset of every block of that size is recorded in the BlockIndex as the file is encoded. The
+// checksum of the original file is updated with each block right before it is encoded.
 
-// The generateHuffmanHeader function simply assigns the header values, type cast with the correct uint32_t type.
+// The generateInterleavedHuffmanCode function does the same for a file with interleaved streams, with every block
+// written by InterleavedStreams::encode. generateInterleavedHuffmanCodeBlock cuts every block at the sync points of the
+// block index as well, so that every sync point is the start of a block of the streams.
+
+// The generateHuffmanHeader function simply assigns the header values.
 
 #ifndef GENERATE_UTILS_H
 #define GENERATE_UTILS_H
 
 
-#include <fstream>
+#include <cstddef>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
+#include "huffman_tree/bit_stream/BitWriter.h"
+#include "huffman_tree/block_splitter/BlockSplitter.h"
+#include "huffman_tree/bit_stream/PackedBits.h"
+#include "huffman_tree/components/BlockIndex.h"
 #include "huffman_tree/components/FileInformation.h"
+#include "huffman_tree/components/HuffmanCodeword.h"
 #include "huffman_tree/components/HuffmanHeader.h"
+#include "huffman_tree/context_model/ContextModel.h"
+#include "huffman_tree/dictionary/Dictionary.h"
+#include "huffman_tree/histogram/ByteHistogram.h"
+#include "huffman_tree/interleaved/InterleavedStreams.h"
+#include "huffman_tree/tree_builder/TreeBuilder.h"
 #include "huffman_tree/HuffmanNode.h"
-
-// https://www.learncpp.com/cpp-tutorial/typedefs-and-type-aliases/
-typedef std::unordered_map<std::optional<char>, std::string> EncodingTable; // simple alias for the hash map type
+#include "input_source/InputSource.h"
 
 // generate encoding table
-void generateEncodingTable(EncodingTable& encodingTable, const HuffmanNode* root);
-void generateEncodingTableHelper(EncodingTable& encodingTable, const HuffmanNode* root, const std::string& code);
+void generateEncodingTable(EncodingTable& encodingTable, const HuffmanNodeArena& nodes, uint16_t root);
+void generateEncodingTableHelper(EncodingTable& encodingTable, const HuffmanNodeArena& nodes, uint16_t root,
+                                 uint64_t bits, uint8_t length);
+
+// generate canonical codes
+void generateCanonicalEncodingTable(EncodingTable& encodingTable);
+uint64_t generateLimitedEncodingTable(EncodingTable& encodingTable, const ByteHistogram& histogram,
+                                      TreeBuilderEngine engine, unsigned maxCodeLength);
+void generateCodeLengthTable(PackedBits& lengthTable, const EncodingTable& encodingTable);
+void generateCodeLengthTable(BitWriter& writer, const EncodingTable& encodingTable);
+void generateContextTables(PackedBits& representation, const ContextModel& contextModel);
+void generateBlockTables(PackedBits& representation, const BlockSplitter& blockSplitter);
+void generateDictionaryId(PackedBits& representation, const Dictionary& dictionary);
+void generateCanonicalTreeLayout(BitWriter& writer, const EncodingTable& encodingTable);
+void generateLengthListLayout(BitWriter& writer, const EncodingTable& encodingTable);
 
 // generate file information code
-void generateFileInfoCode(FileInformation& information, std::string& infoEncoding);
+void generateFileInfoCode(FileInformation& information, PackedBits& infoEncoding);
 
 // generate tree representation
-void generateHuffmanTreeRepresentation(std::string& representation, const HuffmanNode* root);
-void generateHuffmanTreeRepresentationHelper(std::string& representation, const HuffmanNode* root);
+void generateHuffmanTreeRepresentation(PackedBits& representation, const HuffmanNodeArena& nodes, uint16_t root);
+void generateHuffmanTreeRepresentationHelper(BitWriter& writer, const HuffmanNodeArena& nodes, uint16_t root);
 
 // generate huffman code
-void generateHuffmanCode(std::ifstream& input, const EncodingTable& encodingTable, std::string& encodingString);
+constexpr std::size_t ENCODE_BLOCK_SIZE{1 << 16}; // bytes of the original file read at a time
+void generateHuffmanCode(InputSource& input, const EncodingTable& encodingTable, PackedBits& encoding,
+                         uint64_t blockIndexSize, BlockIndex& blockIndex, uint32_t& checksum);
+void generateIndexedHuffmanCodeBlock(const uint8_t* data, std::size_t count, uint64_t position,
+                                     const EncodingTable& encodingTable, BitWriter& writer, uint64_t bitBase,
+                                     uint64_t blockIndexSize, std::vector<BlockIndexEntry>& entries);
+void generateHuffmanCodeBlock(const uint8_t* data, std::size_t count, const EncodingTable& encodingTable,
+                              BitWriter& writer);
+void generateInterleavedHuffmanCode(InputSource& input, const EncodingTable& encodingTable, unsigned streamCount,
+                                    PackedBits& encoding, uint64_t blockIndexSize, BlockIndex& blockIndex,
+                                    uint32_t& checksum);
+void generateInterleavedHuffmanCodeBlock(const uint8_t* data, std::size_t count, uint64_t position,
+                                         InterleavedStreams& interleavedStreams, BitWriter& writer, uint64_t bitBase,
+                                         uint64_t blockIndexSize, std::vector<BlockIndexEntry>& entries);
 
 // generate huffman header
-void generateHuffmanHeader(HuffmanHeader& header, std::size_t iLength, std::size_t tLength, std::size_t eLength);
+void generateHuffmanHeader(HuffmanHeader& header, uint64_t flags, uint64_t originalSize, uint64_t iLength,
+                           uint64_t tLength, uint64_t eLength);
 
 
 #endif // GENERATE_UTILS_H
@@ -2,21 +2,21 @@
 
 #include "instantiate_utils.h"
 
-void instantiateFileInformation(FileInformation& information, const std::string& infoEncoding) {
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "utils/compression/compression_utils.h"
+#include "utils/generate/generate_utils.h"
+
+void instantiateFileInformation(FileInformation& information, const PackedBits& infoEncoding) {
     // use huffmanFileInfoEncoding to instantiate fileInformation's fileName and fileExtension
 
     bool isFileName{true};
-    for (size_t i = 0; i < infoEncoding.length(); i += 8) {
+    BitReader reader{infoEncoding};
+    while (reader.remaining() >= 8) {
         // read byte
-        int byte{0};
-        for (size_t j = 0; j < 8; j++) {
-            if (infoEncoding[i + j] == '1') {
-                byte |= (1 << (7 - j));
-            }
-        }
-
-        // check character
-        char character{static_cast<char>(byte)};
+        char character{static_cast<char>(reader.readByte())};
 
         // when period is reached, change condition status so that fileExtension gets appended instead
         if (character == '.') {
@@ -32,31 +32,188 @@ void instantiateFileInformation(FileInformation& information, const std::string&
     }
 }
 
-HuffmanNode* instantiateHuffmanTree(const std::string& representation, int& position) {
+uint16_t instantiateHuffmanTree(BitReader& representation, HuffmanNodeArena& nodes) {
     // base case: position is past the boundary
-    if (position >= static_cast<int>(representation.length())) {
-        return nullptr;
+    if (representation.remaining() == 0) {
+        return NO_NODE;
     }
 
     // leaf node
-    if (representation[position] == '0') {
+    if (!representation.readBit()) {
         // leaf node - next 8 bits represent the character
-        ++position;
-        int byte{0};
-        for (int i{0}; i < 8; ++i) {
-            if (representation[position + i] == '1') {
-                byte |= (1 << (7 - i));
+        return nodes.add(HuffmanNode(static_cast<char>(representation.readByte()), 0));
+    }
+
+    // internal node, whose children can only be added once it has its own index
+    uint16_t node{nodes.add(HuffmanNode(0, NO_NODE, NO_NODE))};
+    if (node == NO_NODE) {
+        return NO_NODE;
+    }
+    uint16_t left{instantiateHuffmanTree(representation, nodes)};
+    uint16_t right{instantiateHuffmanTree(representation, nodes)};
+    nodes[node].left = left;
+    nodes[node].right = right;
+
+    return node;
+}
+
+bool instantiateCanonicalEncodingTable(EncodingTable& encodingTable, BitReader& lengthTable) {
+    encodingTable.fill(HuffmanCodeword{});
+
+    // the first bit selects the layout, where an empty table (from an empty file) has only that bit
+    if (lengthTable.remaining() == 0) {
+        return false;
+    }
+    if (!lengthTable.readBit()) {
+        if (lengthTable.remaining() >= 9 && !instantiateCanonicalTreeLayout(encodingTable, lengthTable, 0)) {
+            return false;
+        }
+    } else if (!instantiateLengthListLayout(encodingTable, lengthTable)) {
+        return false;
+    }
+
+    // count the characters of each length
+    std::array<unsigned, 65> lengthCounts{};
+    for (const HuffmanCodeword& codeword : encodingTable) {
+        ++lengthCounts[codeword.length];
+    }
+
+    // check that the codes of each length fit in what is left by the shorter codes
+    // (once more codes are left than there are characters, the check can no longer fail)
+    int64_t availableCodes{1};
+    for (std::size_t length{1}; length < lengthCounts.size(); ++length) {
+        availableCodes = std::min<int64_t>(availableCodes * 2, 512) - lengthCounts[length];
+        if (availableCodes < 0) {
+            return false;
+        }
+    }
+
+    generateCanonicalEncodingTable(encodingTable);
+    return true;
+}
+
+bool instantiateCanonicalTreeLayout(EncodingTable& encodingTable, BitReader& lengthTable, unsigned depth) {
+    // base case: position is past the boundary
+    if (lengthTable.remaining() == 0) {
+        return false;
+    }
+
+    // leaf node, where a tree with only one node still has a code of 1 bit
+    if (!lengthTable.readBit()) {
+        if (lengthTable.remaining() < 8) {
+            return false;
+        }
+        HuffmanCodeword& codeword{encodingTable[lengthTable.readByte()]};
+        if (codeword.length != 0) {
+            return false; // the same character twice
+        }
+        codeword.length = static_cast<uint8_t>(depth == 0 ? 1 : depth);
+        return true;
+    }
+
+    // internal node, where a HuffmanCodeword holds at most 64 bits
+    if (depth == 64) {
+        return false;
+    }
+    return instantiateCanonicalTreeLayout(encodingTable, lengthTable, depth + 1) &&
+           instantiateCanonicalTreeLayout(encodingTable, lengthTable, depth + 1);
+}
+
+bool instantiateLengthListLayout(EncodingTable& encodingTable, BitReader& lengthTable) {
+    if (lengthTable.remaining() < 35) {
+        return false;
+    }
+
+    // read which characters occur
+    unsigned lengthWidth{static_cast<unsigned>(lengthTable.readBits(3)) + 1};
+    auto groupBitmap{static_cast<uint32_t>(lengthTable.readBits(32))};
+    std::array<bool, 256> occurs{};
+    for (std::size_t group{0}; group < 32; ++group) {
+        if ((groupBitmap >> (31 - group) & 1) != 0) {
+            if (lengthTable.remaining() < 8) {
+                return false;
+            }
+            uint8_t mask{lengthTable.readByte()};
+            for (std::size_t i{0}; i < 8; ++i) {
+                occurs[group * 8 + i] = (mask & (0x80 >> i)) != 0;
+            }
+        }
+    }
+
+    // read the length of every character which occurs
+    for (std::size_t character{0}; character < encodingTable.size(); ++character) {
+        if (occurs[character]) {
+            if (lengthTable.remaining() < lengthWidth) {
+                return false;
+            }
+            auto length{static_cast<uint8_t>(lengthTable.readBits(lengthWidth))};
+            // a HuffmanCodeword holds at most 64 bits
+            if (length == 0 || length > 64) {
+                return false;
             }
+            encodingTable[character].length = length;
         }
-        position += 8;
-        return new HuffmanNode(static_cast<char>(byte), 0);
     }
 
-    // internal node
-    ++position;
-    auto* node = new HuffmanNode(0); // Create internal node
-    node->left = instantiateHuffmanTree(representation, position);
-    node->right = instantiateHuffmanTree(representation, position);
+    return true;
+}
 
-    return node;
+bool instantiateContextModel(ContextModel& contextModel, BitReader& representation, unsigned decodingTableBits) {
+    // the number of tables, then the table of every context
+    if (representation.remaining() < ContextModel::TABLE_COUNT_BITS) {
+        return false;
+    }
+    auto tableCount{static_cast<unsigned>(representation.readBits(ContextModel::TABLE_COUNT_BITS)) + 1};
+    unsigned indexBits{ContextModel::indexBits(tableCount)};
+    if (representation.remaining() < ContextHistogram::CONTEXT_COUNT * indexBits) {
+        return false;
+    }
+    ContextClusters clusters{};
+    for (uint8_t& table : clusters) {
+        table = static_cast<uint8_t>(representation.readBits(indexBits));
+    }
+
+    // then the code length table of every table
+    std::vector<EncodingTable> tables(tableCount);
+    for (EncodingTable& table : tables) {
+        if (!instantiateCanonicalEncodingTable(table, representation)) {
+            return false;
+        }
+    }
+
+    return contextModel.setTables(clusters, tables, decodingTableBits);
+}
+
+bool instantiateBlockSplitter(BlockSplitter& blockSplitter, BitReader& representation, unsigned decodingTableBits) {
+    // the number of blocks, where every block header takes at least a byte
+    uint64_t blockCount{0};
+    if (!readVarint(representation, blockCount) || blockCount == 0 || blockCount > representation.remaining() / 8) {
+        return false;
+    }
+
+    // then the size of every block, and either the reuse of the table before it or its own code length table
+    std::vector<SplitBlock> blocks(blockCount);
+    std::vector<EncodingTable> tables{};
+    for (std::size_t i{0}; i < blocks.size(); ++i) {
+        if (!readVarint(representation, blocks[i].size)) {
+            return false;
+        }
+        if (i != 0) {
+            if (representation.remaining() == 0) {
+                return false;
+            }
+            if (representation.readBit()) {
+                blocks[i].table = blocks[i - 1].table;
+                continue;
+            }
+        }
+
+        tables.emplace_back();
+        if (!instantiateCanonicalEncodingTable(tables.back(), representation)) {
+            return false;
+        }
+        blocks[i].table = tables.size() - 1;
+    }
+
+    return blockSplitter.setTables(blocks, tables, decodingTableBits);
 }
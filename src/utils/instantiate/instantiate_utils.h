@@ -9,20 +9,43 @@
 
 // The instantiateHuffmanTree function is a recursive function that reads the Tree Representation so that the original
 // Huffman Tree can be recreated. The tree is built top-down in a preorder traversal fashion. When a 1 is read, a
-// new Node is created with character key empty and the left and right are assigned with the incremented position.
+// new Node is created with character key empty and the left and right are assigned with the following bits read.
 // When a 0 is read, a substantiated node with a character key is created after decoding the resulting byte. The
-// position variable is moved accordingly and the node is recursively assigned to its appropriate parent. Weights are
-// not store and are not needed at this point.
+// BitReader keeps track of the position and the node is recursively assigned to its appropriate parent. Weights are
+// not store and are not needed at this point. The nodes are added to a HuffmanNodeArena and the index of the root is
+// returned; a corrupted representation with more nodes than the arena holds simply ends with missing nodes (NO_NODE).
+
+// The instantiateCanonicalEncodingTable function reads the code lengths written by generateCodeLengthTable and
+// reassigns the canonical codes with generateCanonicalEncodingTable, so that the DecodingTable can be built without
+// ever creating a Huffman Tree. In the tree layout, the length of each character is simply the depth at which its
+// leaf is read, so only the depth is tracked while reading. As a corrupted table could assign the same code to several characters, the lengths
+// are first checked to describe a valid prefix code (the Kraft inequality); false is returned when they do not.
+
+// https://en.wikipedia.org/wiki/Kraft%E2%80%93McMillan_inequality
+
+// The instantiateContextModel function reads the tables written by generateContextTables, reading the code length
+// table of each cluster in turn from the same BitReader, and returns false when any of them is invalid. The
+// instantiateBlockSplitter function does the same with the block headers written by generateBlockTables.
 
 #ifndef INSTANTIATE_UTILS_H
 #define INSTANTIATE_UTILS_H
 
 
 #include "huffman_tree/HuffmanNode.h"
+#include "huffman_tree/bit_stream/BitReader.h"
+#include "huffman_tree/block_splitter/BlockSplitter.h"
+#include "huffman_tree/bit_stream/PackedBits.h"
 #include "huffman_tree/components/FileInformation.h"
-
-void instantiateFileInformation(FileInformation& information, const std::string& infoEncoding);
-HuffmanNode* instantiateHuffmanTree(const std::string& representation, int& position);
+#include "huffman_tree/components/HuffmanCodeword.h"
+#include "huffman_tree/context_model/ContextModel.h"
+
+void instantiateFileInformation(FileInformation& information, const PackedBits& infoEncoding);
+uint16_t instantiateHuffmanTree(BitReader& representation, HuffmanNodeArena& nodes);
+bool instantiateCanonicalEncodingTable(EncodingTable& encodingTable, BitReader& lengthTable);
+bool instantiateCanonicalTreeLayout(EncodingTable& encodingTable, BitReader& lengthTable, unsigned depth);
+bool instantiateLengthListLayout(EncodingTable& encodingTable, BitReader& lengthTable);
+bool instantiateContextModel(ContextModel& contextModel, BitReader& representation, unsigned decodingTableBits);
+bool instantiateBlockSplitter(BlockSplitter& blockSplitter, BitReader& representation, unsigned decodingTableBits);
 
 
 #endif // INSTANTIATE_UTILS_H
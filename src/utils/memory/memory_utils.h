@@ -0,0 +1,19 @@
+// Memory Utilities Header
+
+// getPeakMemoryUsage gives the most memory (resident set size) the program has held at any one time since it started,
+// in bytes, or 0 where it cannot be determined. It is the peak of the whole process, so when several files are
+// compressed at once it covers all of them. Platform-specific code is used: on Windows GetProcessMemoryInfo() and on
+// Linux/macOS getrusage(), which gives kilobytes on Linux and bytes on macOS.
+
+// https://man7.org/linux/man-pages/man2/getrusage.2.html
+
+#ifndef MEMORY_UTILS_H
+#define MEMORY_UTILS_H
+
+
+#include <cstdint>
+
+uint64_t getPeakMemoryUsage();
+
+
+#endif // MEMORY_UTILS_H
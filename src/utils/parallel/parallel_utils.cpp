@@ -0,0 +1,525 @@
+// Parallel Utilities Implementation
+
+#include "parallel_utils.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "huffman_tree/bit_stream/BitWriter.h"
+#include "huffman_tree/bit_stream/BitReader.h"
+#include "thread_pool/ThreadPool.h"
+#include "utils/checksum/checksum_utils.h"
+#include "utils/compression/compression_utils.h"
+#include "utils/generate/generate_utils.h"
+
+void splitFrequencyChunks(uint64_t fileSize, unsigned threadCount, std::vector<FrequencyChunk>& chunks) {
+    chunks.clear();
+    if (fileSize == 0) {
+        return;
+    }
+
+    // one chunk per thread, unless that would make the chunks too small
+    uint64_t chunkCount{std::max<uint64_t>(1, std::min<uint64_t>(threadCount, fileSize / MIN_CHUNK_SIZE))};
+    uint64_t chunkSize{(fileSize + chunkCount - 1) / chunkCount};
+
+    for (uint64_t begin{0}; begin < fileSize; begin += chunkSize) {
+        FrequencyChunk chunk{};
+        chunk.begin = begin;
+        chunk.end = std::min(begin + chunkSize, fileSize);
+        chunks.push_back(chunk);
+    }
+}
+
+void countFrequenciesParallel(InputSource& input, unsigned threadCount, HistogramEngine engine,
+                              std::vector<FrequencyChunk>& chunks, ByteHistogram& histogram, bool splitBlocks,
+                              ContextHistogram* contextHistogram) {
+    splitFrequencyChunks(input.size(), threadCount, chunks);
+    for (FrequencyChunk& chunk : chunks) {
+        chunk.histogram = ByteHistogram{engine};
+        chunk.splitter = BlockSplitter{engine};
+    }
+    std::vector<ContextHistogram> chunkContexts(contextHistogram != nullptr ? chunks.size() : 0);
+
+    ThreadPool pool{static_cast<unsigned>(std::min<std::size_t>(threadCount, chunks.size()))};
+    for (std::size_t i{0}; i < chunks.size(); ++i) {
+        ContextHistogram* chunkContext{contextHistogram != nullptr ? &chunkContexts[i] : nullptr};
+        pool.submit([&input, &chunk = chunks[i], chunkContext, splitBlocks] {
+            std::vector<uint8_t> block{};
+            const uint8_t* data{nullptr};
+
+            // the first pair of the chunk starts with the last character of the chunk before it
+            uint8_t previous{0};
+            if (chunkContext != nullptr && chunk.begin != 0 && input.view(chunk.begin - 1, 1, data, block) == 1) {
+                previous = data[0];
+            }
+
+            for (uint64_t position{chunk.begin}; position < chunk.end;) {
+                auto maxSize{static_cast<std::size_t>(std::min<uint64_t>(CHUNK_READ_SIZE, chunk.end - position))};
+                std::size_t count{input.view(position, maxSize, data, block)};
+                if (count == 0) {
+                    break;
+                }
+
+                if (splitBlocks) {
+                    chunk.splitter.count(data, count);
+                } else {
+                    chunk.histogram.count(data, count);
+                }
+                if (chunkContext != nullptr) {
+                    previous = chunkContext->count(data, count, previous);
+                }
+                input.release(position, count);
+                position += count;
+            }
+
+            if (splitBlocks) {
+                chunk.splitter.finish();
+                chunk.splitter.total(chunk.histogram);
+            }
+        });
+    }
+    pool.wait();
+
+    // merge the histograms of every chunk
+    histogram.clear();
+    for (const FrequencyChunk& chunk : chunks) {
+        histogram.merge(chunk.histogram);
+    }
+    if (contextHistogram != nullptr) {
+        contextHistogram->clear();
+        for (const ContextHistogram& chunkContext : chunkContexts) {
+            contextHistogram->merge(chunkContext);
+        }
+    }
+}
+
+namespace {
+    // the encoder of a chunk, which carries on from the character before the chunk (or the block holding its first
+    // character) without changing the ContextModel (or BlockSplitter)
+    class ContextChunkEncoder {
+    public:
+        // public data members
+        const ContextModel& contextModel;
+        uint8_t previous{0};
+
+        void encode(const uint8_t* data, std::size_t size, BitWriter& writer) {
+            contextModel.encode(data, size, writer, previous);
+        }
+    };
+
+    ContextChunkEncoder encoderOfChunk(const ContextModel& contextModel, uint64_t, uint8_t previous) {
+        return ContextChunkEncoder{contextModel, previous};
+    }
+
+    class SplitChunkEncoder {
+    public:
+        // public data members
+        const BlockSplitter& blockSplitter;
+        SplitPosition position{};
+
+        void encode(const uint8_t* data, std::size_t size, BitWriter& writer) {
+            blockSplitter.encode(data, size, writer, position);
+        }
+    };
+
+    SplitChunkEncoder encoderOfChunk(const BlockSplitter& blockSplitter, uint64_t begin, uint8_t) {
+        SplitChunkEncoder chunkEncoder{blockSplitter};
+        blockSplitter.seek(begin, chunkEncoder.position); // the blocks hold the whole file, so begin is within them
+        return chunkEncoder;
+    }
+
+    // writes every bit of bits, 64 at a time
+    void copyBits(const PackedBits& bits, BitWriter& writer) {
+        const uint8_t* bytes{bits.bytes.data()};
+        uint64_t remaining{bits.bitLength};
+        for (; remaining >= 64; remaining -= 64, bytes += 8) {
+            uint64_t word{0};
+            for (int i{0}; i < 8; ++i) {
+                word = (word << 8) | bytes[i];
+            }
+            writer.writeBits(word, 64);
+        }
+        for (; remaining > 0; ++bytes) {
+            auto count{static_cast<unsigned>(std::min<uint64_t>(remaining, 8))};
+            writer.writeBits(*bytes >> (8 - count), count);
+            remaining -= count;
+        }
+    }
+
+    template <typename Encoder>
+    void generateHuffmanCodeInChunks(InputSource& input, unsigned threadCount, const Encoder& encoder,
+                                     PackedBits& encoding, uint64_t blockIndexSize, BlockIndex& blockIndex,
+                                     uint32_t& checksum) {
+        std::vector<FrequencyChunk> chunks{};
+        splitFrequencyChunks(input.size(), threadCount, chunks);
+        ThreadPool pool{static_cast<unsigned>(std::min<std::size_t>(threadCount, chunks.size()))};
+
+        // every chunk is encoded into its own PackedBits, starting from the character before it
+        std::vector<PackedBits> chunkEncodings(chunks.size());
+        for (std::size_t i{0}; i < chunks.size(); ++i) {
+            pool.submit([&input, &chunk = chunks[i], &chunkEncoding = chunkEncodings[i], &encoder, blockIndexSize] {
+                std::vector<uint8_t> block{};
+                const uint8_t* data{nullptr};
+                uint8_t previous{0};
+                if (chunk.begin != 0 && input.view(chunk.begin - 1, 1, data, block) == 1) {
+                    previous = data[0];
+                }
+                auto chunkEncoder{encoderOfChunk(encoder, chunk.begin, previous)};
+
+                BitWriter writer{chunkEncoding};
+                for (uint64_t position{chunk.begin}; position < chunk.end;) {
+                    auto maxSize{static_cast<std::size_t>(std::min<uint64_t>(CHUNK_READ_SIZE, chunk.end - position))};
+                    std::size_t count{input.view(position, maxSize, data, block)};
+                    if (count == 0) {
+                        break;
+                    }
+
+                    // encode up to each block boundary, recording a sync point with the character before it whenever
+                    // one is reached
+                    chunk.checksum = updateCrc32c(chunk.checksum, data, count);
+                    for (std::size_t done{0}; done < count;) {
+                        std::size_t length{count - done};
+                        if (blockIndexSize != 0) {
+                            uint64_t offsetInBlock{(position + done) % blockIndexSize};
+                            if (offsetInBlock == 0) {
+                                chunk.blockIndexEntries.push_back(BlockIndexEntry{writer.bitCount(), position + done,
+                                                                                  previous});
+                            }
+                            length = static_cast<std::size_t>(std::min<uint64_t>(length,
+                                                                                 blockIndexSize - offsetInBlock));
+                        }
+                        chunkEncoder.encode(data + done, length, writer);
+                        done += length;
+                        previous = data[done - 1];
+                    }
+                    input.release(position, count);
+                    position += count;
+                }
+
+                writer.flush();
+            });
+        }
+        pool.wait();
+
+        // then copied into its own slice of the whole Huffman Code, which starts after the chunks before it
+        uint64_t bitLength{0};
+        for (std::size_t i{0}; i < chunks.size(); ++i) {
+            chunks[i].bitOffset = bitLength;
+            bitLength += chunkEncodings[i].bitLength;
+        }
+        encoding.clear();
+        encoding.bitLength = bitLength;
+        encoding.bytes.assign(encoding.byteLength(), 0);
+        for (std::size_t i{0}; i < chunks.size(); ++i) {
+            pool.submit([&chunk = chunks[i], &chunkEncoding = chunkEncodings[i], &encoding] {
+                BitWriter writer{encoding.bytes.data(), chunk.bitOffset};
+                copyBits(chunkEncoding, writer);
+                writer.flush();
+                chunk.headByte = writer.getHeadByte();
+                chunkEncoding = PackedBits{};
+            });
+        }
+        pool.wait();
+
+        // and the shared first bytes, sync points and checksums are combined as for a single table
+        blockIndex.entries.clear();
+        blockIndex.originalSize = chunks.empty() ? 0 : chunks.back().end;
+        checksum = 0;
+        for (const FrequencyChunk& chunk : chunks) {
+            checksum = combineCrc32c(checksum, chunk.checksum, chunk.end - chunk.begin);
+            if (chunk.bitOffset % 8 != 0) {
+                encoding.bytes[chunk.bitOffset / 8] |= chunk.headByte;
+            }
+            for (BlockIndexEntry entry : chunk.blockIndexEntries) {
+                entry.bitOffset += chunk.bitOffset;
+                blockIndex.entries.push_back(entry);
+            }
+        }
+    }
+}
+
+void generateHuffmanCodeParallel(InputSource& input, unsigned threadCount, std::vector<FrequencyChunk>& chunks,
+                                 const EncodingTable& encodingTable, PackedBits& encoding, uint64_t blockIndexSize,
+                                 BlockIndex& blockIndex, uint32_t& checksum) {
+    // determine the bit offset of every chunk from its frequencies and the code lengths
+    uint64_t bitLength{0};
+    for (FrequencyChunk& chunk : chunks) {
+        chunk.bitOffset = bitLength;
+        chunk.headByte = 0;
+        chunk.blockIndexEntries.clear();
+        chunk.checksum = 0;
+        for (std::size_t i{0}; i < chunk.histogram.frequencies.size(); ++i) {
+            bitLength += chunk.histogram.frequencies[i] * encodingTable[i].length;
+        }
+    }
+
+    // allocate the whole Huffman Code once, zero-initialized so that padding bits are 0s
+    encoding.clear();
+    encoding.bitLength = bitLength;
+    encoding.bytes.assign(encoding.byteLength(), 0);
+
+    {
+        ThreadPool pool{static_cast<unsigned>(std::min<std::size_t>(threadCount, chunks.size()))};
+        for (FrequencyChunk& chunk : chunks) {
+            pool.submit([&input, &chunk, &encodingTable, &encoding, blockIndexSize] {
+                BitWriter writer{encoding.bytes.data(), chunk.bitOffset};
+                std::vector<uint8_t> block{};
+                const uint8_t* data{nullptr};
+                for (uint64_t position{chunk.begin}; position < chunk.end;) {
+                    auto maxSize{static_cast<std::size_t>(std::min<uint64_t>(CHUNK_READ_SIZE, chunk.end - position))};
+                    std::size_t count{input.view(position, maxSize, data, block)};
+                    if (count == 0) {
+                        break;
+                    }
+
+                    chunk.checksum = updateCrc32c(chunk.checksum, data, count);
+                    generateIndexedHuffmanCodeBlock(data, count, position, encodingTable, writer,
+                                                    chunk.bitOffset, blockIndexSize, chunk.blockIndexEntries);
+                    input.release(position, count);
+                    position += count;
+                }
+
+                writer.flush();
+                chunk.headByte = writer.getHeadByte();
+            });
+        }
+        pool.wait();
+    }
+
+    // combine the first byte of every slice, which is shared with the end of the previous slice,
+    // and gather the sync points and checksum of every chunk in order
+    blockIndex.entries.clear();
+    blockIndex.originalSize = chunks.empty() ? 0 : chunks.back().end;
+    checksum = 0;
+    for (const FrequencyChunk& chunk : chunks) {
+        checksum = combineCrc32c(checksum, chunk.checksum, chunk.end - chunk.begin);
+        if (chunk.bitOffset % 8 != 0) {
+            encoding.bytes[chunk.bitOffset / 8] |= chunk.headByte;
+        }
+        blockIndex.entries.insert(blockIndex.entries.end(), chunk.blockIndexEntries.begin(),
+                                  chunk.blockIndexEntries.end());
+    }
+}
+
+void generateInterleavedHuffmanCodeParallel(InputSource& input, unsigned threadCount,
+                                            const EncodingTable& encodingTable, unsigned streamCount,
+                                            PackedBits& encoding, uint64_t blockIndexSize, BlockIndex& blockIndex,
+                                            uint32_t& checksum) {
+    // every chunk but the first starts on a block of the streams, as a single thread would have started a block there
+    std::vector<FrequencyChunk> chunks{};
+    splitFrequencyChunks(input.size(), threadCount, chunks);
+    for (std::size_t i{1}; i < chunks.size(); ++i) {
+        chunks[i].begin -= chunks[i].begin % InterleavedStreams::BLOCK_SIZE;
+        chunks[i - 1].end = chunks[i].begin;
+    }
+
+    std::vector<PackedBits> chunkEncodings(chunks.size());
+    {
+        ThreadPool pool{static_cast<unsigned>(std::min<std::size_t>(threadCount, chunks.size()))};
+        for (std::size_t i{0}; i < chunks.size(); ++i) {
+            pool.submit([&input, &chunk = chunks[i], &chunkEncoding = chunkEncodings[i], &encodingTable, streamCount,
+                         blockIndexSize] {
+                InterleavedStreams interleavedStreams{encodingTable, streamCount};
+                BitWriter writer{chunkEncoding};
+                std::vector<uint8_t> block{};
+                const uint8_t* data{nullptr};
+                for (uint64_t position{chunk.begin}; position < chunk.end;) {
+                    auto maxSize{static_cast<std::size_t>(std::min<uint64_t>(CHUNK_READ_SIZE, chunk.end - position))};
+                    std::size_t count{input.view(position, maxSize, data, block)};
+                    if (count == 0) {
+                        break;
+                    }
+
+                    chunk.checksum = updateCrc32c(chunk.checksum, data, count);
+                    generateInterleavedHuffmanCodeBlock(data, count, position, interleavedStreams, writer, 0,
+                                                        blockIndexSize, chunk.blockIndexEntries);
+                    input.release(position, count);
+                    position += count;
+                }
+
+                writer.flush();
+            });
+        }
+        pool.wait();
+    }
+
+    // join the Huffman Code of every chunk, moving its sync points to where the chunk starts,
+    // and combine the checksum of every chunk in order
+    encoding.clear();
+    blockIndex.entries.clear();
+    blockIndex.originalSize = chunks.empty() ? 0 : chunks.back().end;
+    checksum = 0;
+    for (std::size_t i{0}; i < chunks.size(); ++i) {
+        const FrequencyChunk& chunk{chunks[i]};
+        checksum = combineCrc32c(checksum, chunk.checksum, chunk.end - chunk.begin);
+        for (BlockIndexEntry entry : chunk.blockIndexEntries) {
+            entry.bitOffset += encoding.bitLength;
+            blockIndex.entries.push_back(entry);
+        }
+        encoding.bytes.insert(encoding.bytes.end(), chunkEncodings[i].bytes.begin(), chunkEncodings[i].bytes.end());
+        encoding.bitLength += chunkEncodings[i].bitLength;
+    }
+}
+
+void generateHuffmanCodeParallel(InputSource& input, unsigned threadCount, const ContextModel& contextModel,
+                                 PackedBits& encoding, uint64_t blockIndexSize, BlockIndex& blockIndex,
+                                 uint32_t& checksum) {
+    generateHuffmanCodeInChunks(input, threadCount, contextModel, encoding, blockIndexSize, blockIndex, checksum);
+}
+
+void generateHuffmanCodeParallel(InputSource& input, unsigned threadCount, const BlockSplitter& blockSplitter,
+                                 PackedBits& encoding, uint64_t blockIndexSize, BlockIndex& blockIndex,
+                                 uint32_t& checksum) {
+    generateHuffmanCodeInChunks(input, threadCount, blockSplitter, encoding, blockIndexSize, blockIndex, checksum);
+}
+
+namespace {
+    // the decoder of a block: the DecodingTable is shared by every thread, while the InterleavedStreams are copied,
+    // and the ContextModel (or BlockSplitter) is shared with the character before the block (or the position of the
+    // block in the split blocks) carried for each
+    const DecodingTable& decoderOfBlock(const DecodingTable& decodingTable, const BlockIndexEntry&) {
+        return decodingTable;
+    }
+
+    InterleavedStreams decoderOfBlock(const InterleavedStreams& interleavedStreams, const BlockIndexEntry&) {
+        return interleavedStreams;
+    }
+
+    class ContextBlockDecoder {
+    public:
+        // public data members
+        const ContextModel& contextModel;
+        uint8_t previous{0};
+
+        std::size_t decode(BitReader& reader, uint64_t bitLength, uint8_t* output, std::size_t capacity,
+                           bool& corrupted) {
+            return contextModel.decode(reader, bitLength, output, capacity, corrupted, previous);
+        }
+    };
+
+    ContextBlockDecoder decoderOfBlock(const ContextModel& contextModel, const BlockIndexEntry& entry) {
+        return ContextBlockDecoder{contextModel, entry.previous};
+    }
+
+    class SplitBlockDecoder {
+    public:
+        // public data members
+        const BlockSplitter& blockSplitter;
+        SplitPosition position{};
+
+        std::size_t decode(BitReader& reader, uint64_t bitLength, uint8_t* output, std::size_t capacity,
+                           bool& corrupted) {
+            return blockSplitter.decode(reader, bitLength, output, capacity, corrupted, position);
+        }
+    };
+
+    SplitBlockDecoder decoderOfBlock(const BlockSplitter& blockSplitter, const BlockIndexEntry& entry) {
+        // a sync point past the end of the blocks leaves the position after the last block, where any code is corrupted
+        SplitBlockDecoder blockDecoder{blockSplitter};
+        blockSplitter.seek(entry.outputOffset, blockDecoder.position);
+        return blockDecoder;
+    }
+
+    template <typename Decoder>
+    bool decodeParallelWith(const std::string& destination, unsigned threadCount, const Decoder& decoder,
+                            const BitSpan& encoding, const BlockIndex& blockIndex, uint32_t& checksum) {
+        // create the decompressed file at its final size so that every thread can write into its own region
+        {
+            std::ofstream output{destination, std::ios::out | std::ios::binary | std::ios::trunc};
+            if (!output) {
+                return false;
+            }
+            if (blockIndex.originalSize > 0) {
+                output.seekp(static_cast<std::streamoff>(blockIndex.originalSize - 1));
+                output.put('\0');
+            }
+            if (!output) {
+                return false;
+            }
+        }
+
+        // neighbouring indexed blocks are joined until each is at least MIN_CHUNK_SIZE bytes, as the sync points of a
+        // fine-grained index are not all worth a thread of their own
+        std::vector<BlockIndexEntry> blocks{};
+        for (const BlockIndexEntry& entry : blockIndex.entries) {
+            if (blocks.empty() || entry.outputOffset >= blocks.back().outputOffset + MIN_CHUNK_SIZE) {
+                blocks.push_back(entry);
+            }
+        }
+
+        std::atomic<bool> failed{false};
+        std::vector<uint32_t> blockChecksums(blocks.size(), 0);
+        ThreadPool pool{threadCount};
+        for (std::size_t i{0}; i < blocks.size(); ++i) {
+            const BlockIndexEntry& entry{blocks[i]};
+            uint64_t blockEnd{i + 1 < blocks.size() ? blocks[i + 1].outputOffset : blockIndex.originalSize};
+            uint32_t& blockChecksum{blockChecksums[i]};
+
+            pool.submit([&destination, &decoder, &encoding, &entry, blockEnd, &blockChecksum, &failed] {
+                auto&& blockDecoder{decoderOfBlock(decoder, entry)};
+                std::fstream output{destination, std::ios::in | std::ios::out | std::ios::binary};
+                output.seekp(static_cast<std::streamoff>(entry.outputOffset));
+
+                // start reading at the byte holding the sync point, then skip to its bit
+                std::size_t firstByte{static_cast<std::size_t>(entry.bitOffset / 8)};
+                if (firstByte > encoding.byteLength) {
+                    failed = true;
+                    return;
+                }
+                BitReader reader{encoding.bytes + firstByte, encoding.byteLength - firstByte,
+                                 encoding.bitLength - firstByte * 8};
+                reader.skipBits(static_cast<unsigned>(entry.bitOffset % 8));
+
+                // decode exactly the characters of this block
+                std::vector<uint8_t> buffer(DECODE_BUFFER_SIZE);
+                uint64_t remaining{blockEnd - entry.outputOffset};
+                bool corrupted{false};
+                while (remaining > 0 && !corrupted) {
+                    auto capacity{static_cast<std::size_t>(std::min<uint64_t>(buffer.size(), remaining))};
+                    std::size_t count{blockDecoder.decode(reader, reader.position() + reader.remaining(), buffer.data(),
+                                                          capacity, corrupted)};
+                    if (count == 0) {
+                        corrupted = true;
+                    }
+                    blockChecksum = updateCrc32c(blockChecksum, buffer.data(), count);
+                    output.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(count));
+                    remaining -= count;
+                }
+
+                if (corrupted || !output) {
+                    failed = true;
+                }
+            });
+        }
+        pool.wait();
+
+        // combine the checksum of every block in order
+        checksum = 0;
+        for (std::size_t i{0}; i < blocks.size(); ++i) {
+            uint64_t blockEnd{i + 1 < blocks.size() ? blocks[i + 1].outputOffset : blockIndex.originalSize};
+            checksum = combineCrc32c(checksum, blockChecksums[i], blockEnd - blocks[i].outputOffset);
+        }
+
+        return !failed;
+    }
+}
+
+bool decodeParallel(const std::string& destination, unsigned threadCount, const DecodingTable& decodingTable,
+                    const BitSpan& encoding, const BlockIndex& blockIndex, uint32_t& checksum) {
+    return decodeParallelWith(destination, threadCount, decodingTable, encoding, blockIndex, checksum);
+}
+
+bool decodeParallel(const std::string& destination, unsigned threadCount, const InterleavedStreams& interleavedStreams,
+                    const BitSpan& encoding, const BlockIndex& blockIndex, uint32_t& checksum) {
+    return decodeParallelWith(destination, threadCount, interleavedStreams, encoding, blockIndex, checksum);
+}
+
+bool decodeParallel(const std::string& destination, unsigned threadCount, const ContextModel& contextModel,
+                    const BitSpan& encoding, const BlockIndex& blockIndex, uint32_t& checksum) {
+    return decodeParallelWith(destination, threadCount, contextModel, encoding, blockIndex, checksum);
+}
+
+bool decodeParallel(const std::string& destination, unsigned threadCount, const BlockSplitter& blockSplitter,
+                    const BitSpan& encoding, const BlockIndex& blockIndex, uint32_t& checksum) {
+    return decodeParallelWith(destination, threadCount, blockSplitter, encoding, blockIndex, checksum);
+}
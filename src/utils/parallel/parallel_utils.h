@@ -0,0 +1,104 @@
+// Parallel Utilities Header
+
+// This module contains the functions used when a file is compressed with more than one thread. Both passes over the
+// original file, counting the frequencies and generating the Huffman Code, are split across a ThreadPool with one
+// contiguous chunk of the file per thread.
+
+// The splitFrequencyChunks function divides the file into chunks of roughly equal size, with no chunk smaller than
+// MIN_CHUNK_SIZE so that small files do not pay for threads they cannot use.
+
+// The countFrequenciesParallel function has every thread count the characters of its own chunk into the ByteHistogram
+// of its own FrequencyChunk, so that no locking is needed while counting. The histograms are merged once every thread
+// has finished. When splitting the file into blocks, every thread counts its chunk with its own BlockSplitter instead,
+// whose blocks make up the histogram of the chunk. When a ContextHistogram is given, every thread also counts the
+// pairs of characters of its chunk in the same pass, starting from the character just before its chunk, so that the
+// merged counts are the same as those of a single thread.
+
+// The generateHuffmanCodeParallel function first determines where each chunk begins in the Huffman Code: the bit
+// length of a chunk is the sum of the frequency of every character in the chunk multiplied by the length of its code,
+// and the bit offset of a chunk is the sum of the bit lengths of every chunk before it. The whole Huffman Code is then
+// allocated once, and every thread encodes its chunk directly into its own slice of it using a BitWriter. The shared
+// first byte of every slice is combined once all threads have finished. The result is bit for bit the same as
+// encoding the file with a single thread. If a block index size is given, every thread also records the sync points
+// within its chunk, which are then gathered in order into the BlockIndex. Every thread also computes the checksum of
+// its own chunk as it encodes it, and the checksums of the chunks are then combined in order (see combineCrc32c).
+
+// The generateInterleavedHuffmanCodeParallel function does the same for a file with interleaved streams (see
+// InterleavedStreams). As the headers and padding of the blocks cannot be known before they are written, every thread
+// writes its chunk into a PackedBits of its own, and the chunks are then joined in order, which is cheap as every chunk
+// is whole bytes. The chunks are made to start on a block of the streams, so that the result is again the same as
+// encoding the file with a single thread.
+
+// A file with context tables (see ContextModel) or split blocks (see BlockSplitter) cannot know the bit length of a
+// chunk before it is encoded, so the overloads of generateHuffmanCodeParallel taking a ContextModel or a BlockSplitter
+// have every thread encode its chunk into a PackedBits of its own, starting from the character just before its chunk
+// or the block holding its first character, and record the sync points within it along with the character before
+// each. The Huffman Code is then allocated once the length of every chunk is known, and every thread
+// copies its chunk into its own slice of it as above, so that the result is again the same as with a single thread.
+
+// The decodeParallel function is the counterpart used when decompressing a file with a BlockIndex. The decompressed
+// file is first extended to its final size, then each indexed block is decoded by a thread of the pool, starting from
+// its recorded bit offset, and written through the thread's own stream into its own region of the file. Blocks smaller
+// than MIN_CHUNK_SIZE are joined with the blocks after them first, since an index fine enough for seeking (see
+// HuffmanTree::decompressRange) has far more blocks than threads. The checksum of the decompressed file is likewise
+// combined from the checksum of every block. A file with interleaved streams is decoded the same way, with the
+// InterleavedStreams copied for every block so that no thread shares the streams of another, a file with context
+// tables with every block decoded from the character recorded before it, and a file with split blocks with every
+// block decoded from the split block holding its first character.
+
+// All threads view the original file through the same InputSource. When the file is memory-mapped, every thread
+// reads its chunk directly from the mapping; otherwise each read of a block is protected by the mutex of the
+// InputSource, and only the reads are serialized while counting and encoding happen in parallel.
+
+#ifndef PARALLEL_UTILS_H
+#define PARALLEL_UTILS_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "huffman_tree/bit_stream/PackedBits.h"
+#include "huffman_tree/block_splitter/BlockSplitter.h"
+#include "huffman_tree/components/BlockIndex.h"
+#include "huffman_tree/components/FrequencyChunk.h"
+#include "huffman_tree/components/HuffmanCodeword.h"
+#include "huffman_tree/context_model/ContextModel.h"
+#include "huffman_tree/decoding_table/DecodingTable.h"
+#include "huffman_tree/histogram/ContextHistogram.h"
+#include "huffman_tree/interleaved/InterleavedStreams.h"
+#include "input_source/InputSource.h"
+
+constexpr uint64_t MIN_CHUNK_SIZE{1 << 20}; // smallest chunk worth a thread of its own
+constexpr std::size_t CHUNK_READ_SIZE{1 << 20}; // bytes read at a time by each thread
+
+void splitFrequencyChunks(uint64_t fileSize, unsigned threadCount, std::vector<FrequencyChunk>& chunks);
+void countFrequenciesParallel(InputSource& input, unsigned threadCount, HistogramEngine engine,
+                              std::vector<FrequencyChunk>& chunks, ByteHistogram& histogram, bool splitBlocks = false,
+                              ContextHistogram* contextHistogram = nullptr); // not counted if nullptr
+void generateHuffmanCodeParallel(InputSource& input, unsigned threadCount, std::vector<FrequencyChunk>& chunks,
+                                 const EncodingTable& encodingTable, PackedBits& encoding, uint64_t blockIndexSize,
+                                 BlockIndex& blockIndex, uint32_t& checksum);
+void generateHuffmanCodeParallel(InputSource& input, unsigned threadCount, const ContextModel& contextModel,
+                                 PackedBits& encoding, uint64_t blockIndexSize, BlockIndex& blockIndex,
+                                 uint32_t& checksum);
+void generateHuffmanCodeParallel(InputSource& input, unsigned threadCount, const BlockSplitter& blockSplitter,
+                                 PackedBits& encoding, uint64_t blockIndexSize, BlockIndex& blockIndex,
+                                 uint32_t& checksum);
+void generateInterleavedHuffmanCodeParallel(InputSource& input, unsigned threadCount,
+                                            const EncodingTable& encodingTable, unsigned streamCount,
+                                            PackedBits& encoding, uint64_t blockIndexSize, BlockIndex& blockIndex,
+                                            uint32_t& checksum);
+// return false on any error
+bool decodeParallel(const std::string& destination, unsigned threadCount, const DecodingTable& decodingTable,
+                    const BitSpan& encoding, const BlockIndex& blockIndex, uint32_t& checksum);
+bool decodeParallel(const std::string& destination, unsigned threadCount, const InterleavedStreams& interleavedStreams,
+                    const BitSpan& encoding, const BlockIndex& blockIndex, uint32_t& checksum);
+bool decodeParallel(const std::string& destination, unsigned threadCount, const ContextModel& contextModel,
+                    const BitSpan& encoding, const BlockIndex& blockIndex, uint32_t& checksum);
+bool decodeParallel(const std::string& destination, unsigned threadCount, const BlockSplitter& blockSplitter,
+                    const BitSpan& encoding, const BlockIndex& blockIndex, uint32_t& checksum);
+
+
+#endif // PARALLEL_UTILS_H